@@ -15,6 +15,7 @@
 #include <globjects/Capability.h>
 #include <globjects/Texture.h>
 #include <globjects/Program.h>
+#include <globjects/ResidencyManager.h>
 #include <globjects/Shader.h>
 #include <globjects/VertexArray.h>
 #include <globjects/VertexAttributeBinding.h>
@@ -156,11 +157,8 @@ public:
             Shader::fromFile(GL_VERTEX_SHADER,   "data/bindless-textures/shader.vert"),
             Shader::fromFile(GL_FRAGMENT_SHADER, "data/bindless-textures/shader.frag"));
 
-        std::array<TextureHandle, std::tuple_size<decltype(m_textures)>::value> handles;
-        for (unsigned i = 0; i < m_textures.size(); ++i)
-            handles[i] = m_textures[i]->makeResident();
-
-        m_program->setUniform("textures", handles);
+        // textures are made resident when a frame references them
+        m_residency = new ResidencyManager(64 << 20);
 
         window.addTimer(0, 0);
     }
@@ -178,11 +176,20 @@ public:
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        std::array<TextureHandle, std::tuple_size<decltype(m_textures)>::value> handles;
+        for (unsigned i = 0; i < m_textures.size(); ++i)
+            handles[i] = m_residency->reference(m_textures[i]);
+
+        m_residency->commit();
+
+        m_program->setUniform("textures", handles);
         m_program->setUniform("projection", m_camera.viewProjection());
 
         m_program->use();
         m_drawable->draw();
         m_program->release();
+
+        m_residency->endFrame();
     }
 
     virtual void keyPressEvent(KeyEvent & event) override
@@ -287,6 +294,7 @@ protected:
     std::array<ref_ptr<Texture>, 4> m_textures;
     ref_ptr<Program> m_program;
     ref_ptr<VertexDrawable> m_drawable;
+    ref_ptr<ResidencyManager> m_residency;
 };
 
 
@@ -0,0 +1,350 @@
+#include <common/CullingStage.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/base/StaticStringSource.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+namespace
+{
+
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+std::vector<vec4> frustumPlanes(const mat4 & viewProjection)
+{
+    // Gribb/Hartmann plane extraction, rows of the (column major) matrix
+    std::array<vec4, 4> rows;
+    for (int i = 0; i < 4; ++i)
+        rows[i] = vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+    std::vector<vec4> planes = {
+        rows[3] + rows[0], rows[3] - rows[0]
+    ,   rows[3] + rows[1], rows[3] - rows[1]
+    ,   rows[3] + rows[2], rows[3] - rows[2] };
+
+    for (vec4 & plane : planes)
+        plane /= length(vec3(plane.x, plane.y, plane.z));
+
+    return planes;
+}
+
+} // namespace
+
+
+const char * CullingStage::s_computeShaderSource = R"(
+#version 430
+
+layout (local_size_x = 64) in;
+
+struct Object
+{
+    vec4 sphere;
+    uint count;
+    uint firstIndex;
+    int baseVertex;
+    uint padding;
+};
+
+struct Command
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Objects { Object objects[]; };
+layout (std430, binding = 1) writeonly buffer Commands { Command commands[]; };
+layout (std430, binding = 2) buffer DrawCount { uint drawCount; };
+
+uniform uint objectCount;
+uniform vec4 frustumPlanes[6];
+uniform bool compact;
+
+uniform bool occlusionCulling;
+uniform sampler2D depthPyramid;
+uniform mat4 previousViewProjection;
+
+bool insideFrustum(vec4 sphere)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        if (dot(frustumPlanes[i].xyz, sphere.xyz) + frustumPlanes[i].w < -sphere.w)
+            return false;
+    }
+    return true;
+}
+
+bool occluded(vec4 sphere)
+{
+    vec3 minimum = vec3( 1e30);
+    vec3 maximum = vec3(-1e30);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 corner = sphere.xyz + sphere.w * vec3(
+            (i & 1) != 0 ? 1.0 : -1.0,
+            (i & 2) != 0 ? 1.0 : -1.0,
+            (i & 4) != 0 ? 1.0 : -1.0);
+
+        vec4 clip = previousViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0)
+            return false; // intersects the near plane
+
+        vec3 ndc = clip.xyz / clip.w;
+        minimum = min(minimum, ndc);
+        maximum = max(maximum, ndc);
+    }
+
+    vec2 uvMin = clamp(minimum.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uvMax = clamp(maximum.xy * 0.5 + 0.5, 0.0, 1.0);
+
+    // pick the level where the bounds cover at most 2x2 texels
+    vec2 extent = (uvMax - uvMin) * vec2(textureSize(depthPyramid, 0));
+    float level = ceil(log2(max(max(extent.x, extent.y), 1.0)));
+
+    float depth = max(
+        max(textureLod(depthPyramid, uvMin, level).r, textureLod(depthPyramid, vec2(uvMax.x, uvMin.y), level).r),
+        max(textureLod(depthPyramid, vec2(uvMin.x, uvMax.y), level).r, textureLod(depthPyramid, uvMax, level).r));
+
+    return minimum.z * 0.5 + 0.5 > depth;
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= objectCount)
+        return;
+
+    Object object = objects[index];
+
+    bool visible = insideFrustum(object.sphere) && !(occlusionCulling && occluded(object.sphere));
+
+    Command command = Command(object.count, 1u, object.firstIndex, object.baseVertex, index);
+
+    if (compact)
+    {
+        if (visible)
+            commands[atomicAdd(drawCount, 1u)] = command;
+    }
+    else
+    {
+        command.instanceCount = visible ? 1u : 0u;
+        commands[index] = command;
+    }
+}
+)";
+
+const char * CullingStage::s_pyramidShaderSource = R"(
+#version 430
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (r32f, binding = 0) uniform writeonly image2D destination;
+
+uniform sampler2D source;
+uniform int sourceLevel;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(destination);
+
+    if (any(greaterThanEqual(texel, size)))
+        return;
+
+    // the last texels also cover the last row and column of odd source sizes
+    ivec2 sourceSize = textureSize(source, sourceLevel);
+    ivec2 last = min(texel * 2 + 1 + ivec2(equal(texel, size - 1)) * (sourceSize & 1), sourceSize - 1);
+
+    float depth = 0.0;
+
+    for (int y = texel.y * 2; y <= last.y; ++y)
+    {
+        for (int x = texel.x * 2; x <= last.x; ++x)
+            depth = max(depth, texelFetch(source, ivec2(x, y), sourceLevel).r);
+    }
+
+    imageStore(destination, texel, vec4(depth));
+}
+)";
+
+CullingStage::CullingStage()
+: m_program(new Program)
+, m_objects(new Buffer)
+, m_commands(new Buffer)
+, m_drawCount(new Buffer)
+, m_pyramidProgram(new Program)
+, m_occlusionCulling(false)
+, m_objectCount(0)
+, m_indirectParameters(hasExtension(GLextension::GL_ARB_indirect_parameters))
+{
+    m_program->attach(new Shader(GL_COMPUTE_SHADER, new StaticStringSource(s_computeShaderSource)));
+    m_pyramidProgram->attach(new Shader(GL_COMPUTE_SHADER, new StaticStringSource(s_pyramidShaderSource)));
+
+    m_program->setUniform("compact", m_indirectParameters);
+    m_program->setUniform("occlusionCulling", false);
+    m_program->setUniform("depthPyramid", 0);
+    m_pyramidProgram->setUniform("source", 0);
+
+    m_drawCount->setData(sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+}
+
+CullingStage::~CullingStage()
+{
+}
+
+void CullingStage::setObjects(const std::vector<Object> & objects)
+{
+    m_objectCount = static_cast<GLsizei>(objects.size());
+
+    m_objects->setData(objects, GL_STATIC_DRAW);
+    m_commands->setData(static_cast<GLsizeiptr>(objects.size() * sizeof(DrawElementsIndirectCommand)), nullptr, GL_DYNAMIC_COPY);
+
+    m_program->setUniform("objectCount", static_cast<GLuint>(m_objectCount));
+}
+
+GLsizei CullingStage::objectCount() const
+{
+    return m_objectCount;
+}
+
+void CullingStage::setOcclusionCulling(const bool enabled)
+{
+    m_occlusionCulling = enabled;
+
+    // a pyramid built before disabling does not match the views culled since
+    if (!enabled)
+        m_depthPyramid = nullptr;
+}
+
+bool CullingStage::occlusionCulling() const
+{
+    return m_occlusionCulling;
+}
+
+void CullingStage::updateDepthPyramid(const Texture * depth, const ivec2 & size)
+{
+    if (!m_occlusionCulling)
+        return;
+
+    const ivec2 pyramidSize = max(size / 2, ivec2(1));
+    const GLint levels = 1 + static_cast<GLint>(std::floor(std::log2(static_cast<float>(std::max(pyramidSize.x, pyramidSize.y)))));
+
+    if (!m_depthPyramid || m_pyramidSize != pyramidSize)
+    {
+        m_depthPyramid = new Texture(GL_TEXTURE_2D);
+        m_depthPyramid->setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        m_depthPyramid->setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        m_depthPyramid->setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        m_depthPyramid->setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        m_depthPyramid->storage2D(levels, GL_R32F, pyramidSize);
+
+        m_pyramidSize = pyramidSize;
+    }
+
+    // the first level is reduced from the depth texture, every other level from the one before
+    depth->bindActive(GL_TEXTURE0);
+
+    ivec2 levelSize = pyramidSize;
+
+    for (GLint level = 0; level < levels; ++level)
+    {
+        if (level > 0)
+        {
+            m_depthPyramid->bindActive(GL_TEXTURE0);
+            levelSize = max(levelSize / 2, ivec2(1));
+        }
+
+        m_depthPyramid->bindImageTexture(0, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        m_pyramidProgram->setUniform("sourceLevel", std::max(level - 1, 0));
+        m_pyramidProgram->dispatchCompute((levelSize.x + 7) / 8, (levelSize.y + 7) / 8, 1);
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    Texture::unbindImageTexture(0);
+}
+
+void CullingStage::cull(const mat4 & viewProjection)
+{
+    if (m_objectCount == 0)
+        return;
+
+    const GLuint zero = 0;
+    m_drawCount->setSubData(0, sizeof(zero), &zero);
+
+    m_objects->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    m_commands->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    m_drawCount->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    m_program->setUniform("frustumPlanes", frustumPlanes(viewProjection));
+    m_program->setUniform("previousViewProjection", m_previousViewProjection);
+
+    m_program->setUniform("occlusionCulling", m_occlusionCulling && m_depthPyramid);
+
+    if (m_occlusionCulling && m_depthPyramid)
+        m_depthPyramid->bindActive(GL_TEXTURE0);
+
+    m_program->dispatchCompute((m_objectCount + 63) / 64, 1, 1);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // the depth pyramid passed for the next frame is based on this view
+    m_previousViewProjection = viewProjection;
+}
+
+void CullingStage::draw(const VertexArray * vao, const GLenum mode, const GLenum type) const
+{
+    if (m_objectCount == 0)
+        return;
+
+    m_commands->bind(GL_DRAW_INDIRECT_BUFFER);
+
+    if (m_indirectParameters)
+    {
+        m_drawCount->bind(GL_PARAMETER_BUFFER_ARB);
+        vao->multiDrawElementsIndirectCount(mode, type, nullptr, 0, m_objectCount, 0);
+    }
+    else
+    {
+        vao->multiDrawElementsIndirect(mode, type, nullptr, m_objectCount, 0);
+    }
+}
+
+Buffer * CullingStage::commands() const
+{
+    return m_commands;
+}
+
+Buffer * CullingStage::drawCount() const
+{
+    return m_drawCount;
+}
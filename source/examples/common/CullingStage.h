@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Program;
+class Texture;
+class VertexArray;
+
+}
+
+
+/** \brief GPU-driven visibility: culls objects in a compute pass and draws the survivors indirectly.
+
+    Every object provides a world space bounding sphere and the range of its
+    mesh within the element array buffer of a shared vertex array. cull()
+    tests all spheres against the view frustum and, with occlusion culling
+    enabled, against the conservative (maximum) depths of a depth pyramid
+    reduced from the previous frame by updateDepthPyramid(). The survivors
+    are compacted into an indirect command buffer and counted in a draw count
+    buffer, so draw() issues one glMultiDrawElementsIndirectCountARB without
+    any CPU readback. Without ARB_indirect_parameters, culled commands get an
+    instance count of zero instead.
+
+    The base instance of each command is the index of its object, so per-object
+    data can be fetched with an instanced vertex attribute.
+*/
+class CullingStage : public globjects::Referenced
+{
+public:
+    /** Per-object input, std430 layout.
+    */
+    struct Object
+    {
+        glm::vec4 sphere; ///< center (xyz) and radius (w) in world space
+        gl::GLuint count;
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+        gl::GLuint padding;
+    };
+
+public:
+    CullingStage();
+
+    void setObjects(const std::vector<Object> & objects);
+    gl::GLsizei objectCount() const;
+
+    /** Enables occlusion culling, which takes effect once updateDepthPyramid() was called.
+    */
+    void setOcclusionCulling(bool enabled);
+    bool occlusionCulling() const;
+
+    /** Reduces the depth texture of the frame drawn after the last cull() into
+        the depth pyramid (maximum depth per 2x2 texels and mip level) the next
+        cull() tests against. The depth texture must not be attached to the
+        bound draw framebuffer.
+    */
+    void updateDepthPyramid(const globjects::Texture * depth, const glm::ivec2 & size);
+
+    void cull(const glm::mat4 & viewProjection);
+    void draw(const globjects::VertexArray * vao, gl::GLenum mode, gl::GLenum type) const;
+
+    globjects::Buffer * commands() const;
+    globjects::Buffer * drawCount() const;
+
+protected:
+    virtual ~CullingStage();
+
+protected:
+    globjects::ref_ptr<globjects::Program> m_program;
+
+    globjects::ref_ptr<globjects::Buffer> m_objects;
+    globjects::ref_ptr<globjects::Buffer> m_commands;
+    globjects::ref_ptr<globjects::Buffer> m_drawCount;
+
+    globjects::ref_ptr<globjects::Program> m_pyramidProgram;
+    globjects::ref_ptr<globjects::Texture> m_depthPyramid;
+    glm::ivec2 m_pyramidSize;
+    glm::mat4 m_previousViewProjection;
+    bool m_occlusionCulling;
+
+    gl::GLsizei m_objectCount;
+    bool m_indirectParameters;
+
+protected:
+    static const char * s_computeShaderSource;
+    static const char * s_pyramidShaderSource;
+};
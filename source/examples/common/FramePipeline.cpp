@@ -0,0 +1,167 @@
+#include <common/FramePipeline.h>
+
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+
+using namespace gl;
+using namespace globjects;
+
+namespace
+{
+
+const GLuint64 c_waitTimeout = 1000000; // 1 ms, in nanoseconds
+
+} // namespace
+
+
+FramePipeline::FramePipeline(const unsigned int framesInFlight)
+: m_slots(framesInFlight)
+, m_frameNumber(0)
+, m_inFrame(false)
+, m_stallCount(0)
+{
+    assert(framesInFlight > 0);
+}
+
+FramePipeline::~FramePipeline()
+{
+}
+
+void FramePipeline::beginFrame()
+{
+    if (m_inFrame)
+        return;
+
+    m_inFrame = true;
+
+    // the slot to be reused holds the oldest frame in flight
+    Slot & current = m_slots[slot()];
+
+    if (!complete(current, false))
+    {
+        ++m_stallCount;
+        complete(current, true);
+    }
+
+    // frames complete in order, so newer ones are delivered early until the first pending
+    for (unsigned int i = 1; i < framesInFlight(); ++i)
+    {
+        if (!complete(m_slots[(m_frameNumber + i) % m_slots.size()], false))
+            break;
+    }
+}
+
+void FramePipeline::endFrame()
+{
+    if (!m_inFrame)
+        return;
+
+    m_slots[slot()].fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+    m_inFrame = false;
+    ++m_frameNumber;
+}
+
+void FramePipeline::finish()
+{
+    for (unsigned int i = 0; i < framesInFlight(); ++i)
+        complete(m_slots[(m_frameNumber + i) % m_slots.size()], true);
+}
+
+unsigned int FramePipeline::framesInFlight() const
+{
+    return static_cast<unsigned int>(m_slots.size());
+}
+
+unsigned int FramePipeline::slot() const
+{
+    return static_cast<unsigned int>(m_frameNumber % m_slots.size());
+}
+
+unsigned long long FramePipeline::frameNumber() const
+{
+    return m_frameNumber;
+}
+
+std::size_t FramePipeline::stallCount() const
+{
+    return m_stallCount;
+}
+
+Buffer * FramePipeline::transientBuffer(const std::string & name, const GLsizeiptr size, const GLenum usage)
+{
+    assert(m_inFrame);
+
+    TransientBuffer & transient = m_slots[slot()].buffers[name];
+
+    if (!transient.buffer)
+    {
+        transient.buffer = new Buffer;
+        transient.capacity = 0;
+    }
+
+    // the slot is not in flight, so the storage can be reallocated without waiting
+    if (transient.capacity < size)
+    {
+        transient.buffer->setData(size, nullptr, usage);
+        transient.capacity = size;
+    }
+
+    return transient.buffer;
+}
+
+void FramePipeline::readback(const std::string & name, const GLsizeiptr size, const RecordCallback & record, const ReadbackCallback & callback)
+{
+    Buffer * buffer = transientBuffer(name, size, GL_STREAM_READ);
+
+    buffer->bind(GL_PIXEL_PACK_BUFFER);
+    record(buffer);
+    Buffer::unbind(GL_PIXEL_PACK_BUFFER);
+
+    m_slots[slot()].readbacks.push_back({ buffer, size, callback });
+}
+
+bool FramePipeline::complete(Slot & slot, const bool wait)
+{
+    if (!slot.fence)
+        return true;
+
+    GLenum result = slot.fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        if (!wait)
+            return false;
+
+        do
+        {
+            result = slot.fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, c_waitTimeout);
+        }
+        while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    slot.fence = nullptr;
+
+    for (const Readback & readback : slot.readbacks)
+    {
+        const void * data = readback.buffer->mapRange(0, readback.size, GL_MAP_READ_BIT);
+
+        if (!data)
+            continue;
+
+        if (readback.callback)
+            readback.callback(data, readback.size);
+
+        readback.buffer->unmap();
+    }
+
+    slot.readbacks.clear();
+
+    return true;
+}
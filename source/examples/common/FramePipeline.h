@@ -0,0 +1,126 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Sync;
+
+}
+
+
+/** \brief Keeps a fixed number of frames in flight and hands out per-frame resources.
+
+    Every frame is assigned one of framesInFlight() slots round-robin and
+    fenced with a Sync in endFrame(). beginFrame() only blocks when the slot
+    to be reused is still read by the GPU, i.e., when the CPU got more than
+    framesInFlight() frames ahead. Resources obtained from a slot can then be
+    rewritten without synchronization:
+    - transientBuffer() returns a buffer owned by the current slot, grown on
+      demand, e.g., for per-frame uniforms or vertices,
+    - readback() records a transfer into a pack buffer of the slot and passes
+      the results to a callback once the frame completed, without stalling.
+
+    Window drives a pipeline around every paint event (see Window::framePipeline()).
+
+    \code{.cpp}
+        Buffer * uniforms = pipeline->transientBuffer("uniforms", sizeof(Uniforms));
+        uniforms->setSubData(0, sizeof(Uniforms), &values);
+
+        pipeline->readback("picking", 4, [this](Buffer *)
+        {
+            m_fbo->readPixels(GL_COLOR_ATTACHMENT1, {{ x, y, 1, 1 }}, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        },
+        [this](const void * data, GLsizeiptr)
+        {
+            m_picked = *reinterpret_cast<const GLuint *>(data);
+        });
+    \endcode
+*/
+class FramePipeline : public globjects::Referenced
+{
+public:
+    using RecordCallback = std::function<void(globjects::Buffer * pbo)>;
+    using ReadbackCallback = std::function<void(const void * data, gl::GLsizeiptr size)>;
+
+public:
+    FramePipeline(unsigned int framesInFlight = 2);
+
+    /** Waits until the slot of the new frame is no longer in use and delivers its readbacks.
+    */
+    void beginFrame();
+
+    /** Fences the commands of the current frame; call after all its commands were issued.
+    */
+    void endFrame();
+
+    /** Waits for all frames in flight and delivers their readbacks.
+    */
+    void finish();
+
+    unsigned int framesInFlight() const;
+    unsigned int slot() const;
+    unsigned long long frameNumber() const;
+
+    /** Number of beginFrame() calls that had to wait for the GPU.
+    */
+    std::size_t stallCount() const;
+
+    /** The current slot's buffer of the given name, with at least size bytes.
+        Its contents are undefined at the begin of each frame. Names are
+        shared with readback().
+    */
+    globjects::Buffer * transientBuffer(const std::string & name, gl::GLsizeiptr size, gl::GLenum usage = gl::GL_STREAM_DRAW);
+
+    /** Binds a pack buffer of at least size bytes of the current slot to
+        GL_PIXEL_PACK_BUFFER and calls record, which issues the transfer
+        (e.g., readPixels() or getImage() with a nullptr destination). callback
+        is called with the mapped results once the frame completed.
+    */
+    void readback(const std::string & name, gl::GLsizeiptr size, const RecordCallback & record, const ReadbackCallback & callback);
+
+protected:
+    virtual ~FramePipeline();
+
+    struct TransientBuffer
+    {
+        globjects::ref_ptr<globjects::Buffer> buffer;
+        gl::GLsizeiptr capacity;
+    };
+
+    struct Readback
+    {
+        globjects::Buffer * buffer;
+        gl::GLsizeiptr size;
+        ReadbackCallback callback;
+    };
+
+    struct Slot
+    {
+        globjects::ref_ptr<globjects::Sync> fence;
+        std::map<std::string, TransientBuffer> buffers;
+        std::vector<Readback> readbacks;
+    };
+
+    // waits for the fence of a slot if wait is set, returns false if it is still pending
+    bool complete(Slot & slot, bool wait);
+
+protected:
+    std::vector<Slot> m_slots;
+
+    unsigned long long m_frameNumber;
+    bool m_inFrame;
+
+    std::size_t m_stallCount;
+};
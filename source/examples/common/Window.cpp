@@ -13,6 +13,7 @@
 
 #include <common/Context.h>
 #include <common/ContextFormat.h>
+#include <common/FramePipeline.h>
 #include <common/WindowEventHandler.h>
 #include <common/events.h>
 
@@ -40,6 +41,7 @@ Window::Window()
 ,   m_activeEventQueue  (&m_eventQueue[0])
 ,   m_inactiveEventQueue(&m_eventQueue[1])
 ,   m_quitOnDestroy(true)
+,   m_framesInFlight(2)
 ,   m_mode(Mode::Windowed)
 {
     s_instances.insert(this);
@@ -221,11 +223,21 @@ void Window::initializeEventHandler()
 
 void Window::finalizeEventHandler()
 {
-    if (!m_eventHandler)
+    if (!m_eventHandler && !m_framePipeline)
         return;
 
     m_context->makeCurrent();
-    m_eventHandler->finalize(*this);
+
+    if (m_eventHandler)
+        m_eventHandler->finalize(*this);
+
+    // the fences and buffers of the pipeline belong to the context, frames in flight may still use them
+    if (m_framePipeline)
+    {
+        m_framePipeline->finish();
+        m_framePipeline = nullptr;
+    }
+
     m_context->doneCurrent();
 }
 
@@ -352,6 +364,21 @@ void Window::toggleVSync()
     }
 }
 
+void Window::setFramesInFlight(const unsigned int count)
+{
+    m_framesInFlight = count;
+}
+
+unsigned int Window::framesInFlight() const
+{
+    return m_framesInFlight;
+}
+
+FramePipeline * Window::framePipeline() const
+{
+    return m_framePipeline;
+}
+
 void Window::setEventHandler(WindowEventHandler * eventHandler)
 {
     if (eventHandler == m_eventHandler)
@@ -504,18 +531,40 @@ void Window::processEvents()
 
 void Window::processEvent(WindowEvent & event)
 {
+    if (event.type() == WindowEvent::Type::Paint)
+        beginFrame();
+
     if (m_eventHandler)
         m_eventHandler->handleEvent(event);
 
     postprocessEvent(event);
 }
 
+void Window::beginFrame()
+{
+    if (m_framePipeline && m_framePipeline->framesInFlight() != m_framesInFlight)
+    {
+        m_framePipeline->finish();
+        m_framePipeline = nullptr;
+    }
+
+    if (!m_framePipeline && m_framesInFlight > 0)
+        m_framePipeline = new FramePipeline(m_framesInFlight);
+
+    // blocks only if the GPU is more than framesInFlight() frames behind
+    if (m_framePipeline)
+        m_framePipeline->beginFrame();
+}
+
 void Window::postprocessEvent(WindowEvent & event)
 {
     switch (event.type())
     {
     case WindowEvent::Type::Paint:
         swap();
+
+        if (m_framePipeline)
+            m_framePipeline->endFrame();
         break;
 
     case WindowEvent::Type::Close:
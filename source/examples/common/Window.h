@@ -18,6 +18,7 @@ class WindowEventHandler;
 class WindowEvent;
 class ContextFormat;
 class Context;
+class FramePipeline;
 
 
 /** Attach a WindowEventHandler specialization for event handling.
@@ -94,6 +95,17 @@ public:
     void toggleMode();
     void toggleVSync();
 
+    /** Number of frames the CPU may render ahead of the GPU, 0 disables the
+        frame pipeline. Takes effect with the next paint event.
+    */
+    void setFramesInFlight(unsigned int count);
+    unsigned int framesInFlight() const;
+
+    /** The pipeline fencing the paint events of this window, created with the
+        first paint event; use it from within paint events only.
+    */
+    FramePipeline * framePipeline() const;
+
     void queueEvent(WindowEvent * event);
 
     bool hasPendingEvents();
@@ -117,6 +129,7 @@ protected:
 
     void clearEventQueue();
     void processEvent(WindowEvent & event);
+    void beginFrame();
     void postprocessEvent(WindowEvent & event);
 
     enum class Mode
@@ -145,6 +158,9 @@ protected:
 
     bool m_quitOnDestroy;
 
+    unsigned int m_framesInFlight;
+    globjects::ref_ptr<FramePipeline> m_framePipeline;
+
     Mode m_mode;
 
 private:
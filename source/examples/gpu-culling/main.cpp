@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/gl/extension.h>
+
+#include <glm/glm.hpp>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/Program.h>
+#include <globjects/Query.h>
+#include <globjects/Shader.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+#include <globjects/base/StaticStringSource.h>
+
+#include <common/Camera.h>
+#include <common/CullingStage.h>
+#include <common/Icosahedron.h>
+#include <common/Timer.h>
+#include <common/ContextFormat.h>
+#include <common/Context.h>
+#include <common/Window.h>
+#include <common/WindowEventHandler.h>
+#include <common/events.h>
+
+
+using namespace gl;
+using namespace glm;
+using namespace globjects;
+
+namespace
+{
+
+const char * vertexShaderSource = R"(
+#version 430
+
+layout (location = 0) in vec3 a_vertex;
+layout (location = 2) in vec4 a_instance; // position (xyz) and scale (w)
+
+uniform mat4 viewProjection;
+
+out vec3 v_normal;
+
+void main()
+{
+    v_normal = a_vertex;
+    gl_Position = viewProjection * vec4(a_instance.xyz + a_vertex * a_instance.w, 1.0);
+}
+)";
+
+const char * fragmentShaderSource = R"(
+#version 430
+
+in vec3 v_normal;
+
+layout (location = 0) out vec4 fragColor;
+
+void main()
+{
+    fragColor = vec4(normalize(v_normal) * 0.5 + 0.5, 1.0);
+}
+)";
+
+// timer queries are read this many frames after they were issued, so reading does not stall the pipeline
+const int queryLatency = 3;
+
+} // namespace
+
+
+class EventHandler : public WindowEventHandler
+{
+public:
+    EventHandler(const int objectCount)
+    : m_objectCount(objectCount)
+    , m_cullingEnabled(true)
+    , m_queryIndex(0)
+    , m_frames(0)
+    , m_gpuTime(0)
+    {
+        m_timer.setAutoUpdating(false);
+        m_timer.start();
+
+        m_queryIssued.fill(false);
+    }
+
+    virtual ~EventHandler()
+    {
+    }
+
+    virtual void initialize(Window & window) override
+    {
+        WindowEventHandler::initialize(window);
+
+        if (!hasExtension(GLextension::GL_ARB_compute_shader) || !hasExtension(GLextension::GL_ARB_multi_draw_indirect))
+        {
+            critical() << "Compute shaders or multi draw indirect not supported.";
+
+            window.close();
+            return;
+        }
+
+        if (!hasExtension(GLextension::GL_ARB_indirect_parameters))
+            warning() << "ARB_indirect_parameters not supported, culled draws are issued with zero instances.";
+
+        glClearColor(0.2f, 0.3f, 0.4f, 1.f);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_CULL_FACE);
+
+        // one shared mesh, every object references its index range
+
+        const auto baseVertices = Icosahedron::vertices();
+        const auto baseFaces = Icosahedron::indices();
+
+        std::vector<vec3> vertices(baseVertices.begin(), baseVertices.end());
+        std::vector<Icosahedron::Face> faces(baseFaces.begin(), baseFaces.end());
+
+        Icosahedron::refine(vertices, faces, 1);
+
+        m_indexCount = static_cast<GLsizei>(faces.size() * 3);
+
+        m_vertices = new Buffer;
+        m_vertices->setData(vertices, GL_STATIC_DRAW);
+
+        m_indices = new Buffer;
+        m_indices->setData(faces, GL_STATIC_DRAW);
+
+        // random field of spheres
+
+        std::mt19937 generator;
+        std::uniform_real_distribution<float> position(-100.f, 100.f);
+        std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+
+        std::vector<vec4> instances(m_objectCount);
+        std::vector<CullingStage::Object> objects(m_objectCount);
+
+        for (int i = 0; i < m_objectCount; ++i)
+        {
+            instances[i] = vec4(position(generator), position(generator), position(generator), scale(generator));
+
+            objects[i].sphere = instances[i];
+            objects[i].count = static_cast<GLuint>(m_indexCount);
+            objects[i].firstIndex = 0;
+            objects[i].baseVertex = 0;
+            objects[i].padding = 0;
+        }
+
+        m_instances = new Buffer;
+        m_instances->setData(instances, GL_STATIC_DRAW);
+
+        m_vao = new VertexArray;
+        m_vao->bind();
+
+        m_indices->bind(GL_ELEMENT_ARRAY_BUFFER);
+
+        auto vertexBinding = m_vao->binding(0);
+        vertexBinding->setAttribute(0);
+        vertexBinding->setBuffer(m_vertices, 0, sizeof(vec3));
+        vertexBinding->setFormat(3, GL_FLOAT, GL_FALSE);
+        m_vao->enable(0);
+
+        auto instanceBinding = m_vao->binding(1);
+        instanceBinding->setAttribute(2);
+        instanceBinding->setBuffer(m_instances, 0, sizeof(vec4));
+        instanceBinding->setFormat(4, GL_FLOAT, GL_FALSE);
+        instanceBinding->setDivisor(1);
+        m_vao->enable(2);
+
+        m_vao->unbind();
+
+        m_program = new Program;
+        m_program->attach(
+            new Shader(GL_VERTEX_SHADER, new StaticStringSource(vertexShaderSource))
+        ,   new Shader(GL_FRAGMENT_SHADER, new StaticStringSource(fragmentShaderSource)));
+
+        m_culling = new CullingStage;
+        m_culling->setObjects(objects);
+
+        // the scene is drawn into textures, so its depth can be reduced into the culling stage's depth pyramid
+        m_color = Texture::createDefault(GL_TEXTURE_2D);
+        m_depth = Texture::createDefault(GL_TEXTURE_2D);
+        m_depth->setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        m_depth->setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        m_fbo = new Framebuffer;
+        m_fbo->attachTexture(GL_COLOR_ATTACHMENT0, m_color);
+        m_fbo->attachTexture(GL_DEPTH_ATTACHMENT, m_depth);
+        m_fbo->setDrawBuffer(GL_COLOR_ATTACHMENT0);
+
+        m_camera.setZNear(0.1f);
+        m_camera.setZFar(400.f);
+
+        for (ref_ptr<Query> & query : m_queries)
+            query = new Query;
+
+        info() << m_objectCount << " objects with " << m_indexCount / 3 << " triangles each";
+    }
+
+    virtual void framebufferResizeEvent(ResizeEvent & event) override
+    {
+        glViewport(0, 0, event.width(), event.height());
+
+        m_camera.setViewport(event.size());
+
+        m_size = event.size();
+
+        m_color->image2D(0, GL_RGBA8, m_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_depth->image2D(0, GL_DEPTH_COMPONENT32F, m_size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    }
+
+    virtual void paintEvent(PaintEvent & event) override
+    {
+        WindowEventHandler::paintEvent(event);
+
+        m_timer.update();
+        const float t = static_cast<float>(m_timer.elapsed().count()) * 1.0e-9f * 0.1f;
+
+        m_camera.setEye(vec3(0.f));
+        m_camera.setCenter(vec3(cos(t), 0.2f * sin(3.f * t), sin(t)));
+
+        // the query issued queryLatency frames ago is reused, its result is usually available by now
+        Query * query = m_queries[m_queryIndex];
+        const bool measured = m_queryIssued[m_queryIndex];
+
+        if (measured)
+            m_gpuTime += query->get64(GL_QUERY_RESULT);
+
+        m_fbo->bind();
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        query->begin(GL_TIME_ELAPSED);
+
+        m_program->use();
+        m_program->setUniform("viewProjection", m_camera.viewProjection());
+
+        if (m_cullingEnabled)
+        {
+            m_culling->cull(m_camera.viewProjection());
+
+            m_program->use();
+            m_culling->draw(m_vao, GL_TRIANGLES, GL_UNSIGNED_SHORT);
+        }
+        else
+        {
+            m_vao->drawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_SHORT, nullptr, m_objectCount);
+        }
+
+        m_program->release();
+
+        m_fbo->unbind();
+
+        // the pyramid is built from the depths of this frame, to cull the next one
+        if (m_cullingEnabled)
+            m_culling->updateDepthPyramid(m_depth, m_size);
+
+        query->end(GL_TIME_ELAPSED);
+
+        m_queryIssued[m_queryIndex] = true;
+        m_queryIndex = (m_queryIndex + 1) % queryLatency;
+
+        m_fbo->blit(GL_COLOR_ATTACHMENT0, {{ 0, 0, m_size.x, m_size.y }}, Framebuffer::defaultFBO(), GL_BACK, {{ 0, 0, m_size.x, m_size.y }}, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        if (measured && ++m_frames == 100)
+        {
+            info() << mode() << (m_gpuTime / m_frames) * 1.0e-6 << " ms GPU time per frame";
+
+            resetMeasurement();
+        }
+    }
+
+    const char * mode() const
+    {
+        if (!m_cullingEnabled)
+            return "no culling:             ";
+
+        return m_culling->occlusionCulling() ? "frustum and occlusion:  " : "frustum culling:        ";
+    }
+
+    void resetMeasurement()
+    {
+        // results of queries still in flight belong to the previous mode
+        m_queryIssued.fill(false);
+
+        m_frames = 0;
+        m_gpuTime = 0;
+    }
+
+    virtual void keyPressEvent(KeyEvent & event) override
+    {
+        WindowEventHandler::keyPressEvent(event);
+
+        switch (event.key())
+        {
+        case GLFW_KEY_C:
+            m_cullingEnabled = !m_cullingEnabled;
+            info() << "GPU culling " << (m_cullingEnabled ? "enabled" : "disabled");
+
+            resetMeasurement();
+            break;
+
+        case GLFW_KEY_O:
+            m_culling->setOcclusionCulling(!m_culling->occlusionCulling());
+            info() << "Occlusion culling " << (m_culling->occlusionCulling() ? "enabled" : "disabled");
+
+            resetMeasurement();
+            break;
+        }
+    }
+
+protected:
+    int m_objectCount;
+    bool m_cullingEnabled;
+
+    Camera m_camera;
+    Timer m_timer;
+
+    ref_ptr<Buffer> m_vertices;
+    ref_ptr<Buffer> m_indices;
+    ref_ptr<Buffer> m_instances;
+    ref_ptr<VertexArray> m_vao;
+    ref_ptr<Program> m_program;
+
+    ref_ptr<CullingStage> m_culling;
+
+    GLsizei m_indexCount;
+
+    ref_ptr<Texture> m_color;
+    ref_ptr<Texture> m_depth;
+    ref_ptr<Framebuffer> m_fbo;
+    ivec2 m_size;
+
+    std::array<ref_ptr<Query>, queryLatency> m_queries;
+    std::array<bool, queryLatency> m_queryIssued;
+    int m_queryIndex;
+    unsigned int m_frames;
+    GLuint64 m_gpuTime;
+};
+
+
+int main(int argc, char * argv[])
+{
+    info() << "Usage:";
+    info() << "\t" << "ESC" << "\t\t"       << "Close example";
+    info() << "\t" << "ALT + Enter" << "\t" << "Toggle fullscreen";
+    info() << "\t" << "F11" << "\t\t"       << "Toggle fullscreen";
+    info() << "\t" << "F10" << "\t\t"       << "Toggle vertical sync";
+    info() << "\t" << "C" << "\t\t"         << "Toggle GPU culling";
+    info() << "\t" << "O" << "\t\t"         << "Toggle occlusion culling against the previous frame's depth";
+    info() << "Arguments:";
+    info() << "\t" << "[object count]" << "\t" << "Number of objects (default 100000)";
+
+    const int objectCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+    ContextFormat format;
+    format.setVersion(4, 3);
+    format.setProfile(ContextFormat::Profile::Core);
+
+    Window::init();
+
+    Window window;
+    window.setEventHandler(new EventHandler(objectCount));
+
+    if (!window.create(format, "GPU Culling Example"))
+        return 1;
+
+    window.show();
+
+    return MainLoop::run();
+}
@@ -237,6 +237,22 @@ public:
 
     void getSubData(gl::GLintptr offset, gl::GLsizeiptr size, void * data) const;
 
+    /** \brief Uploads data in consecutive glBufferSubData calls of at most chunkSize bytes.
+        Bounds the staging memory the driver allocates for very large transfers.
+    */
+    void setSubDataChunked(gl::GLintptr offset, gl::GLsizeiptr size, const gl::GLvoid * data, gl::GLsizeiptr chunkSize = DefaultChunkSize);
+
+    /** \brief Reads data back in consecutive glGetBufferSubData calls of at most chunkSize bytes.
+    */
+    void getSubDataChunked(gl::GLintptr offset, gl::GLsizeiptr size, void * data, gl::GLsizeiptr chunkSize = DefaultChunkSize) const;
+
+    /** \brief Calls function(chunkOffset, chunkSize) for consecutive chunks of at most chunkSize bytes covering [offset, offset + size).
+    */
+    template <typename Function>
+    static void forEachChunk(gl::GLintptr offset, gl::GLsizeiptr size, gl::GLsizeiptr chunkSize, Function function);
+
+    static const gl::GLsizeiptr DefaultChunkSize;
+
     template <typename T>
     const std::vector<T> getSubData(gl::GLsizeiptr size, gl::GLintptr offset = 0) const;
     
@@ -2,6 +2,9 @@
 
 #include <globjects/Buffer.h>
 
+#include <algorithm>
+#include <cassert>
+
 namespace globjects {
 
 template <typename T>
@@ -19,25 +22,25 @@ void Buffer::setData(const std::array<T, Count> & data, gl::GLenum usage)
 template <typename T>
 void Buffer::setSubData(const std::vector<T> & data, gl::GLintptr offset)
 {
-    setSubData(offset, static_cast<gl::GLsizei>(data.size() * sizeof(T)), data.data());
+    setSubData(offset, static_cast<gl::GLsizeiptr>(data.size() * sizeof(T)), data.data());
 }
 
 template <typename T, std::size_t Count>
 void Buffer::setSubData(const std::array<T, Count> & data, gl::GLintptr offset)
 {
-    setSubData(offset, static_cast<gl::GLsizei>(Count * sizeof(T)), data.data());
+    setSubData(offset, static_cast<gl::GLsizeiptr>(Count * sizeof(T)), data.data());
 }
 
 template <typename T>
 void Buffer::setStorage(const std::vector<T> & data, gl::MapBufferUsageMask flags)
 {
-    setStorage(static_cast<gl::GLsizei>(data.size() * sizeof(T)), data.data(), flags);
+    setStorage(static_cast<gl::GLsizeiptr>(data.size() * sizeof(T)), data.data(), flags);
 }
 
 template <typename T, std::size_t Count>
 void Buffer::setStorage(const std::array<T, Count> & data, gl::MapBufferUsageMask flags)
 {
-    setStorage(static_cast<gl::GLsizei>(Count * sizeof(T)), data.data(), flags);
+    setStorage(static_cast<gl::GLsizeiptr>(Count * sizeof(T)), data.data(), flags);
 }
 
 template <typename T>
@@ -45,7 +48,7 @@ const std::vector<T> Buffer::getSubData(gl::GLsizeiptr size, gl::GLintptr offset
 {
     std::vector<T> data(size);
 
-    getSubData(offset, size, data.data());
+    getSubData(offset, static_cast<gl::GLsizeiptr>(size * sizeof(T)), data.data());
 
     return data;
 }
@@ -55,9 +58,18 @@ const std::array<T, Count> Buffer::getSubData(gl::GLintptr offset) const
 {
     std::array<T, Count> data;
 
-    getSubData(offset, Count, data.data());
+    getSubData(offset, static_cast<gl::GLsizeiptr>(Count * sizeof(T)), data.data());
 
     return data;
 }
 
+template <typename Function>
+void Buffer::forEachChunk(const gl::GLintptr offset, const gl::GLsizeiptr size, const gl::GLsizeiptr chunkSize, Function function)
+{
+    assert(chunkSize > 0);
+
+    for (gl::GLsizeiptr done = 0; done < size; done += chunkSize)
+        function(offset + done, std::min(chunkSize, size - done));
+}
+
 } // namespace globjects
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/BufferRange.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+
+
+/** \brief Sub-allocates many small logical buffers from a few large buffers (pages).
+
+    Each allocation is identified by a handle and resolves to a BufferRange,
+    which can be used for vertex attribute bindings, indexed binding points
+    and uploads. Small meshes and uniform blocks thereby share OpenGL buffer
+    objects, which reduces object count and allows vertex arrays to share
+    a buffer.
+
+    Free space is tracked per page in offset order (for coalescing) and in
+    size order (for best fit lookups), so allocation and release are
+    logarithmic in the number of free blocks. Allocations larger than the
+    page size get a dedicated page.
+
+    defragment() packs all live allocations into as few pages as possible
+    using copySubData and releases the previous pages. As this moves data,
+    ranges have to be resolved again for all handles it returns.
+
+    \code{.cpp}
+        ref_ptr<BufferAllocator> allocator = new BufferAllocator(64 << 20);
+
+        BufferAllocator::Handle mesh = allocator->allocate(vertexDataSize, sizeof(glm::vec3));
+        allocator->range(mesh).setSubData(0, vertexDataSize, vertices.data());
+        vao->binding(0)->setBuffer(allocator->range(mesh), sizeof(glm::vec3));
+
+        BufferAllocator::Handle block = allocator->allocate(sizeof(Transforms), BufferAllocator::uniformBufferAlignment());
+        allocator->range(block).bindRange(gl::GL_UNIFORM_BUFFER, 0);
+    \endcode
+
+    \see BufferRange
+*/
+class GLOBJECTS_API BufferAllocator : public Referenced
+{
+public:
+    using Handle = unsigned int;
+    static const Handle InvalidHandle;
+
+public:
+    BufferAllocator(gl::GLsizeiptr pageSize, gl::GLenum usage = gl::GL_STATIC_DRAW);
+
+    Handle allocate(gl::GLsizeiptr size, gl::GLsizeiptr alignment = 4);
+    void free(Handle handle);
+
+    BufferRange range(Handle handle) const;
+
+    /** Compacts all allocations and returns the handles whose ranges changed.
+    */
+    std::vector<Handle> defragment();
+
+    gl::GLsizeiptr pageSize() const;
+    std::size_t pageCount() const;
+    std::size_t allocationCount() const;
+
+    /** Bytes used by live allocations, excluding alignment padding.
+    */
+    gl::GLsizeiptr allocatedSize() const;
+
+    /** Bytes of all pages.
+    */
+    gl::GLsizeiptr reservedSize() const;
+
+    static gl::GLsizeiptr uniformBufferAlignment();
+    static gl::GLsizeiptr shaderStorageBufferAlignment();
+
+protected:
+    virtual ~BufferAllocator();
+
+    struct Page
+    {
+        ref_ptr<Buffer> buffer;
+        gl::GLsizeiptr size;
+        std::size_t allocationCount;
+
+        std::map<gl::GLintptr, gl::GLsizeiptr> freeByOffset;
+        std::multimap<gl::GLsizeiptr, gl::GLintptr> freeBySize;
+    };
+
+    struct Allocation
+    {
+        std::size_t page;
+        gl::GLintptr offset;
+        gl::GLsizeiptr size;
+        gl::GLsizeiptr alignment;
+        bool live;
+    };
+
+    std::size_t addPage(gl::GLsizeiptr size);
+    bool allocateInPage(std::size_t pageIndex, gl::GLsizeiptr size, gl::GLsizeiptr alignment, Allocation & allocation);
+
+    static void insertFreeBlock(Page & page, gl::GLintptr offset, gl::GLsizeiptr size);
+    static void removeFreeBlock(Page & page, gl::GLintptr offset, gl::GLsizeiptr size);
+
+protected:
+    gl::GLsizeiptr m_pageSize;
+    gl::GLenum m_usage;
+
+    std::vector<Page> m_pages;
+    std::vector<Allocation> m_allocations;
+    std::vector<Handle> m_freeHandles;
+
+    std::size_t m_allocationCount;
+    gl::GLsizeiptr m_allocatedSize;
+};
+
+} // namespace globjects
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+
+
+/** \brief A slice of a buffer, e.g., handed out by a BufferAllocator.
+
+    Offsets passed to the accessors are relative to the slice. The range does
+    not own the buffer.
+
+    \see BufferAllocator
+*/
+struct GLOBJECTS_API BufferRange
+{
+    BufferRange();
+    BufferRange(Buffer * buffer, gl::GLintptr offset, gl::GLsizeiptr size);
+
+    bool isValid() const;
+
+    void setSubData(gl::GLintptr offset, gl::GLsizeiptr size, const gl::GLvoid * data) const;
+    void getSubData(gl::GLintptr offset, gl::GLsizeiptr size, void * data) const;
+
+    void bindRange(gl::GLenum target, gl::GLuint index) const;
+
+    /** Copies min(size, other.size) bytes from the start of this range into another range.
+    */
+    void copyTo(const BufferRange & other) const;
+
+    Buffer * buffer;
+    gl::GLintptr offset;
+    gl::GLsizeiptr size;
+};
+
+} // namespace globjects
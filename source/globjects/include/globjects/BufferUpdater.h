@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class StreamingBuffer;
+
+
+/** \brief Updates buffer contents with the cheapest strategy for each buffer's update pattern.
+
+    For every buffer, the updater records how often and how much of it is
+    rewritten and chooses per update between
+    - Orphan: full rewrites of mutable storage are issued with setData(), so
+      the driver can hand out new memory instead of waiting for the GPU,
+    - StreamingWrite: frequent or larger partial updates are written
+      unsynchronized into a fenced StreamingBuffer ring and copied into the
+      buffer on the GPU,
+    - SubData: rare small patches use setSubData(), which is cheapest when
+      the buffer is not in flight.
+
+    The choices are counted in stats(), so the effect of content changes can
+    be observed without tuning usage hints per buffer. endFrame() has to be
+    called once per frame after the commands reading the updated buffers are
+    issued.
+
+    \code{.cpp}
+        ref_ptr<BufferUpdater> updater = new BufferUpdater;
+
+        updater->update(transforms, 0, sizeof(glm::mat4) * count, matrices.data());
+        updater->update(materials, index * sizeof(Material), sizeof(Material), &material);
+
+        // draw ...
+
+        updater->endFrame();
+    \endcode
+
+    Requires OpenGL 4.4 or ARB_buffer_storage for the staging ring.
+
+    \see StreamingBuffer
+*/
+class GLOBJECTS_API BufferUpdater : public Referenced
+{
+public:
+    enum class Strategy
+    {
+        SubData
+    ,   Orphan
+    ,   StreamingWrite
+    };
+
+    /** Update history of a buffer.
+    */
+    struct Pattern
+    {
+        gl::GLsizeiptr bufferSize;
+        gl::GLenum usage;
+        bool orphanable;             // false for immutable storage
+
+        std::size_t updateCount;
+        unsigned long long lastFrame;
+        float interval;              // moving average of frames between updates
+        Strategy strategy;           // last choice
+    };
+
+    struct Stats
+    {
+        std::size_t subDataCount;
+        std::size_t orphanCount;
+        std::size_t streamingWriteCount;
+
+        gl::GLsizeiptr subDataBytes;
+        gl::GLsizeiptr orphanBytes;
+        gl::GLsizeiptr streamingWriteBytes;
+
+        std::size_t trackedBuffers;
+    };
+
+public:
+    /** \param stagingSize capacity of the ring for streaming writes, should hold the updates of all frames in flight
+        \param smallPatchSize updates up to this size are considered small patches
+    */
+    BufferUpdater(gl::GLsizeiptr stagingSize = 16 << 20, gl::GLsizeiptr smallPatchSize = 4096);
+
+    /** Writes size bytes of data at offset into buffer.
+        \return the chosen strategy
+    */
+    Strategy update(Buffer * buffer, gl::GLintptr offset, gl::GLsizeiptr size, const void * data);
+
+    /** Fences the streaming writes of the frame and advances the update history.
+        Buffers only referenced by the updater are no longer tracked.
+    */
+    void endFrame();
+
+    /** Drops the history of a buffer, e.g., after it was reallocated elsewhere.
+    */
+    void forget(Buffer * buffer);
+
+    const Pattern * pattern(Buffer * buffer) const;
+
+    const Stats & stats() const;
+    void resetStats();
+
+    StreamingBuffer * staging() const;
+
+    /** The decision rule, applied to the history including the current update.
+    */
+    static Strategy select(const Pattern & pattern, gl::GLintptr offset, gl::GLsizeiptr size, gl::GLsizeiptr smallPatchSize, gl::GLsizeiptr maxStreamingSize);
+
+    /** Adds an update in frame to the history.
+    */
+    static void record(Pattern & pattern, unsigned long long frame);
+
+protected:
+    virtual ~BufferUpdater();
+
+    struct Tracked
+    {
+        ref_ptr<Buffer> buffer; // keeps the buffer alive while copies may be in flight
+        Pattern pattern;
+    };
+
+    Pattern & track(Buffer * buffer);
+
+protected:
+    ref_ptr<StreamingBuffer> m_staging;
+    gl::GLsizeiptr m_smallPatchSize;
+
+    unsigned long long m_frame;
+    std::map<Buffer *, Tracked> m_tracked;
+
+    Stats m_stats;
+};
+
+} // namespace globjects
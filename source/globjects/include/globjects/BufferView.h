@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+namespace globjects
+{
+
+class Buffer;
+
+
+enum class BufferLayout
+{
+    Std140,
+    Std430
+};
+
+
+/** \brief Describes a GLSL struct or interface block by its member types, for use with BufferView.
+
+    Members can be scalars, glm vectors and matrices, std::arrays of these,
+    and nested BufferStructs.
+*/
+template <typename... Members>
+struct BufferStruct
+{
+};
+
+
+/** \brief Component type and dimensions of a GLSL scalar, vector or matrix type.
+
+    Specialized for the scalar types and the default precision glm types;
+    other types are rejected at compile time.
+*/
+template <typename T>
+struct GlslType;
+
+
+/** \brief Base alignment, size and array stride of a type according to the std140 or std430 rules.
+
+    The rules are those of the OpenGL 4.5 specification, section 7.6.2.2.
+    native is true if the C++ representation of the type has the same layout,
+    so that it can be accessed in place.
+*/
+template <typename T, BufferLayout Layout>
+struct BufferLayoutTraits;
+
+
+/** \brief Offset of a BufferStruct member according to the std140 or std430 rules.
+*/
+template <typename Struct, BufferLayout Layout, std::size_t Index>
+struct BufferMemberOffset;
+
+
+namespace detail
+{
+
+template <typename Struct, std::size_t Index>
+struct BufferStructMember;
+
+} // namespace detail
+
+
+/** \brief Typed access to an array of T laid out according to the std140 or std430 rules.
+
+    The view does not own the memory; it typically works on a mapped buffer
+    range or on a StreamingBuffer allocation, so values are written in place
+    instead of being staged in intermediate vectors. Offsets and strides are
+    computed at compile time, and types whose C++ layout differs from the
+    buffer layout cannot be accessed by reference:
+
+    \code{.cpp}
+        using Light = BufferStruct<glm::vec3, float, glm::vec4>; // position, radius, color
+
+        BufferView<Light, BufferLayout::Std430> lights(buffer, 0, count, gl::GL_MAP_WRITE_BIT);
+
+        lights.member<0>(i) = position;
+        lights.member<1>(i) = radius;
+
+        buffer->unmap();
+
+        BufferView<glm::mat3> normalMatrices(data, 1);
+        normalMatrices[0] = normalMatrix;       // does not compile, mat3 columns are padded in std140
+        normalMatrices.set(0, normalMatrix);    // copies column by column
+    \endcode
+
+    A matching C++ struct can be checked against the layout:
+
+    \code{.cpp}
+        static_assert(BufferMemberOffset<Light, BufferLayout::Std430, 1>::value == offsetof(CpuLight, radius), "layout mismatch");
+    \endcode
+*/
+template <typename T, BufferLayout Layout = BufferLayout::Std140>
+class BufferView
+{
+public:
+    using Traits = BufferLayoutTraits<T, Layout>;
+
+    static const std::size_t stride = Traits::stride;
+
+    template <std::size_t Index>
+    using Member = typename detail::BufferStructMember<T, Index>::type;
+
+public:
+    BufferView();
+    BufferView(void * data, std::size_t count);
+
+    /** Maps count elements starting at offset; the caller unmaps the buffer when done.
+    */
+    BufferView(Buffer * buffer, gl::GLintptr offset, std::size_t count, gl::BufferAccessMask access);
+
+    /** Buffer size required for count elements.
+    */
+    static gl::GLsizeiptr byteSize(std::size_t count);
+
+    void * data() const;
+    std::size_t size() const;
+    bool isValid() const;
+
+    /** In-place access; requires T to have the same layout in C++ and in the buffer.
+    */
+    T & operator[](std::size_t index) const;
+
+    /** Converting access, also for types with padded layouts (e.g., glm::mat3 or float arrays in std140).
+    */
+    void set(std::size_t index, const T & value) const;
+    T get(std::size_t index) const;
+
+    /** In-place access to a member of a BufferStruct element.
+    */
+    template <std::size_t Index>
+    Member<Index> & member(std::size_t index) const;
+
+    template <std::size_t Index>
+    void setMember(std::size_t index, const Member<Index> & value) const;
+
+    template <std::size_t Index>
+    Member<Index> getMember(std::size_t index) const;
+
+protected:
+    char * element(std::size_t index) const;
+
+protected:
+    char * m_data;
+    std::size_t m_count;
+};
+
+} // namespace globjects
+
+#include <globjects/BufferView.hpp>
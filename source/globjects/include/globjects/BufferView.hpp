@@ -0,0 +1,315 @@
+#pragma once
+
+#include <globjects/BufferView.h>
+
+#include <cassert>
+#include <cstring>
+#include <tuple>
+
+#include <globjects/Buffer.h>
+
+namespace globjects
+{
+
+namespace detail
+{
+
+template <std::size_t Value, std::size_t Alignment>
+struct AlignUp
+{
+    static const std::size_t value = (Value + Alignment - 1) / Alignment * Alignment;
+};
+
+template <std::size_t First, std::size_t Second>
+struct Max
+{
+    static const std::size_t value = First > Second ? First : Second;
+};
+
+// array elements and structs are aligned to vec4 in std140
+template <std::size_t Alignment, BufferLayout Layout>
+struct AggregateAlignment
+{
+    static const std::size_t value = Layout == BufferLayout::Std140 ? AlignUp<Alignment, 16>::value : Alignment;
+};
+
+template <typename Component, std::size_t Columns, std::size_t Rows>
+struct GlslTypeDescription
+{
+    using ComponentType = Component;
+
+    static const std::size_t columns = Columns;
+    static const std::size_t rows = Rows;
+};
+
+template <BufferLayout Layout, std::size_t Offset, typename... Members>
+struct StructLayout
+{
+    static const std::size_t end = Offset;
+    static const std::size_t alignment = 1;
+};
+
+template <BufferLayout Layout, std::size_t Offset, typename First, typename... Members>
+struct StructLayout<Layout, Offset, First, Members...>
+{
+    using Traits = BufferLayoutTraits<First, Layout>;
+
+    static const std::size_t offset = AlignUp<Offset, Traits::alignment>::value;
+
+    using Next = StructLayout<Layout, offset + Traits::size, Members...>;
+
+    static const std::size_t end = Next::end;
+    static const std::size_t alignment = Max<Traits::alignment, Next::alignment>::value;
+};
+
+template <typename Layout, std::size_t Index>
+struct StructMemberOffset
+{
+    static const std::size_t value = StructMemberOffset<typename Layout::Next, Index - 1>::value;
+};
+
+template <typename Layout>
+struct StructMemberOffset<Layout, 0>
+{
+    static const std::size_t value = Layout::offset;
+};
+
+template <typename... Members, std::size_t Index>
+struct BufferStructMember<BufferStruct<Members...>, Index>
+{
+    using type = typename std::tuple_element<Index, std::tuple<Members...>>::type;
+};
+
+} // namespace detail
+
+
+template <> struct GlslType<float> : detail::GlslTypeDescription<float, 1, 1> {};
+template <> struct GlslType<double> : detail::GlslTypeDescription<double, 1, 1> {};
+template <> struct GlslType<int> : detail::GlslTypeDescription<int, 1, 1> {};
+template <> struct GlslType<unsigned int> : detail::GlslTypeDescription<unsigned int, 1, 1> {};
+
+template <> struct GlslType<glm::vec2> : detail::GlslTypeDescription<float, 1, 2> {};
+template <> struct GlslType<glm::vec3> : detail::GlslTypeDescription<float, 1, 3> {};
+template <> struct GlslType<glm::vec4> : detail::GlslTypeDescription<float, 1, 4> {};
+template <> struct GlslType<glm::dvec2> : detail::GlslTypeDescription<double, 1, 2> {};
+template <> struct GlslType<glm::dvec3> : detail::GlslTypeDescription<double, 1, 3> {};
+template <> struct GlslType<glm::dvec4> : detail::GlslTypeDescription<double, 1, 4> {};
+template <> struct GlslType<glm::ivec2> : detail::GlslTypeDescription<int, 1, 2> {};
+template <> struct GlslType<glm::ivec3> : detail::GlslTypeDescription<int, 1, 3> {};
+template <> struct GlslType<glm::ivec4> : detail::GlslTypeDescription<int, 1, 4> {};
+template <> struct GlslType<glm::uvec2> : detail::GlslTypeDescription<unsigned int, 1, 2> {};
+template <> struct GlslType<glm::uvec3> : detail::GlslTypeDescription<unsigned int, 1, 3> {};
+template <> struct GlslType<glm::uvec4> : detail::GlslTypeDescription<unsigned int, 1, 4> {};
+
+template <> struct GlslType<glm::mat2x2> : detail::GlslTypeDescription<float, 2, 2> {};
+template <> struct GlslType<glm::mat2x3> : detail::GlslTypeDescription<float, 2, 3> {};
+template <> struct GlslType<glm::mat2x4> : detail::GlslTypeDescription<float, 2, 4> {};
+template <> struct GlslType<glm::mat3x2> : detail::GlslTypeDescription<float, 3, 2> {};
+template <> struct GlslType<glm::mat3x3> : detail::GlslTypeDescription<float, 3, 3> {};
+template <> struct GlslType<glm::mat3x4> : detail::GlslTypeDescription<float, 3, 4> {};
+template <> struct GlslType<glm::mat4x2> : detail::GlslTypeDescription<float, 4, 2> {};
+template <> struct GlslType<glm::mat4x3> : detail::GlslTypeDescription<float, 4, 3> {};
+template <> struct GlslType<glm::mat4x4> : detail::GlslTypeDescription<float, 4, 4> {};
+template <> struct GlslType<glm::dmat2x2> : detail::GlslTypeDescription<double, 2, 2> {};
+template <> struct GlslType<glm::dmat2x3> : detail::GlslTypeDescription<double, 2, 3> {};
+template <> struct GlslType<glm::dmat2x4> : detail::GlslTypeDescription<double, 2, 4> {};
+template <> struct GlslType<glm::dmat3x2> : detail::GlslTypeDescription<double, 3, 2> {};
+template <> struct GlslType<glm::dmat3x3> : detail::GlslTypeDescription<double, 3, 3> {};
+template <> struct GlslType<glm::dmat3x4> : detail::GlslTypeDescription<double, 3, 4> {};
+template <> struct GlslType<glm::dmat4x2> : detail::GlslTypeDescription<double, 4, 2> {};
+template <> struct GlslType<glm::dmat4x3> : detail::GlslTypeDescription<double, 4, 3> {};
+template <> struct GlslType<glm::dmat4x4> : detail::GlslTypeDescription<double, 4, 4> {};
+
+
+// scalars, vectors and matrices; matrices are laid out like arrays of column vectors
+template <typename T, BufferLayout Layout>
+struct BufferLayoutTraits
+{
+    using Type = GlslType<T>;
+
+    static const std::size_t componentSize = sizeof(typename Type::ComponentType);
+    static const std::size_t columnSize = Type::rows * componentSize;
+    static const std::size_t vectorAlignment = (Type::rows == 3 ? 4 : Type::rows) * componentSize;
+
+    static const std::size_t alignment = Type::columns == 1 ? vectorAlignment : detail::AggregateAlignment<vectorAlignment, Layout>::value;
+    static const std::size_t columnStride = detail::AlignUp<columnSize, alignment>::value;
+    static const std::size_t size = Type::columns == 1 ? columnSize : Type::columns * columnStride;
+    static const std::size_t stride = detail::AlignUp<size, detail::AggregateAlignment<alignment, Layout>::value>::value;
+
+    static const bool native = Type::columns == 1 || columnStride == columnSize;
+
+    static void write(char * destination, const T & value)
+    {
+        const char * source = reinterpret_cast<const char *>(&value);
+
+        for (std::size_t column = 0; column < Type::columns; ++column)
+            std::memcpy(destination + column * columnStride, source + column * columnSize, columnSize);
+    }
+
+    static void read(const char * source, T & value)
+    {
+        char * destination = reinterpret_cast<char *>(&value);
+
+        for (std::size_t column = 0; column < Type::columns; ++column)
+            std::memcpy(destination + column * columnSize, source + column * columnStride, columnSize);
+    }
+};
+
+template <typename T, std::size_t Count, BufferLayout Layout>
+struct BufferLayoutTraits<std::array<T, Count>, Layout>
+{
+    using Element = BufferLayoutTraits<T, Layout>;
+
+    static const std::size_t alignment = detail::AggregateAlignment<Element::alignment, Layout>::value;
+    static const std::size_t size = Count * Element::stride;
+    static const std::size_t stride = size;
+
+    static const bool native = Element::native && Element::stride == sizeof(T);
+
+    static void write(char * destination, const std::array<T, Count> & value)
+    {
+        for (std::size_t i = 0; i < Count; ++i)
+            Element::write(destination + i * Element::stride, value[i]);
+    }
+
+    static void read(const char * source, std::array<T, Count> & value)
+    {
+        for (std::size_t i = 0; i < Count; ++i)
+            Element::read(source + i * Element::stride, value[i]);
+    }
+};
+
+template <typename... Members, BufferLayout Layout>
+struct BufferLayoutTraits<BufferStruct<Members...>, Layout>
+{
+    using MemberLayout = detail::StructLayout<Layout, 0, Members...>;
+
+    static const std::size_t alignment = detail::AggregateAlignment<MemberLayout::alignment, Layout>::value;
+    static const std::size_t size = detail::AlignUp<MemberLayout::end, alignment>::value;
+    static const std::size_t stride = size;
+
+    // structs have no C++ counterpart, their members are accessed individually
+    static const bool native = false;
+};
+
+template <typename... Members, BufferLayout Layout, std::size_t Index>
+struct BufferMemberOffset<BufferStruct<Members...>, Layout, Index>
+{
+    static_assert(Index < sizeof...(Members), "BufferStruct member index out of range");
+
+    static const std::size_t value = detail::StructMemberOffset<typename BufferLayoutTraits<BufferStruct<Members...>, Layout>::MemberLayout, Index>::value;
+};
+
+
+template <typename T, BufferLayout Layout>
+const std::size_t BufferView<T, Layout>::stride;
+
+template <typename T, BufferLayout Layout>
+BufferView<T, Layout>::BufferView()
+: m_data(nullptr)
+, m_count(0)
+{
+}
+
+template <typename T, BufferLayout Layout>
+BufferView<T, Layout>::BufferView(void * data, const std::size_t count)
+: m_data(static_cast<char *>(data))
+, m_count(count)
+{
+}
+
+template <typename T, BufferLayout Layout>
+BufferView<T, Layout>::BufferView(Buffer * buffer, const gl::GLintptr offset, const std::size_t count, const gl::BufferAccessMask access)
+: m_data(nullptr)
+, m_count(count)
+{
+    assert(buffer != nullptr);
+
+    m_data = static_cast<char *>(buffer->mapRange(offset, byteSize(count), access));
+
+    if (!m_data)
+        m_count = 0;
+}
+
+template <typename T, BufferLayout Layout>
+gl::GLsizeiptr BufferView<T, Layout>::byteSize(const std::size_t count)
+{
+    return static_cast<gl::GLsizeiptr>(count * stride);
+}
+
+template <typename T, BufferLayout Layout>
+void * BufferView<T, Layout>::data() const
+{
+    return m_data;
+}
+
+template <typename T, BufferLayout Layout>
+std::size_t BufferView<T, Layout>::size() const
+{
+    return m_count;
+}
+
+template <typename T, BufferLayout Layout>
+bool BufferView<T, Layout>::isValid() const
+{
+    return m_data != nullptr;
+}
+
+template <typename T, BufferLayout Layout>
+T & BufferView<T, Layout>::operator[](const std::size_t index) const
+{
+    static_assert(Traits::native, "the buffer layout of this type differs from its C++ layout, use set() and get()");
+
+    return *reinterpret_cast<T *>(element(index));
+}
+
+template <typename T, BufferLayout Layout>
+void BufferView<T, Layout>::set(const std::size_t index, const T & value) const
+{
+    Traits::write(element(index), value);
+}
+
+template <typename T, BufferLayout Layout>
+T BufferView<T, Layout>::get(const std::size_t index) const
+{
+    T value;
+    Traits::read(element(index), value);
+
+    return value;
+}
+
+template <typename T, BufferLayout Layout>
+template <std::size_t Index>
+typename BufferView<T, Layout>::template Member<Index> & BufferView<T, Layout>::member(const std::size_t index) const
+{
+    static_assert(BufferLayoutTraits<Member<Index>, Layout>::native, "the buffer layout of this member differs from its C++ layout, use setMember() and getMember()");
+
+    return *reinterpret_cast<Member<Index> *>(element(index) + BufferMemberOffset<T, Layout, Index>::value);
+}
+
+template <typename T, BufferLayout Layout>
+template <std::size_t Index>
+void BufferView<T, Layout>::setMember(const std::size_t index, const Member<Index> & value) const
+{
+    BufferLayoutTraits<Member<Index>, Layout>::write(element(index) + BufferMemberOffset<T, Layout, Index>::value, value);
+}
+
+template <typename T, BufferLayout Layout>
+template <std::size_t Index>
+typename BufferView<T, Layout>::template Member<Index> BufferView<T, Layout>::getMember(const std::size_t index) const
+{
+    Member<Index> value;
+    BufferLayoutTraits<Member<Index>, Layout>::read(element(index) + BufferMemberOffset<T, Layout, Index>::value, value);
+
+    return value;
+}
+
+template <typename T, BufferLayout Layout>
+char * BufferView<T, Layout>::element(const std::size_t index) const
+{
+    assert(index < m_count);
+
+    return m_data + index * stride;
+}
+
+} // namespace globjects
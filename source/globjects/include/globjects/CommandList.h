@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Program;
+class State;
+class Texture;
+class VertexArray;
+
+
+/** \brief Records draw submissions for later, possibly repeated, replay.
+
+    A CommandList stores the per-draw operations of globjects as compact,
+    fixed-size entries in a single contiguous arena. Recording does not call
+    OpenGL, so a list can be built away from the context thread and replayed
+    any number of times using execute(), which has to be called on the context
+    thread. All objects referenced by recorded commands are kept alive until
+    the list is cleared or destroyed.
+
+    Uniform values are copied on record and have to be trivially copyable
+    (i.e., scalars, glm vectors and matrices, TextureHandle). Uniforms recorded
+    by name are resolved on execute, so recording does not require a location
+    query. Client memory referenced by indirect and index pointers is not copied.
+
+    Distinct lists can be recorded concurrently on different threads, see
+    ParallelRecorder.
+
+    \code{.cpp}
+        ref_ptr<CommandList> commands = new CommandList;
+        commands->use(program);
+        commands->setUniform(program, 0, glm::mat4());
+        commands->bindActive(texture, gl::GL_TEXTURE0);
+        commands->drawArrays(vao, gl::GL_TRIANGLES, 0, 3);
+
+        commands->execute();
+    \endcode
+
+    \see Program
+    \see VertexArray
+*/
+class GLOBJECTS_API CommandList : public Referenced
+{
+public:
+    CommandList();
+
+    void use(const Program * program);
+    template <typename T>
+    void setUniform(Program * program, gl::GLint location, const T & value);
+    template <typename T>
+    void setUniform(Program * program, const std::string & name, const T & value);
+
+    void bindActive(const Texture * texture, gl::GLenum unit);
+    void bindBase(const Buffer * buffer, gl::GLenum target, gl::GLuint index);
+    void bindRange(const Buffer * buffer, gl::GLenum target, gl::GLuint index, gl::GLintptr offset, gl::GLsizeiptr size);
+
+    void apply(State * state);
+
+    void drawArrays(const VertexArray * vao, gl::GLenum mode, gl::GLint first, gl::GLsizei count);
+    void drawArraysInstanced(const VertexArray * vao, gl::GLenum mode, gl::GLint first, gl::GLsizei count, gl::GLsizei instanceCount);
+    void drawArraysInstancedBaseInstance(const VertexArray * vao, gl::GLenum mode, gl::GLint first, gl::GLsizei count, gl::GLsizei instanceCount, gl::GLuint baseInstance);
+    void drawArraysIndirect(const VertexArray * vao, gl::GLenum mode, const void * indirect = nullptr);
+    void multiDrawArraysIndirect(const VertexArray * vao, gl::GLenum mode, const void * indirect, gl::GLsizei drawCount, gl::GLsizei stride);
+
+    void drawElements(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr);
+    void drawElementsBaseVertex(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLint baseVertex);
+    void drawElementsInstanced(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount);
+    void drawElementsInstancedBaseInstance(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount, gl::GLuint baseInstance);
+    void drawElementsInstancedBaseVertex(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount, gl::GLint baseVertex);
+    void drawElementsInstancedBaseVertexBaseInstance(const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount, gl::GLint baseVertex, gl::GLuint baseInstance);
+    void multiDrawElementsIndirect(const VertexArray * vao, gl::GLenum mode, gl::GLenum type, const void * indirect, gl::GLsizei drawCount, gl::GLsizei stride);
+
+    void drawRangeElements(const VertexArray * vao, gl::GLenum mode, gl::GLuint start, gl::GLuint end, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr);
+    void drawRangeElementsBaseVertex(const VertexArray * vao, gl::GLenum mode, gl::GLuint start, gl::GLuint end, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLint baseVertex);
+
+    void dispatchCompute(Program * program, gl::GLuint numGroupsX, gl::GLuint numGroupsY, gl::GLuint numGroupsZ);
+    void dispatchComputeGroupSize(Program * program, gl::GLuint numGroupsX, gl::GLuint numGroupsY, gl::GLuint numGroupsZ, gl::GLuint groupSizeX, gl::GLuint groupSizeY, gl::GLuint groupSizeZ);
+
+    /** Appends all commands of another list, e.g., to merge lists recorded on worker threads.
+    */
+    void append(const CommandList & other);
+
+    void execute() const;
+    void clear();
+
+    bool isEmpty() const;
+    std::size_t count() const;
+    std::size_t byteSize() const;
+
+protected:
+    virtual ~CommandList();
+
+    enum class Opcode : unsigned int;
+    using UniformSetter = void (*)(Program * program, gl::GLint location, const void * value);
+    using NamedUniformSetter = void (*)(Program * program, const char * name, const void * value);
+
+    template <typename T>
+    static void setUniformValue(Program * program, gl::GLint location, const void * value);
+    template <typename T>
+    static void setNamedUniformValue(Program * program, const char * name, const void * value);
+
+    void record(Opcode opcode, const void * command, std::size_t size, const void * data = nullptr, std::size_t dataSize = 0);
+    void recordUniform(Program * program, gl::GLint location, UniformSetter setter, const void * value, std::size_t size);
+    void recordUniform(Program * program, const std::string & name, NamedUniformSetter setter, const void * value, std::size_t size);
+    void keep(const Referenced * object);
+
+protected:
+    std::vector<unsigned char> m_commands;
+    std::vector<ref_ptr<const Referenced>> m_objects;
+    std::size_t m_count;
+};
+
+} // namespace globjects
+
+#include <globjects/CommandList.hpp>
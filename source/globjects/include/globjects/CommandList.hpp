@@ -0,0 +1,47 @@
+#pragma once
+
+#include <globjects/CommandList.h>
+
+#include <cstring>
+#include <type_traits>
+
+#include <globjects/Program.h>
+
+namespace globjects
+{
+
+template <typename T>
+void CommandList::setUniform(Program * program, const gl::GLint location, const T & value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "uniform values are recorded by copying their bytes");
+
+    recordUniform(program, location, &CommandList::setUniformValue<T>, &value, sizeof(T));
+}
+
+template <typename T>
+void CommandList::setUniform(Program * program, const std::string & name, const T & value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "uniform values are recorded by copying their bytes");
+
+    recordUniform(program, name, &CommandList::setNamedUniformValue<T>, &value, sizeof(T));
+}
+
+template <typename T>
+void CommandList::setUniformValue(Program * program, const gl::GLint location, const void * value)
+{
+    T typedValue;
+    std::memcpy(&typedValue, value, sizeof(T));
+
+    program->setUniform(location, typedValue);
+}
+
+template <typename T>
+void CommandList::setNamedUniformValue(Program * program, const char * name, const void * value)
+{
+    T typedValue;
+    std::memcpy(&typedValue, value, sizeof(T));
+
+    program->setUniform(name, typedValue);
+}
+
+} // namespace globjects
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Program;
+class State;
+class VertexArray;
+
+
+/** \brief Collapses consecutive indexed draws into multi-draw-indirect calls.
+
+    Draws that share program, state, vertex array, primitive mode and index
+    type are collected into runs. On flush(), all recorded commands are
+    streamed into an indirect buffer and each run is issued with a single
+    glMultiDrawElementsIndirect. Without ARB_multi_draw_indirect, the commands
+    are issued one by one.
+
+    Per-draw data can be fetched in shaders either using gl_DrawIDARB (the
+    index within a run) or using the base instance. For non-instanced draws,
+    the base instance is set to the draw index returned on record, which
+    counts all draws since the last flush.
+
+    \code{.cpp}
+        for (const Mesh & mesh : meshes)
+        {
+            GLuint drawIndex = batcher->drawElementsBaseVertex(program, nullptr, vao, gl::GL_TRIANGLES, mesh.count, gl::GL_UNSIGNED_INT, mesh.indexOffset, mesh.baseVertex);
+            perDrawData[drawIndex] = mesh.transform;
+        }
+
+        batcher->flush();
+    \endcode
+
+    \see https://www.opengl.org/registry/specs/ARB/multi_draw_indirect.txt
+*/
+class GLOBJECTS_API DrawBatcher : public Referenced
+{
+public:
+    /** Layout of a single indirect command, as expected by OpenGL.
+    */
+    struct DrawElementsIndirectCommand
+    {
+        gl::GLuint count;
+        gl::GLuint instanceCount;
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+        gl::GLuint baseInstance;
+    };
+
+public:
+    DrawBatcher();
+
+    /** \param indices byte offset into the element array buffer of the vertex array
+        \return index of the draw since the last flush
+    */
+    gl::GLuint drawElementsBaseVertex(Program * program, State * state, const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLint baseVertex);
+    gl::GLuint drawElementsInstancedBaseVertexBaseInstance(Program * program, State * state, const VertexArray * vao, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount, gl::GLint baseVertex, gl::GLuint baseInstance);
+
+    /** Issues all pending draws and resets the batcher.
+    */
+    void flush();
+
+    std::size_t pendingDraws() const;
+    std::size_t pendingRuns() const;
+
+    Buffer * indirectBuffer() const;
+
+protected:
+    virtual ~DrawBatcher();
+
+    struct Run
+    {
+        Program * program;
+        State * state;
+        const VertexArray * vao;
+        gl::GLenum mode;
+        gl::GLenum type;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    gl::GLuint add(Program * program, State * state, const VertexArray * vao, gl::GLenum mode, gl::GLenum type, const void * indices, const DrawElementsIndirectCommand & command);
+
+protected:
+    ref_ptr<Buffer> m_indirectBuffer;
+
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    std::vector<Run> m_runs;
+};
+
+} // namespace globjects
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Sync;
+
+
+/** \brief Runs CPU continuations once the GPU has passed a fence.
+
+    after() attaches a callback to a Sync object, afterCurrentFrame() to a
+    fence that poll() inserts after all commands of the current frame.
+    poll(), called once per frame on the context thread, checks the pending
+    fences in submission order using zero-timeout waits and runs the
+    callbacks of all passed fences, so the render thread never blocks on the
+    GPU. Typical continuations recycle buffers, consume readbacks, delete
+    objects that were still in use or retrieve query results.
+
+    Optionally, a wait thread with a context of the same share group blocks
+    on the fences instead, so poll() only runs callbacks and issues no sync
+    queries at all. Callbacks are always run on the thread calling poll().
+
+    \code{.cpp}
+        ref_ptr<FenceScheduler> scheduler = new FenceScheduler;
+
+        // while recording a frame
+        scheduler->afterCurrentFrame([pool, buffer]() { pool->recycle(buffer); });
+
+        // at the end of every frame
+        scheduler->poll();
+    \endcode
+
+    \see Sync
+*/
+class GLOBJECTS_API FenceScheduler : public Referenced
+{
+public:
+    using Callback = std::function<void()>;
+    using ContextFunction = std::function<void()>;
+
+public:
+    FenceScheduler();
+
+    /** Runs callback in a later poll() once fence is signaled.
+    */
+    void after(Sync * fence, const Callback & callback);
+
+    /** Runs callback in a later poll() once the GPU finished the current frame.
+    */
+    void afterCurrentFrame(const Callback & callback);
+
+    /** Fences the current frame and runs the callbacks of all passed fences in submission order.
+        \return number of run callbacks
+    */
+    std::size_t poll();
+
+    /** Waits for all pending fences and runs their callbacks.
+    */
+    void finish();
+
+    /** Starts a thread that blocks on the pending fences.
+        \param makeCurrent called on the new thread, has to make a context current that shares objects with the context of this scheduler
+        \param doneCurrent called on the new thread before it exits, e.g., to release the context
+    */
+    void startWaitThread(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent = nullptr);
+    void stopWaitThread();
+    bool hasWaitThread() const;
+
+    std::size_t pendingCount() const;
+
+protected:
+    virtual ~FenceScheduler();
+
+    struct Continuation
+    {
+        unsigned long long id;
+        ref_ptr<Sync> fence;
+        Callback callback;
+    };
+
+    bool isSignaled(Sync * fence, bool wait);
+    void fenceFrame();
+    void push(Sync * fence, const Callback & callback);
+    void waitLoop();
+
+protected:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::deque<Continuation> m_continuations;
+    std::vector<Callback> m_frameCallbacks;
+
+    unsigned long long m_nextId;
+    unsigned long long m_signaledId; // all continuations with a lower id passed their fence
+    ref_ptr<Sync> m_lastSignaled;
+
+    std::thread m_waitThread;
+    bool m_stopWaiting;
+    bool m_flushPending;
+};
+
+} // namespace globjects
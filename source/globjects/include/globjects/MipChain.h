@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/pixels.h>
+
+namespace globjects
+{
+
+class Texture;
+
+
+/** \brief Downsamples an image into a mipmap chain on the CPU.
+
+    Each level is filtered from the previous one with a separable box or
+    Kaiser-windowed sinc filter, whose footprint beyond the image edges is
+    resolved like the given GL_TEXTURE_WRAP_* modes. Rows are distributed
+    over worker threads and accumulated with the SSE2 or AVX2 kernels of
+    pixels::convert(). Unsigned byte sRGB images are filtered in linear space.
+    Levels are stored in the image's format and type, with rows padded to the
+    default unpack alignment, ready for storage2D() and subImage2D() per level.
+    This allows uploading pre-filtered levels of images whose levels cannot or
+    should not be generated by the driver, e.g., images in array textures
+    built off the render thread.
+
+    \code{.cpp}
+        MipChain::Options options;
+        options.filter = MipChain::Filter::Kaiser;
+        options.wrapS = GL_REPEAT;
+        options.wrapT = GL_REPEAT;
+        options.sRGB = true;
+
+        ref_ptr<MipChain> chain = new MipChain(pixels, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), size, options);
+
+        m_albedo = chain->createTexture(GL_SRGB8_ALPHA8);
+    \endcode
+
+    Supported are GL_UNSIGNED_BYTE and GL_FLOAT images of one to four color components.
+*/
+class GLOBJECTS_API MipChain : public Referenced
+{
+public:
+    enum class Filter
+    {
+        Box,
+        Kaiser
+    };
+
+    struct GLOBJECTS_API Options
+    {
+        Options();
+
+        Filter filter;
+        gl::GLenum wrapS;
+        gl::GLenum wrapT;
+        glm::vec4 borderColor;      ///< for GL_CLAMP_TO_BORDER, in the order of the format's components
+        bool sRGB;                  ///< color components of unsigned byte images are sRGB encoded, alpha stays linear
+        gl::GLsizei levels;         ///< including the image, 0 for a full chain down to 1 x 1
+        unsigned int threadCount;   ///< 0 for the number of hardware threads
+    };
+
+    struct Level
+    {
+        glm::ivec2 size;
+        std::vector<unsigned char> data;
+    };
+
+public:
+    /** Number of levels of a full chain for an image of the given size.
+    */
+    static gl::GLsizei levelCount(const glm::ivec2 & size);
+
+    /** Generates the chain, data is not referenced afterwards.
+    */
+    MipChain(const void * data, const pixels::Layout & layout, const glm::ivec2 & size, const Options & options = Options());
+
+    bool isValid() const;
+
+    /** Format, type and row alignment of all levels.
+    */
+    const pixels::Layout & layout() const;
+
+    const std::vector<Level> & levels() const;
+    std::size_t byteSize() const;
+
+    /** Allocates a 2D texture and uploads all levels, must be called with a context current.
+        \return nullptr if the chain is not valid
+    */
+    Texture * createTexture(gl::GLenum internalFormat) const;
+
+    /** Uploads all levels to the allocated levels of a 2D texture, with no pixel unpack buffer bound.
+    */
+    void subImage(Texture * texture) const;
+
+    /** Uploads all levels to a layer of a 2D array texture.
+    */
+    void subImage(Texture * texture, gl::GLint layer) const;
+
+protected:
+    virtual ~MipChain();
+
+    void generate(const void * data, const pixels::Layout & layout, const glm::ivec2 & size, const Options & options);
+
+    void upload(Texture * texture, gl::GLint layer) const;
+
+protected:
+    pixels::Layout m_layout;
+    std::vector<Level> m_levels;
+};
+
+} // namespace globjects
@@ -44,6 +44,10 @@ public:
 
     bool isDefault() const;
 
+    /** Whether the OpenGL object is deleted along with this one, false for objects created from ids.
+    */
+    bool hasOwnership() const;
+
     virtual gl::GLenum objectType() const = 0;
 
     /** unlinks and destroys the associated opengl object
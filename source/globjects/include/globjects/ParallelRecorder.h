@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class CommandList;
+
+
+/** \brief Records command lists on worker threads and submits them on the context thread.
+
+    record() splits a frame into a number of tasks and distributes them over
+    a pool of worker threads. Every task records into its own CommandList, so
+    workers never share recording state and do not issue any OpenGL calls.
+    submit() then executes all lists on the context thread in task order,
+    which makes the result independent of how tasks were scheduled.
+
+    The record function must only resolve CPU-side data (e.g., traverse the
+    scene, select programs, compute uniform values) and may not call OpenGL
+    or any globjects function that does, since workers have no current
+    context. Uniforms can be recorded by location or by name; names are
+    resolved on submission.
+
+    \code{.cpp}
+        ref_ptr<ParallelRecorder> recorder = new ParallelRecorder;
+
+        recorder->record(chunks.size(), [&](CommandList * commands, std::size_t task)
+        {
+            for (const Node & node : chunks[task])
+            {
+                commands->use(node.program);
+                commands->setUniform(node.program, "model", node.transform);
+                commands->drawElements(node.vao, gl::GL_TRIANGLES, node.count, gl::GL_UNSIGNED_INT);
+            }
+        });
+
+        recorder->submit();
+    \endcode
+
+    \see CommandList
+*/
+class GLOBJECTS_API ParallelRecorder : public Referenced
+{
+public:
+    using RecordFunction = std::function<void(CommandList * commands, std::size_t task)>;
+
+public:
+    /** \param threadCount number of worker threads, the hardware concurrency by default
+    */
+    ParallelRecorder(unsigned int threadCount = 0);
+
+    /** Clears the lists of the previous frame and records taskCount tasks in
+        parallel. Blocks until all tasks are recorded. Has to be called from
+        the context thread, since clearing may release OpenGL objects.
+    */
+    void record(std::size_t taskCount, const RecordFunction & function);
+
+    /** Executes the lists of the last record() in task order.
+    */
+    void submit() const;
+
+    /** Appends the lists of the last record() in task order, e.g., for repeated replay.
+    */
+    void merge(CommandList * commands) const;
+
+    std::size_t taskCount() const;
+    CommandList * commandList(std::size_t task) const;
+
+    unsigned int threadCount() const;
+
+protected:
+    virtual ~ParallelRecorder();
+
+    void work();
+    void runTasks();
+
+protected:
+    std::vector<std::thread> m_threads;
+    std::vector<ref_ptr<CommandList>> m_lists;
+    std::size_t m_taskCount;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_finished;
+
+    const RecordFunction * m_function;
+    std::atomic<std::size_t> m_nextTask;
+    std::size_t m_busyThreads;
+    unsigned long long m_generation;
+    bool m_quit;
+};
+
+} // namespace globjects
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Framebuffer;
+class Sync;
+class Texture;
+
+
+/** \brief Reads back framebuffer and texture contents without stalling the pipeline.
+
+    Every request is issued into one of a ring of GL_PIXEL_PACK_BUFFER
+    buffers and fenced with a Sync object. poll(), called once per frame,
+    checks the fences in submission order using zero-timeout waits, maps
+    the buffers of completed requests and delivers their bytes, either to a
+    callback or by copying into caller-owned memory. Results thereby arrive
+    some frames after their request, but the render thread never waits for
+    the GPU unless all buffers of the ring are in flight.
+
+    The callback receives a pointer to the mapped data, which is only valid
+    during the call. Rows are laid out according to GL_PACK_ALIGNMENT at the
+    time of the request.
+
+    \code{.cpp}
+        ref_ptr<ReadbackQueue> readbacks = new ReadbackQueue(3);
+
+        // every frame
+        readbacks->readPixels(fbo, gl::GL_COLOR_ATTACHMENT0, { 0, 0, width, height }, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE,
+            [frame](const void * data, gl::GLsizeiptr size) { write(frame, data, size); });
+
+        readbacks->poll();
+    \endcode
+*/
+class GLOBJECTS_API ReadbackQueue : public Referenced
+{
+public:
+    using Callback = std::function<void(const void * data, gl::GLsizeiptr size)>;
+
+public:
+    /** \param bufferCount number of pack buffers, i.e., the maximum number of requests in flight
+    */
+    ReadbackQueue(unsigned int bufferCount = 3);
+
+    void readPixels(const Framebuffer * fbo, gl::GLenum readBuffer, const std::array<gl::GLint, 4> & rect, gl::GLenum format, gl::GLenum type, const Callback & callback);
+    void readPixels(const Framebuffer * fbo, gl::GLenum readBuffer, const std::array<gl::GLint, 4> & rect, gl::GLenum format, gl::GLenum type, void * destination);
+
+    void getImage(const Texture * texture, gl::GLint level, gl::GLenum format, gl::GLenum type, const Callback & callback);
+    void getImage(const Texture * texture, gl::GLint level, gl::GLenum format, gl::GLenum type, void * destination);
+
+    /** Reads back a range of a buffer, e.g., results written by shaders. Shader
+        writes have to be made visible with GL_BUFFER_UPDATE_BARRIER_BIT before.
+    */
+    void readBuffer(const Buffer * source, gl::GLintptr offset, gl::GLsizeiptr size, const Callback & callback);
+    void readBuffer(const Buffer * source, gl::GLintptr offset, gl::GLsizeiptr size, void * destination);
+
+    /** Delivers all completed requests in submission order without waiting.
+        \return number of delivered requests
+    */
+    std::size_t poll();
+
+    /** Waits for and delivers all pending requests.
+    */
+    void finish();
+
+    std::size_t pendingCount() const;
+    unsigned int bufferCount() const;
+
+    /** Number of requests that had to wait for an older one, as an indicator for a too small ring.
+    */
+    std::size_t stallCount() const;
+
+protected:
+    virtual ~ReadbackQueue();
+
+    struct Request
+    {
+        std::size_t slot;
+        gl::GLsizeiptr size;
+        ref_ptr<Sync> sync;
+        Callback callback;
+    };
+
+    Buffer * acquire(gl::GLsizeiptr size, std::size_t & slot);
+    void submit(std::size_t slot, gl::GLsizeiptr size, const Callback & callback);
+    bool deliver(bool wait);
+
+    static Callback copyTo(void * destination);
+
+protected:
+    std::vector<ref_ptr<Buffer>> m_buffers;
+    std::vector<gl::GLsizeiptr> m_capacities;
+    std::size_t m_next;
+
+    std::deque<Request> m_requests;
+    std::size_t m_stallCount;
+};
+
+} // namespace globjects
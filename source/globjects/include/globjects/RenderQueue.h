@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class CommandList;
+class Program;
+class State;
+class Texture;
+class VertexArray;
+
+
+/** \brief Sorts draw items by state and submits them with minimal state changes.
+
+    Each added DrawItem gets a 64-bit sort key built from its program, state,
+    vertex array, texture set and depth. The items are radix sorted by key and
+    submitted through Program::use(), State::apply(), Texture::bindActive() and
+    the VertexArray draw calls, changing programs and states only once per group.
+
+    The sort mode decides how depth is weighted: StateOrder groups by state
+    first and sorts front-to-back within a group (opaque geometry), while
+    FrontToBack and BackToFront order by depth first (e.g., for blending).
+
+    The queue does not take ownership of the referenced objects; they have to
+    outlive the submission. Items are kept until clear() is called, so a queue
+    can be submitted repeatedly.
+
+    \code{.cpp}
+        RenderQueue::DrawItem item;
+        item.program = program;
+        item.vao = vao;
+        item.mode = gl::GL_TRIANGLES;
+        item.count = 36;
+        item.depth = distanceToCamera;
+
+        queue->add(item);
+        queue->submit();
+        queue->clear();
+    \endcode
+*/
+class GLOBJECTS_API RenderQueue : public Referenced
+{
+public:
+    enum class SortMode
+    {
+        StateOrder
+    ,   FrontToBack
+    ,   BackToFront
+    };
+
+    static const int MaxTextures = 8;
+
+    struct TextureBinding
+    {
+        gl::GLenum unit;
+        const Texture * texture;
+    };
+
+    struct GLOBJECTS_API DrawItem
+    {
+        DrawItem();
+
+        Program * program;
+        State * state; ///< optional
+        const VertexArray * vao;
+
+        TextureBinding textures[MaxTextures];
+        int textureCount;
+
+        gl::GLenum mode;
+        gl::GLenum type; ///< index type, or GL_NONE for non-indexed draws
+        gl::GLint first;
+        gl::GLsizei count;
+        const void * indices;
+        gl::GLint baseVertex;
+        gl::GLsizei instanceCount;
+        gl::GLuint baseInstance;
+
+        float depth; ///< non-negative view depth, e.g., distance to the camera
+    };
+
+public:
+    RenderQueue(SortMode sortMode = SortMode::StateOrder);
+
+    void setSortMode(SortMode sortMode);
+    SortMode sortMode() const;
+
+    void add(const DrawItem & item);
+    void clear();
+
+    std::size_t size() const;
+    bool isEmpty() const;
+
+    /** Issues all items in sorted order.
+    */
+    void submit();
+
+    /** Records all items in sorted order instead of issuing them.
+    */
+    void record(CommandList * commands);
+
+protected:
+    virtual ~RenderQueue();
+
+    void sort();
+
+protected:
+    SortMode m_sortMode;
+    bool m_sorted;
+
+    std::vector<DrawItem> m_items;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint32_t> m_order;
+
+    std::vector<std::uint64_t> m_keyScratch;
+    std::vector<std::uint32_t> m_orderScratch;
+};
+
+} // namespace globjects
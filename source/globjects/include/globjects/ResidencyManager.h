@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/TextureHandle.h>
+
+namespace globjects
+{
+
+class Texture;
+
+
+/** \brief Keeps the bindless textures referenced per frame resident under a byte budget.
+
+    Instead of making every texture resident up front, reference() is called
+    for each texture a frame uses. commit() then makes the newly referenced
+    textures resident in one batch, before the draw calls using their handles
+    are issued, and evicts the least recently used textures not referenced in
+    the current frame until the resident set fits into the budget again.
+    endFrame() closes the frame.
+
+    The size of a texture is computed once from its level parameters. If the
+    textures of a single frame exceed the budget, all of them stay resident
+    and the frame is counted in Stats::framesOverBudget.
+
+    \code{.cpp}
+        ref_ptr<ResidencyManager> residency = new ResidencyManager(256 << 20);
+
+        for (Material & material : visibleMaterials)
+            material.handle = residency->reference(material.texture);
+
+        residency->commit();
+
+        // upload handles, draw ...
+
+        residency->endFrame();
+    \endcode
+
+    Requires ARB_bindless_texture.
+
+    \see Texture::makeResident()
+*/
+class GLOBJECTS_API ResidencyManager : public Referenced
+{
+public:
+    struct Stats
+    {
+        std::size_t trackedTextures;
+        std::size_t residentTextures;
+        gl::GLint64 residentBytes;
+
+        std::size_t madeResident;       // since the last resetStats()
+        std::size_t madeNonResident;
+        std::size_t framesOverBudget;
+    };
+
+public:
+    ResidencyManager(gl::GLint64 budget = 512 << 20);
+
+    void setBudget(gl::GLint64 budget);
+    gl::GLint64 budget() const;
+
+    /** Marks texture as used by the current frame.
+        \return its handle, which is resident after the next commit()
+    */
+    TextureHandle reference(Texture * texture);
+
+    /** Applies the residency changes of the frame so far.
+    */
+    void commit();
+
+    /** Advances to the next frame. Textures only referenced by the manager
+        are made non-resident and no longer tracked.
+    */
+    void endFrame();
+
+    /** Makes texture non-resident and stops tracking it, e.g., before its storage is redefined.
+    */
+    void release(Texture * texture);
+
+    /** Makes all textures non-resident and stops tracking them.
+    */
+    void clear();
+
+    bool isResident(const Texture * texture) const;
+
+    const Stats & stats() const;
+    void resetStats();
+
+    /** Estimated size of all levels (and faces) of texture, from its level parameters.
+    */
+    static gl::GLint64 textureSize(const Texture * texture);
+
+protected:
+    virtual ~ResidencyManager();
+
+    struct Entry
+    {
+        ref_ptr<Texture> texture; // a handle keeps the texture's storage alive, so does the manager
+        TextureHandle handle;
+        gl::GLint64 size;
+        bool resident;
+        unsigned long long lastFrame;
+        std::list<const Texture *>::iterator lru;
+    };
+
+    void makeResident(Entry & entry);
+    void makeNonResident(Entry & entry);
+    void evict();
+
+protected:
+    gl::GLint64 m_budget;
+    unsigned long long m_frame;
+    bool m_overBudget;     // counted once per frame
+
+    std::map<const Texture *, Entry> m_entries;
+    std::list<const Texture *> m_lru;        // most recently referenced first
+    std::vector<const Texture *> m_pending;   // referenced, but not yet resident
+
+    Stats m_stats;
+};
+
+} // namespace globjects
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+
+#include <glm/vec4.hpp>
+
 #include <glbinding/gl/types.h>
 
 #include <globjects/globjects_api.h>
@@ -8,7 +13,48 @@
 namespace globjects 
 {
 
+/** \brief Complete sampling state of a sampler or texture, initialized with the OpenGL defaults.
+
+    Used as key of the shared samplers, see Sampler::shared().
+ */
+struct GLOBJECTS_API SamplerParameters
+{
+    SamplerParameters();
+
+    bool operator==(const SamplerParameters & other) const;
+    bool operator!=(const SamplerParameters & other) const;
+
+    std::size_t hash() const;
+
+    gl::GLenum minFilter;
+    gl::GLenum magFilter;
+    gl::GLenum wrapS;
+    gl::GLenum wrapT;
+    gl::GLenum wrapR;
+    gl::GLfloat minLod;
+    gl::GLfloat maxLod;
+    gl::GLfloat lodBias;
+    gl::GLenum compareMode;
+    gl::GLenum compareFunc;
+    gl::GLfloat maxAnisotropy;  ///< only applied if EXT_texture_filter_anisotropic is available
+    glm::vec4 borderColor;
+};
+
+
 /** \brief Wraps OpenGL sampler objects.
+
+    Scenes with many textures usually need only few distinct sampling
+    configurations. shared() hands out one sampler per configuration and
+    share group, so that textures can be sampled without setting (and
+    validating) their parameters individually:
+
+    \code{.cpp}
+        SamplerParameters trilinear;
+        trilinear.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        trilinear.wrapS = trilinear.wrapT = GL_CLAMP_TO_EDGE;
+
+        Sampler::shared(trilinear)->bind(0);
+    \endcode
         
     \see http://www.opengl.org/wiki/Sampler_Object
  */
@@ -18,6 +64,11 @@ public:
     Sampler();
     static Sampler * fromId(gl::GLuint id);
 
+    /** Returns the sampler of the current share group with the given parameters, creating it on first use.
+        Shared samplers live as long as their share group and must not be modified.
+    */
+    static const Sampler * shared(const SamplerParameters & parameters);
+
     virtual void accept(ObjectVisitor & visitor) override;
 
     void bind(gl::GLuint unit) const;
@@ -25,6 +76,9 @@ public:
 
     void setParameter(gl::GLenum name, gl::GLint value);
     void setParameter(gl::GLenum name, gl::GLfloat value);
+    void setParameter(gl::GLenum name, const glm::vec4 & value);
+
+    void setParameters(const SamplerParameters & parameters);
 
     gl::GLint getParameteri(gl::GLenum pname) const;
     gl::GLfloat getParameterf(gl::GLenum pname) const;
@@ -37,3 +91,17 @@ protected:
 };
 
 } // namespace globjects
+
+namespace std
+{
+
+template <>
+struct hash<globjects::SamplerParameters>
+{
+    std::size_t operator()(const globjects::SamplerParameters & parameters) const
+    {
+        return parameters.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/StateSetting.h>
+
+namespace globjects
+{
+
+/** \brief Restores the OpenGL state changed through globjects within its scope.
+
+    While a StateGuard is alive, it records the previous value of every
+    capability and state setting the first time it is changed through
+    globjects (globjects::enable(), State::apply(), ...). On destruction, or
+    when calling restore(), exactly these entries are reset to their previous
+    values. The previous values are taken from the per-context state tracker,
+    so only entries not yet known to globjects cause a glGet.
+
+    Guards may be nested. Settings without a known getter (e.g., custom
+    functions passed to AbstractState::set()) cannot be restored.
+
+    \see invalidateTrackedState()
+*/
+class GLOBJECTS_API StateGuard
+{
+    friend class StateRegistry;
+
+public:
+    StateGuard();
+    ~StateGuard();
+
+    void restore();
+
+protected:
+    StateGuard(const StateGuard &) = delete;
+    StateGuard & operator=(const StateGuard &) = delete;
+
+protected:
+    bool m_active;
+    std::map<gl::GLenum, bool> m_capabilities;
+    std::map<std::pair<gl::GLenum, int>, bool> m_indexedCapabilities;
+    std::unordered_map<StateSettingType, std::vector<StateSetting>> m_settings;
+};
+
+} // namespace globjects
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <set>
 
 #include <glbinding/gl/types.h>
@@ -46,7 +47,7 @@ public:
     const StateSettingType & type() const;
 
 protected:
-    AbstractFunctionCall * m_functionCall;
+    std::shared_ptr<AbstractFunctionCall> m_functionCall;
     StateSettingType m_type;
 };
 
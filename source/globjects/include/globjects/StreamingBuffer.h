@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Sync;
+
+
+/** \brief Ring buffer in persistently mapped memory for per-frame dynamic data.
+
+    The buffer allocates immutable storage once, maps it for its whole
+    lifetime, and hands out aligned sub-allocations in ring order. The data is
+    written directly into mapped memory, so no driver copy is involved.
+
+    fence() marks the end of a frame (or of any batch of draws that use the
+    allocations) and protects everything allocated since the previous fence
+    with a Sync object. An allocation only waits if it would overwrite a
+    region whose fence has not been passed by the GPU yet, i.e., when the
+    writer catches up with the GPU. The capacity should therefore hold the
+    data of all frames in flight, e.g., three times the per-frame size.
+
+    With FlushMode::Coherent, writes become visible without further action.
+    With FlushMode::Explicit, the memory is mapped without coherency and the
+    ranges written since the previous fence are flushed by fence().
+
+    \code{.cpp}
+        ref_ptr<StreamingBuffer> stream = new StreamingBuffer(3 * frameSize);
+
+        StreamingBuffer::Allocation uniforms = stream->allocate(sizeof(Transforms), uniformOffsetAlignment);
+        std::memcpy(uniforms.data, &transforms, sizeof(Transforms));
+        stream->buffer()->bindRange(gl::GL_UNIFORM_BUFFER, 0, uniforms.offset, uniforms.size);
+
+        // draw ...
+
+        stream->fence();
+    \endcode
+
+    Requires OpenGL 4.4 or ARB_buffer_storage.
+
+    \see https://www.opengl.org/registry/specs/ARB/buffer_storage.txt
+*/
+class GLOBJECTS_API StreamingBuffer : public Referenced
+{
+public:
+    enum class FlushMode
+    {
+        Coherent
+    ,   Explicit
+    };
+
+    struct Allocation
+    {
+        void * data;
+        gl::GLintptr offset;
+        gl::GLsizeiptr size;
+    };
+
+public:
+    StreamingBuffer(gl::GLsizeiptr capacity, FlushMode flushMode = FlushMode::Coherent);
+
+    /** Returns mapped memory for size bytes at an offset that is a multiple of alignment.
+        Waits for the GPU if the memory is still in use.
+    */
+    Allocation allocate(gl::GLsizeiptr size, gl::GLsizeiptr alignment = 16);
+
+    /** Allocates and copies data in one go.
+    */
+    Allocation write(const void * data, gl::GLsizeiptr size, gl::GLsizeiptr alignment = 16);
+
+    /** Ring position the next allocation of size bytes starts at, its offset is the position modulo capacity.
+        Positions increase monotonically, so memory at a position is reused once position + capacity is allocated.
+    */
+    unsigned long long nextPosition(gl::GLsizeiptr size, gl::GLsizeiptr alignment = 16) const;
+
+    /** Aligns head and skips the end of the ring if size bytes do not fit before it.
+    */
+    static unsigned long long place(unsigned long long head, gl::GLsizeiptr capacity, gl::GLsizeiptr size, gl::GLsizeiptr alignment);
+
+    /** Protects all allocations since the previous fence, to be called after the commands using them are issued.
+    */
+    void fence();
+
+    Buffer * buffer() const;
+    gl::GLsizeiptr capacity() const;
+    FlushMode flushMode() const;
+
+    /** Number of allocations that had to wait for the GPU, as an indicator for a too small capacity.
+    */
+    std::size_t stallCount() const;
+
+protected:
+    virtual ~StreamingBuffer();
+
+    struct Region
+    {
+        unsigned long long begin;
+        unsigned long long end;
+        ref_ptr<Sync> sync;
+    };
+
+    void waitFor(unsigned long long position);
+    void flush(unsigned long long begin, unsigned long long end);
+
+protected:
+    ref_ptr<Buffer> m_buffer;
+    gl::GLsizeiptr m_capacity;
+    FlushMode m_flushMode;
+    unsigned char * m_data;
+
+    // positions increase monotonically, the offset is the position modulo capacity
+    unsigned long long m_head;
+    unsigned long long m_regionBegin;
+    std::deque<Region> m_regions;
+
+    std::size_t m_stallCount;
+};
+
+} // namespace globjects
@@ -16,6 +16,7 @@ namespace globjects
 {
 
 class Buffer;
+struct SamplerParameters;
 
 
 /** \brief Wraps OpenGL texture objects.
@@ -45,9 +46,18 @@ public:
     void bindActive(gl::GLenum texture) const;
     void unbindActive(gl::GLenum texture) const;
 
+    /** Parameters are shadowed per texture, setting a parameter to its current value does not call OpenGL.
+    */
     void setParameter(gl::GLenum name, gl::GLenum value);
     void setParameter(gl::GLenum name, gl::GLint value);
     void setParameter(gl::GLenum name, gl::GLfloat value);
+    void setParameter(gl::GLenum name, const glm::vec4 & value);
+
+    void setParameters(const SamplerParameters & parameters);
+
+    /** Forgets the shadowed parameters, e.g., after they were changed without globjects.
+    */
+    void invalidateParameters();
 
     gl::GLint getParameter(gl::GLenum pname) const;
     gl::GLint getLevelParameter(gl::GLint level, gl::GLenum pname) const;
@@ -72,6 +82,8 @@ public:
     void compressedImage2D(gl::GLint level, gl::GLenum internalFormat, const glm::ivec2 & size, gl::GLint border, gl::GLsizei imageSize, const gl::GLvoid * data);
     void subImage2D(gl::GLint level, gl::GLint xOffset, gl::GLint yOffset, gl::GLsizei width, gl::GLsizei height, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
     void subImage2D(gl::GLint level, const glm::ivec2& offset, const glm::ivec2& size, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
+    void compressedSubImage2D(gl::GLint level, gl::GLint xOffset, gl::GLint yOffset, gl::GLsizei width, gl::GLsizei height, gl::GLenum format, gl::GLsizei imageSize, const gl::GLvoid * data);
+    void compressedSubImage2D(gl::GLint level, const glm::ivec2 & offset, const glm::ivec2 & size, gl::GLenum format, gl::GLsizei imageSize, const gl::GLvoid * data);
 
     void image3D(gl::GLint level, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height, gl::GLsizei depth, gl::GLint border, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
     void image3D(gl::GLint level, gl::GLenum internalFormat, const glm::ivec3 & size, gl::GLint border, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
@@ -79,6 +91,8 @@ public:
     void compressedImage3D(gl::GLint level, gl::GLenum internalFormat, const glm::ivec3 & size, gl::GLint border, gl::GLsizei imageSize, const gl::GLvoid * data);
     void subImage3D(gl::GLint level, gl::GLint xOffset, gl::GLint yOffset, gl::GLint zOffset, gl::GLsizei width, gl::GLsizei height, gl::GLsizei depth, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
     void subImage3D(gl::GLint level, const glm::ivec3& offset, const glm::ivec3& size, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
+    void compressedSubImage3D(gl::GLint level, gl::GLint xOffset, gl::GLint yOffset, gl::GLint zOffset, gl::GLsizei width, gl::GLsizei height, gl::GLsizei depth, gl::GLenum format, gl::GLsizei imageSize, const gl::GLvoid * data);
+    void compressedSubImage3D(gl::GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, gl::GLenum format, gl::GLsizei imageSize, const gl::GLvoid * data);
 
     void image2DMultisample(gl::GLsizei samples, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height, gl::GLboolean fixedSamplesLocations);
     void image2DMultisample(gl::GLsizei samples, gl::GLenum internalFormat, const glm::ivec2 & size, gl::GLboolean fixedSamplesLocations);
@@ -128,8 +142,20 @@ protected:
     Texture(IDResource * resource, gl::GLenum target);
     virtual ~Texture();
 
+    struct ShadowedParameter
+    {
+        gl::GLenum name;
+        glm::vec4 value;    // integer values are exactly representable
+    };
+
+    // returns false if the parameter already has the value
+    bool shadowParameter(gl::GLenum name, const glm::vec4 & value);
+
 protected:
     gl::GLenum m_target;
+
+    std::vector<ShadowedParameter> m_parameters;
+    bool m_defaultParameters; // parameters that are not shadowed have their initial values
 };
 
 } // namespace globjects
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Texture;
+
+
+/** \brief Places rectangles into a fixed size area with the skyline bottom-left heuristic.
+
+    The skyline is the upper contour of all placed rectangles. A rectangle is
+    placed where its top edge ends up lowest, preferring narrower skyline
+    segments on ties. Space below the skyline is not reused, see
+    TextureAtlas::defragment().
+*/
+class GLOBJECTS_API SkylinePacker
+{
+public:
+    SkylinePacker();
+    SkylinePacker(const glm::ivec2 & size);
+
+    /** \return false if the rectangle does not fit
+    */
+    bool insert(const glm::ivec2 & size, glm::ivec2 & position);
+
+    void clear();
+
+    glm::ivec2 size() const;
+    long long usedArea() const;
+
+protected:
+    struct Node
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    // top edge of a rectangle of the given width placed at node index, or -1 if it does not fit
+    int fit(std::size_t index, const glm::ivec2 & size) const;
+
+protected:
+    glm::ivec2 m_size;
+    std::vector<Node> m_skyline;
+    long long m_usedArea;
+};
+
+
+/** \brief Packs many small images into the layers of a 2D array texture.
+
+    Images are placed per layer with a SkylinePacker and uploaded with
+    subImage3D(). Each image gets a border of padding texels replicating its
+    edges, so that linear filtering does not bleed in neighbors. For mipmapped
+    atlases, placements are aligned to 2^(levels - 1) texels, so that every
+    image keeps its own texels down to the last level; call generateMipmaps()
+    after a batch of insertions.
+
+    Handles are stable: slot() resolves a handle to its layer and texture
+    coordinates, which change when the atlas grows a layer or defragment()
+    repacks it. When all layers are full, the texture is reallocated with
+    twice the layers. Removed images leave holes until their layer is empty
+    or defragment() is called. Both reallocation and defragmentation copy
+    texels on the GPU with glCopyImageSubData.
+
+    \code{.cpp}
+        ref_ptr<TextureAtlas> glyphs = new TextureAtlas(GL_R8, glm::ivec2(1024), 1);
+
+        TextureAtlas::Handle handle = glyphs->insert(bitmap.size, GL_RED, GL_UNSIGNED_BYTE, bitmap.data());
+
+        TextureAtlas::Slot slot = glyphs->slot(handle);
+        // sample slot.texture at vec3(mix(slot.uvRect.xy, slot.uvRect.zw, uv), slot.layer)
+    \endcode
+
+    Requires OpenGL 4.3 or ARB_copy_image and ARB_texture_storage.
+*/
+class GLOBJECTS_API TextureAtlas : public Referenced
+{
+public:
+    using Handle = unsigned int;
+    static const Handle InvalidHandle;
+
+    struct Slot
+    {
+        Texture * texture;
+        gl::GLint layer;
+        glm::vec4 uvRect;    ///< minimum (xy) and maximum (zw) texture coordinates
+        glm::ivec4 rect;     ///< texel offset (xy) and size (zw) within the layer
+    };
+
+public:
+    TextureAtlas(gl::GLenum internalFormat, const glm::ivec2 & layerSize, gl::GLsizei layers = 1, gl::GLsizei levels = 1, gl::GLint padding = 1);
+
+    /** Places and uploads an image with tightly packed rows.
+        \return InvalidHandle if the image (including padding) is larger than a layer
+    */
+    Handle insert(const glm::ivec2 & size, gl::GLenum format, gl::GLenum type, const void * data);
+    void remove(Handle handle);
+
+    Slot slot(Handle handle) const;
+
+    /** Regenerates the lower levels if images were inserted since the last call.
+    */
+    void generateMipmaps();
+
+    /** Repacks all images into as few layers as possible and returns the handles whose slots changed.
+    */
+    std::vector<Handle> defragment();
+
+    Texture * texture() const;
+    glm::ivec2 layerSize() const;
+    gl::GLsizei layers() const;
+    std::size_t imageCount() const;
+
+    /** Fraction of the texels of all layers used by images, including padding.
+    */
+    float occupancy() const;
+
+    /** Fraction of the placed texels that belong to removed images.
+    */
+    float fragmentation() const;
+
+protected:
+    virtual ~TextureAtlas();
+
+    struct Entry
+    {
+        bool live;
+        gl::GLint layer;
+        glm::ivec2 position;     // of the padded block
+        glm::ivec2 size;         // of the image
+    };
+
+    glm::ivec2 blockSize(const glm::ivec2 & size) const;
+    bool place(const glm::ivec2 & block, gl::GLint & layer, glm::ivec2 & position);
+
+    Texture * createTexture(gl::GLsizei layers) const;
+    void grow();
+
+    void copy(Texture * destination, const Entry & from, const Entry & to) const;
+
+protected:
+    gl::GLenum m_internalFormat;
+    glm::ivec2 m_layerSize;
+    gl::GLsizei m_levels;
+    gl::GLint m_padding;
+    gl::GLint m_alignment;
+
+    ref_ptr<Texture> m_texture;
+    std::vector<SkylinePacker> m_packers;
+    std::vector<std::size_t> m_liveCounts;    // per layer
+    std::vector<long long> m_removedAreas;    // per layer, of removed blocks still below the skyline
+
+    std::vector<Entry> m_entries;
+    std::vector<Handle> m_freeHandles;
+
+    bool m_mipmapsDirty;
+
+    std::vector<unsigned char> m_staging;
+};
+
+} // namespace globjects
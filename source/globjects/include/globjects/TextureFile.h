@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Texture;
+
+
+/** \brief Memory-maps a KTX2 or DDS file and uploads its images into an immutable texture.
+
+    The container header is parsed into the texture target, format, extent and
+    a table of images, each referring to a level of one or more layers (or one
+    cube map face) by its byte range within the file. createTexture() allocates
+    the texture with storage1D/2D/3D() and passes every image's mapped bytes
+    directly to subImage*() or compressedSubImage*(), so file contents are
+    never copied on the CPU. If an unpack buffer is given, the file is copied
+    into it once and the images are sourced from it instead, letting the
+    driver transfer them asynchronously.
+
+    \code{.cpp}
+        ref_ptr<TextureFile> file = new TextureFile("data/terrain/albedo.ktx2");
+
+        if (file->isValid())
+            m_albedo = file->createTexture();
+    \endcode
+
+    Supported are uncompressed 8 bit, half and float formats, BC1 to BC7,
+    ETC2 and ASTC 4x4 (KTX2 only). Supercompressed KTX2 files are rejected.
+    KTX2 files without levels get their levels generated.
+*/
+class GLOBJECTS_API TextureFile : public Referenced
+{
+public:
+    enum class Container
+    {
+        None,
+        KTX2,
+        DDS
+    };
+
+    struct Image
+    {
+        gl::GLint level;
+        gl::GLint layer;          ///< first layer, or face of a cube map
+        glm::ivec3 size;          ///< z is the depth of 3D textures or the number of layers
+        std::size_t offset;       ///< within the file
+        std::size_t byteSize;
+    };
+
+public:
+    TextureFile(const std::string & filePath);
+
+    /** Parses a file already in memory, which has to outlive this object.
+    */
+    TextureFile(const void * data, std::size_t size);
+
+    bool isValid() const;
+
+    Container container() const;
+    gl::GLenum target() const;
+    gl::GLenum internalFormat() const;
+    gl::GLenum format() const;          ///< equals internalFormat() for compressed formats
+    gl::GLenum type() const;
+    bool isCompressed() const;
+
+    glm::ivec3 size() const;
+    gl::GLsizei levels() const;
+    gl::GLsizei layers() const;         ///< array layers, including cube map faces of cube map arrays
+    bool generatesMipmaps() const;
+
+    const std::vector<Image> & images() const;
+
+    const unsigned char * data() const;
+    std::size_t byteSize() const;
+
+    /** Allocates a texture and uploads all images, must be called with a context current.
+        \param unpackBuffer optional buffer the file is staged in
+        \return nullptr if the file is not valid
+    */
+    Texture * createTexture(Buffer * unpackBuffer = nullptr) const;
+
+protected:
+    virtual ~TextureFile();
+
+    bool map(const std::string & filePath);
+    void unmap();
+
+    void parse();
+    bool parseKTX2();
+    bool parseDDS();
+
+    bool setTarget(bool volume, bool cubeMap, bool oneDimensional, bool array, gl::GLsizei layers);
+
+    std::size_t imageByteSize(const glm::ivec3 & size) const;
+    bool addImage(gl::GLint level, gl::GLint layer, const glm::ivec3 & size, std::size_t offset);
+
+    void allocate(Texture * texture) const;
+    void upload(Texture * texture, const Image & image, const unsigned char * data) const;
+
+protected:
+    const unsigned char * m_data;
+    std::size_t m_size;
+    bool m_mapped;
+
+    Container m_container;
+    gl::GLenum m_target;
+    gl::GLenum m_internalFormat;
+    gl::GLenum m_format;
+    gl::GLenum m_type;
+    glm::ivec2 m_blockSize;         // texels per block, 1 x 1 for uncompressed formats
+    std::size_t m_blockByteSize;
+
+    glm::ivec3 m_extent;
+    gl::GLsizei m_levels;
+    gl::GLsizei m_layers;
+    bool m_generateMipmaps;
+
+    std::vector<Image> m_images;
+};
+
+} // namespace globjects
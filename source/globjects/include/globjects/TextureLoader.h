@@ -0,0 +1,174 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/ContextHandle.h>
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class MipChain;
+class Sync;
+class Texture;
+
+
+/** \brief Loads 2D textures in the background: decodes on a worker pool and uploads on a shared context.
+
+    load() queues a file for decoding by the application's decoder on one of
+    the worker threads. Decoded images are uploaded by a dedicated thread on
+    a context of the render context's share group: the texture is allocated
+    with storage2D(), the pixels are copied into a pixel unpack buffer and
+    transferred with subImage2D(), lower levels are generated if requested,
+    and a Sync fence is inserted. Images can instead have their lower levels
+    filtered by a MipChain on the worker thread, in linear space for sRGB
+    internal formats, and uploaded along with the first level. poll(), called
+    once per frame on the render thread, hands every texture whose fence has
+    passed to its callback, so the render thread neither decodes nor waits
+    for uploads.
+
+    Without an upload thread, poll() uploads the decoded images itself.
+
+    The upload thread creates, fills and releases Texture, Buffer and Sync
+    objects only. The registries it shares with the render context for these
+    (objects, memory ledger, samplers) are locked, so the render thread may
+    meanwhile create and delete objects. Other globjects calls, e.g., on
+    programs, shaders or named strings, are not safe on a second context of
+    a share group while the first one is in use.
+
+    \code{.cpp}
+        ref_ptr<TextureLoader> loader = new TextureLoader(decodePng);
+
+        loader->startUploadThread(
+            [uploadContext]() { uploadContext->makeCurrent(); glbinding::Binding::initialize(false); },
+            [uploadContext]() { uploadContext->doneCurrent(); });
+
+        loader->load("data/terrain/albedo.png", [this](Texture * texture) { m_albedo = texture; });
+
+        // every frame
+        loader->poll();
+    \endcode
+
+    The loader has to be created on the render thread with its context current.
+*/
+class GLOBJECTS_API TextureLoader : public Referenced
+{
+public:
+    struct Image
+    {
+        glm::ivec2 size;
+        gl::GLenum internalFormat;
+        gl::GLenum format;
+        gl::GLenum type;
+        gl::GLsizei levels;                 ///< levels below the first are generated
+        std::vector<unsigned char> data;    ///< first level, tightly packed rows
+        bool filterLevels;                  ///< filter lower levels with a MipChain on the worker thread instead of generating them on the GPU, false by default
+    };
+
+    /** Decodes the file at path into image, called on a worker thread.
+        \return false if the file could not be decoded
+    */
+    using Decoder = std::function<bool(const std::string & path, Image & image)>;
+
+    /** Receives the loaded texture on the render thread, nullptr if loading failed.
+    */
+    using Callback = std::function<void(Texture * texture)>;
+
+    using ContextFunction = std::function<void()>;
+
+public:
+    /** \param workerCount number of decoding threads, 0 for one less than the number of hardware threads
+    */
+    TextureLoader(const Decoder & decoder, unsigned int workerCount = 0);
+
+    void load(const std::string & path, const Callback & callback);
+
+    /** Starts the upload thread.
+        \param makeCurrent called on the new thread, has to make a context current that shares objects with the render context and initialize glbinding for it
+        \param doneCurrent called on the new thread before it exits, e.g., to release the context
+    */
+    void startUploadThread(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent = nullptr);
+    void stopUploadThread();
+    bool hasUploadThread() const;
+
+    /** Delivers all loaded textures whose uploads completed.
+        \return number of delivered textures
+    */
+    std::size_t poll();
+
+    /** Waits for and delivers all pending loads.
+    */
+    void finish();
+
+    std::size_t pendingCount() const;
+    unsigned int workerCount() const;
+
+protected:
+    virtual ~TextureLoader();
+
+    struct Request
+    {
+        std::string path;
+        Callback callback;
+        Image image;
+        ref_ptr<MipChain> mipChain;
+    };
+
+    struct Result
+    {
+        ref_ptr<Texture> texture;
+        ref_ptr<Sync> fence;
+        Callback callback;
+    };
+
+    void decodeLoop();
+    void uploadLoop(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent);
+
+    // uploads all decoded images on the calling thread's context
+    void uploadDecoded();
+    Result upload(Request & request);
+
+    // replaces the image data by a mip chain if requested, called on a worker thread
+    static void filterLevels(Request & request);
+
+    void uploadImage(Texture * texture, const Image & image, void * mapped);
+    void uploadLevels(Texture * texture, const MipChain & mipChain, unsigned char * mapped);
+
+protected:
+    Decoder m_decoder;
+    glbinding::ContextHandle m_contextId;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_decodeCondition;
+    std::condition_variable m_uploadCondition;
+
+    std::deque<Request> m_decodeQueue;
+    std::deque<Request> m_uploadQueue;
+    std::deque<Result> m_results;
+    std::size_t m_pendingCount;
+
+    std::vector<std::thread> m_workers;
+    bool m_stopWorkers;
+
+    std::thread m_uploadThread;
+    bool m_stopUpload;
+
+    ref_ptr<Buffer> m_staging; // used by one context at a time
+};
+
+} // namespace globjects
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class StreamingBuffer;
+class Texture;
+
+
+/** \brief Streams buffer and texture data through a persistently mapped staging ring.
+
+    Source data is copied into a StreamingBuffer, either directly on the
+    context thread using upload(), or by worker threads that fill regions
+    obtained from reserve() and pass them to enqueue(). process() then issues
+    the transfers on the context thread: copySubData for buffers and
+    subImage* with the staging buffer bound as GL_PIXEL_UNPACK_BUFFER for
+    textures. Both read from driver-visible memory, so the calling thread
+    does not copy the client data again. Each processed batch is fenced and
+    its staging space is recycled once the GPU passed the fence.
+
+    process() accepts a byte budget per call, which spreads large uploads
+    over several frames and avoids frame time spikes.
+
+    Texture rows are read with the current GL_UNPACK_* pixel store state, so
+    staged rows should be tightly packed with respect to GL_UNPACK_ALIGNMENT.
+
+    \code{.cpp}
+        ref_ptr<UploadManager> uploads = new UploadManager(64 << 20);
+
+        // context thread
+        UploadManager::Staging staging = uploads->reserve(size);
+
+        // worker thread
+        decode(file, staging.data);
+        uploads->enqueue(staging, texture, 0, glm::ivec3(0), glm::ivec3(width, height, 1), gl::GL_RGBA, gl::GL_UNSIGNED_BYTE);
+
+        // context thread, once per frame
+        uploads->process(8 << 20);
+    \endcode
+
+    \see StreamingBuffer
+*/
+class GLOBJECTS_API UploadManager : public Referenced
+{
+public:
+    struct Staging
+    {
+        void * data;
+        gl::GLintptr offset;
+        gl::GLsizeiptr size;
+        unsigned long long mark; // ring position of the region, used for backpressure
+    };
+
+public:
+    UploadManager(gl::GLsizeiptr stagingSize);
+
+    /** Returns staging memory that can be filled on any thread. Context thread only.
+        Queued regions the new one would overwrite are issued first. Regions have to
+        be enqueued before the ring wraps around to them, i.e., before another
+        capacity() bytes of the staging buffer are reserved.
+    */
+    Staging reserve(gl::GLsizeiptr size);
+
+    /** Schedules a buffer update from a filled staging region. Thread-safe.
+    */
+    void enqueue(const Staging & staging, Buffer * buffer, gl::GLintptr offset);
+
+    /** Schedules a texture update from a filled staging region. Thread-safe.
+        The dimensionality of the subImage call follows the texture target.
+    */
+    void enqueue(const Staging & staging, Texture * texture, gl::GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, gl::GLenum format, gl::GLenum type);
+
+    /** Copies client data into the staging ring and schedules the update. Context thread only.
+    */
+    void upload(Buffer * buffer, gl::GLintptr offset, gl::GLsizeiptr size, const void * data);
+    void upload(Texture * texture, gl::GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, gl::GLenum format, gl::GLenum type, gl::GLsizeiptr dataSize, const void * data);
+
+    /** Issues scheduled updates in order until at least budget bytes are transferred. Context thread only.
+        \param budget byte budget, negative to issue all
+        \return number of transferred bytes
+    */
+    gl::GLsizeiptr process(gl::GLsizeiptr budget = -1);
+
+    std::size_t pendingCount() const;
+    gl::GLsizeiptr pendingBytes() const;
+
+    StreamingBuffer * staging() const;
+
+    /** Whether a region reserved at ring position begin reuses memory of a queued region at position queued.
+    */
+    static bool overwrites(unsigned long long queued, unsigned long long begin, gl::GLsizeiptr size, gl::GLsizeiptr capacity);
+
+protected:
+    virtual ~UploadManager();
+
+    struct Request
+    {
+        Staging staging;
+
+        ref_ptr<Buffer> buffer;
+        gl::GLintptr bufferOffset;
+
+        ref_ptr<Texture> texture;
+        gl::GLint level;
+        glm::ivec3 offset;
+        glm::ivec3 size;
+        gl::GLenum format;
+        gl::GLenum type;
+    };
+
+    void push(const Request & request);
+    void issue(const Request & request) const;
+
+protected:
+    ref_ptr<StreamingBuffer> m_staging;
+
+    mutable std::mutex m_mutex;
+    std::deque<Request> m_requests;
+    gl::GLsizeiptr m_pendingBytes;
+};
+
+} // namespace globjects
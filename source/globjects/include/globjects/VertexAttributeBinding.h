@@ -12,6 +12,7 @@ namespace globjects
 
 class Buffer;
 class VertexArray;
+struct BufferRange;
 
 
 class GLOBJECTS_API VertexAttributeBinding : public Referenced
@@ -32,6 +33,9 @@ public:
 	void setBuffer(
         const Buffer * vbo
     ,   gl::GLint baseoffset
+    ,   gl::GLint stride);
+    void setBuffer(
+        const BufferRange & range
     ,   gl::GLint stride);
 
 	void setFormat(
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/base/Referenced.h>
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+class Buffer;
+class Program;
+class ReadbackQueue;
+class Texture;
+
+
+/** \brief CPU page table of a sparse texture.
+
+    Tracks for every page of the sparse levels whether it is committed, how
+    often it is pinned by acquire() and in which frame it was last requested.
+    Requesting a page requests the pages covering it in all coarser levels as
+    well, so that sampling can always fall back to a coarser level. A page is
+    wanted while it is pinned or was requested within the last retainFrames
+    frames.
+
+    \see VirtualTexture
+*/
+class GLOBJECTS_API VirtualPageTable
+{
+public:
+    struct Page
+    {
+        gl::GLint level;
+        gl::GLint x;
+        gl::GLint y;
+    };
+
+public:
+    VirtualPageTable();
+    VirtualPageTable(const glm::ivec2 & size, const glm::ivec2 & pageSize, gl::GLint levels);
+
+    gl::GLint levels() const;
+    glm::ivec2 pageSize() const;
+
+    glm::ivec2 levelSize(gl::GLint level) const;
+    glm::ivec2 pageCount(gl::GLint level) const;
+
+    /** Number of pages of all levels, i.e., the size of the feedback buffer in uints.
+    */
+    std::size_t size() const;
+
+    std::size_t index(const Page & page) const;
+    Page page(std::size_t index) const;
+
+    /** Texel offset and size of a page, smaller than the page size at the level's border.
+    */
+    glm::ivec2 offset(const Page & page) const;
+    glm::ivec2 extent(const Page & page) const;
+
+    void acquire(const Page & page);
+    void release(const Page & page);
+    unsigned int refCount(const Page & page) const;
+
+    void request(const Page & page, unsigned long long frame);
+
+    void setCommitted(const Page & page, bool committed);
+    bool isCommitted(const Page & page) const;
+    std::size_t committedCount() const;
+
+    /** Wanted pages that are not committed, coarsest level and most recent request first.
+    */
+    std::vector<Page> missing(unsigned long long frame, unsigned long long retainFrames) const;
+
+    /** Committed pages that are no longer wanted, least recently requested first.
+    */
+    std::vector<Page> evictable(unsigned long long frame, unsigned long long retainFrames) const;
+
+protected:
+    struct Entry
+    {
+        unsigned int refCount;
+        bool committed;
+        bool requested;
+        unsigned long long lastRequest;
+    };
+
+    bool isWanted(const Entry & entry, unsigned long long frame, unsigned long long retainFrames) const;
+
+protected:
+    glm::ivec2 m_size;
+    glm::ivec2 m_pageSize;
+
+    std::vector<std::size_t> m_levelOffsets; // index of the first page of each level, plus the total
+    std::vector<Entry> m_entries;
+
+    std::size_t m_committedCount;
+};
+
+
+/** \brief Streams the pages of a sparse 2D texture on demand.
+
+    The texture is created with ARB_sparse_texture using the first virtual
+    page size reported by glGetInternalformativ for its internal format. Only
+    the levels of its mip tail are committed permanently; the pages of the
+    sparse levels are committed and uploaded when they are wanted:
+    - the application pins pages with acquire()/release() in pageTable(),
+    - or the shaders report the pages they sample. feedbackShaderSource()
+      provides requestVirtualPage(), which marks pages in a shader storage
+      buffer bound with bindFeedback(). endFrame() reads the buffer back
+      asynchronously and clears it; the requests arrive some frames later.
+
+    update() uncommits pages that are no longer wanted once more than the
+    maximum number of pages are committed, then commits and uploads the
+    missing pages, coarsest level first, until the upload budget of the
+    frame is spent. The texels of a page are requested from the provider;
+    if it returns false, e.g., because the data is still being loaded, the
+    page is retried in the next frame.
+
+    \code{.cpp}
+        ref_ptr<VirtualTexture> terrain = new VirtualTexture(GL_RGBA8, glm::ivec2(65536), 9, GL_RGBA, GL_UNSIGNED_BYTE,
+            [&tiles](const VirtualPageTable::Page & page, const glm::ivec2 & offset, const glm::ivec2 & size, void * data)
+            {
+                return tiles.read(page.level, offset, size, data);
+            });
+
+        // shader: #include the feedback source and call requestVirtualPage(terrainSampler, uv)
+        terrain->setUniforms(program);
+        terrain->bindFeedback(0);
+
+        // draw ...
+
+        terrain->endFrame();
+        terrain->update();
+    \endcode
+
+    Requires OpenGL 4.3 and ARB_sparse_texture; the feedback pass requires GLSL 4.30.
+*/
+class GLOBJECTS_API VirtualTexture : public Referenced
+{
+public:
+    /** Fills data with the texels of size at offset of the page's level, in
+        the texture's format and type with tightly packed rows.
+        \return false if the texels are not available yet
+    */
+    using PageProvider = std::function<bool(const VirtualPageTable::Page & page, const glm::ivec2 & offset, const glm::ivec2 & size, void * data)>;
+
+    struct Stats
+    {
+        std::size_t committedPages;
+        std::size_t missingPages;      // in the last update()
+
+        std::size_t uploadedPages;     // since the last resetStats()
+        std::size_t uncommittedPages;
+        gl::GLsizeiptr uploadedBytes;
+    };
+
+public:
+    VirtualTexture(gl::GLenum internalFormat, const glm::ivec2 & size, gl::GLsizei levels, gl::GLenum format, gl::GLenum type, const PageProvider & provider);
+
+    /** Virtual page sizes supported for internalFormat, empty if it cannot be sparse.
+    */
+    static std::vector<glm::ivec3> pageSizes(gl::GLenum target, gl::GLenum internalFormat);
+
+    Texture * texture() const;
+    VirtualPageTable & pageTable();
+    const VirtualPageTable & pageTable() const;
+
+    /** Number of levels with individually committed pages, coarser levels form the permanently committed mip tail.
+    */
+    gl::GLint sparseLevels() const;
+
+    void setUploadBudget(gl::GLsizeiptr bytesPerFrame);
+    gl::GLsizeiptr uploadBudget() const;
+
+    void setMaxCommittedPages(std::size_t count);
+    std::size_t maxCommittedPages() const;
+
+    /** Number of frames a requested page stays wanted without further requests.
+    */
+    void setRetainFrames(unsigned int frames);
+    unsigned int retainFrames() const;
+
+    /** GLSL declaring the feedback buffer at binding and requestVirtualPage(sampler2D, vec2).
+    */
+    static std::string feedbackShaderSource(gl::GLuint binding);
+
+    /** Sets the uniforms used by requestVirtualPage().
+    */
+    void setUniforms(Program * program) const;
+
+    void bindFeedback(gl::GLuint binding) const;
+    Buffer * feedback() const;
+
+    /** Reads back and clears the feedback of the frame and applies the requests of earlier frames.
+    */
+    void endFrame();
+
+    /** Uncommits unwanted pages and commits and uploads wanted ones within the upload budget.
+    */
+    void update();
+
+    const Stats & stats() const;
+    void resetStats();
+
+protected:
+    virtual ~VirtualTexture();
+
+    void applyFeedback(const void * data, gl::GLsizeiptr size, unsigned long long frame);
+
+    bool upload(const VirtualPageTable::Page & page, const glm::ivec2 & offset, const glm::ivec2 & size, bool commit);
+    void uploadTail();
+
+protected:
+    ref_ptr<Texture> m_texture;
+    gl::GLenum m_internalFormat;
+    gl::GLsizei m_levels;
+    gl::GLenum m_format;
+    gl::GLenum m_type;
+    PageProvider m_provider;
+
+    gl::GLint m_sparseLevels;
+    VirtualPageTable m_pageTable;
+    std::vector<bool> m_tailUploaded;
+
+    ref_ptr<Buffer> m_feedback;
+    ref_ptr<ReadbackQueue> m_readbacks;
+
+    std::vector<unsigned char> m_staging;
+
+    gl::GLsizeiptr m_uploadBudget;
+    std::size_t m_maxCommittedPages;
+    unsigned int m_retainFrames;
+
+    unsigned long long m_frame;
+
+    Stats m_stats;
+};
+
+} // namespace globjects
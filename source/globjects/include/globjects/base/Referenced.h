@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <globjects/globjects_api.h>
 
 #include <globjects/base/HeapOnly.h>
@@ -12,6 +14,9 @@ namespace globjects
     
     The ref counter can be increased and decreased using ref() and unref().
     If the ref counter decreases to zero, the referenced objects is deleted.
+    The counter is atomic, so references may be taken and released on other
+    threads (e.g., when recording a CommandList), but the last reference to an
+    OpenGL object has to be released on its context thread.
 
     Referenced objects should not be copy constructed or assigned.
 
@@ -35,7 +40,7 @@ protected:
     virtual ~Referenced();
 
 private:
-    mutable int m_refCounter;
+    mutable std::atomic<int> m_refCounter;
 };
 
 } // namespace globjects
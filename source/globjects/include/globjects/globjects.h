@@ -95,6 +95,14 @@ GLOBJECTS_API void disable(gl::GLenum capability, int index);
 GLOBJECTS_API bool isEnabled(gl::GLenum capability, int index);
 GLOBJECTS_API void setEnabled(gl::GLenum capability, int index, bool enabled);
 
+/** \brief forgets the OpenGL state and bindings tracked for the current context
+
+    Call this after OpenGL state was changed without globjects (e.g., by a
+    third-party library), so that StateGuards query it again instead of
+    restoring outdated values and no bind call is skipped erroneously.
+*/
+GLOBJECTS_API void invalidateTrackedState();
+
 GLOBJECTS_API void initializeStrategy(AbstractUniform::BindlessImplementation impl);
 GLOBJECTS_API void initializeStrategy(Buffer::BindlessImplementation impl);
 GLOBJECTS_API void initializeStrategy(Framebuffer::BindlessImplementation impl);
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <map>
+#include <string>
+
 #include <glbinding/gl/types.h>
 
 #include <globjects/globjects_api.h>
@@ -7,18 +11,57 @@
 namespace globjects
 {
 
+class Object;
+
 /**
  * \brief memory provides an interface to query current memory stats of OpenGL.
  *
- * All sizes in kb.
+ * total(), dedicated(), available() and evicted() report the driver's view
+ * in kb and require GL_NVX_gpu_memory_info; they return -1 otherwise.
+ *
+ * The allocation ledger works on every driver: globjects records the
+ * estimated size of every buffer, texture and renderbuffer storage it
+ * allocates, including mip chains, cube map faces and multisampling, and
+ * removes it when the object is deleted. Its sizes are in bytes and cover
+ * the share group of the current context. Objects are grouped by their
+ * name (see Object::setName()), given before or after their storage.
+ *
+ * \code{.cpp}
+ *     memory::addBudget(512 << 20, [](gl::GLint64 allocated, gl::GLint64 budget)
+ *     {
+ *         evictStreamedTextures(allocated - budget);
+ *     });
+ * \endcode
  */
 namespace memory
 {
+    using BudgetCallback = std::function<void(gl::GLint64 allocated, gl::GLint64 budget)>;
+
     GLOBJECTS_API gl::GLint total();
     GLOBJECTS_API gl::GLint dedicated();
     GLOBJECTS_API gl::GLint available();
     GLOBJECTS_API gl::GLint evicted();
     GLOBJECTS_API gl::GLint evictionCount();
+
+    /** Bytes allocated by globjects in total, per object type (GL_BUFFER, GL_TEXTURE, GL_RENDERBUFFER), or for a single object. */
+    GLOBJECTS_API gl::GLint64 allocated();
+    GLOBJECTS_API gl::GLint64 allocated(gl::GLenum objectType);
+    GLOBJECTS_API gl::GLint64 allocated(const Object * object);
+    GLOBJECTS_API std::map<std::string, gl::GLint64> allocatedByLabel();
+
+    /** Peak of allocated() since the start or since the last reset. */
+    GLOBJECTS_API gl::GLint64 highWaterMark();
+    GLOBJECTS_API void resetHighWaterMark();
+
+    /** Calls callback whenever an allocation makes allocated() exceed budget. */
+    GLOBJECTS_API void addBudget(gl::GLint64 budget, const BudgetCallback & callback);
+    GLOBJECTS_API void clearBudgets();
+
+    /** Estimated bytes of a texture allocated by glTexStorage* as recorded by the ledger, e.g., to check a budget beforehand. */
+    GLOBJECTS_API gl::GLint64 storageSize(gl::GLenum target, gl::GLsizei levels, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height = 1, gl::GLsizei depth = 1);
+
+    /** Exports totals, labels, budgets and all objects of the ledger. */
+    GLOBJECTS_API std::string toJson();
 }
 
 } // namespace globjects
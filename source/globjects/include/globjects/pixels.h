@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/vec2.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+
+namespace globjects
+{
+
+/**
+ * \brief pixels converts images between pixel formats and row layouts on the CPU.
+ *
+ * Rows are processed with SSE2 or AVX2 kernels where the processor supports
+ * them, and with scalar code otherwise. Source and destination rows are
+ * padded as OpenGL would for the given alignment and row length, so
+ * convert() can write straight into a mapped pixel unpack buffer:
+ *
+ * \code{.cpp}
+ *     const pixels::Layout source(GL_BGR, GL_UNSIGNED_BYTE);
+ *     const pixels::Layout staging(GL_RGBA, GL_UNSIGNED_BYTE, 1);
+ *
+ *     void * mapped = buffer->mapRange(0, staging.byteSize(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+ *     pixels::convert(frame, source, mapped, staging, size);
+ *     buffer->unmap();
+ * \endcode
+ *
+ * Supported conversions, besides repacking rows of any format and type:
+ * - GL_RGB/GL_BGR to GL_RGBA/GL_BGRA, unsigned bytes, alpha set to 255
+ * - GL_RGBA to GL_BGRA and vice versa, unsigned bytes
+ * - GL_FLOAT to GL_HALF_FLOAT, any format, rounded to nearest even
+ * - GL_UNSIGNED_BYTE to GL_FLOAT, any format, normalized, optionally
+ *   decoding sRGB color components (alpha stays linear)
+ */
+namespace pixels
+{
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /** \brief Format, type and row padding of an image in memory, see GL_UNPACK_ALIGNMENT and GL_UNPACK_ROW_LENGTH.
+    */
+    struct GLOBJECTS_API Layout
+    {
+        Layout(gl::GLenum format, gl::GLenum type, int alignment = 4, int rowLength = 0);
+
+        /** Layout using the current context's unpack alignment and row length.
+        */
+        static Layout unpack(gl::GLenum format, gl::GLenum type);
+
+        int pixelSize() const;
+        std::size_t rowStride(int width) const;
+        std::size_t byteSize(const glm::ivec2 & size) const;
+
+        gl::GLenum format;
+        gl::GLenum type;
+        int alignment;
+        int rowLength;  ///< in pixels, 0 for the image width
+    };
+
+    GLOBJECTS_API bool isSupported(const Layout & source, const Layout & destination, bool decodeSRGB = false);
+
+    /** Converts an image of size pixels.
+        \param decodeSRGB converts sRGB encoded color components to linear values, requires a conversion to GL_FLOAT
+        \return false if the conversion is not supported
+    */
+    GLOBJECTS_API bool convert(const void * source, const Layout & sourceLayout, void * destination, const Layout & destinationLayout, const glm::ivec2 & size, bool decodeSRGB = false);
+
+    /** Returns the instruction set used by convert(), the best one supported by the processor unless limited.
+    */
+    GLOBJECTS_API InstructionSet instructionSet();
+
+    /** Restricts convert() to the given instruction set and older ones, e.g., to compare against scalar code.
+    */
+    GLOBJECTS_API void limitInstructionSet(InstructionSet instructionSet);
+}
+
+} // namespace globjects
@@ -9,6 +9,8 @@
 #include <globjects/ObjectVisitor.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/BindingRegistry.h"
+#include "registry/MemoryRegistry.h"
 
 #include "Resource.h"
 
@@ -30,6 +32,8 @@ const globjects::AbstractBufferImplementation & implementation()
 namespace globjects
 {
 
+const GLsizeiptr Buffer::DefaultChunkSize = 64 * 1024 * 1024;
+
 void Buffer::hintBindlessImplementation(BindlessImplementation impl)
 {
     ImplementationRegistry::current().initialize(impl);
@@ -67,17 +71,17 @@ void Buffer::accept(ObjectVisitor& visitor)
 
 void Buffer::bind(const GLenum target) const
 {
-    glBindBuffer(target, id());
+    BindingRegistry::current().bindBuffer(target, id());
 }
 
 void Buffer::unbind(const GLenum target)
 {
-    glBindBuffer(target, 0);
+    BindingRegistry::current().bindBuffer(target, 0);
 }
 
 void Buffer::unbind(const GLenum target, const GLuint index)
 {
-    glBindBufferBase(target, index, 0);
+    BindingRegistry::current().bindBufferBase(target, index, 0);
 }
 
 const void * Buffer::map() const
@@ -108,6 +112,9 @@ void Buffer::flushMappedRange(const GLintptr offset, const GLsizeiptr length)
 void Buffer::setData(const GLsizeiptr size, const GLvoid * data, const GLenum usage)
 {
     implementation().setData(this, size, data, usage);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_BUFFER, id(), size);
 }
     
 void Buffer::setSubData(const GLintptr offset, const GLsizeiptr size, const GLvoid * data)
@@ -118,6 +125,9 @@ void Buffer::setSubData(const GLintptr offset, const GLsizeiptr size, const GLvo
 void Buffer::setStorage(const GLsizeiptr size, const GLvoid * data, const MapBufferUsageMask flags)
 {
     implementation().setStorage(this, size, data, flags);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_BUFFER, id(), size);
 }
 
 GLint Buffer::getParameter(const GLenum pname) const
@@ -132,12 +142,12 @@ GLint64 Buffer::getParameter64(const GLenum pname) const
 
 void Buffer::bindBase(const GLenum target, const GLuint index) const
 {
-    glBindBufferBase(target, index, id());
+    BindingRegistry::current().bindBufferBase(target, index, id());
 }
 
 void Buffer::bindRange(const GLenum target, const GLuint index, const GLintptr offset, const GLsizeiptr size) const
 {
-    glBindBufferRange(target, index, id(), offset, size);
+    BindingRegistry::current().bindBufferRange(target, index, id(), offset, size);
 }
 
 void Buffer::copySubData(Buffer * buffer, const GLintptr readOffset, const GLintptr writeOffset, const GLsizeiptr size) const
@@ -156,7 +166,7 @@ void Buffer::copyData(Buffer * buffer, const GLsizeiptr size, const GLenum usage
 {
     assert(buffer != nullptr);
 
-    buffer->setData(static_cast<GLsizei>(size), nullptr, usage);
+    buffer->setData(size, nullptr, usage);
 	copySubData(buffer, 0, 0, size);
 }
 
@@ -195,6 +205,26 @@ void Buffer::getSubData(const GLintptr offset, const GLsizeiptr size, void * dat
     implementation().getBufferSubData(this, offset, size, data);
 }
 
+void Buffer::setSubDataChunked(const GLintptr offset, const GLsizeiptr size, const GLvoid * data, const GLsizeiptr chunkSize)
+{
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+
+    forEachChunk(offset, size, chunkSize, [this, bytes, offset](const GLintptr chunkOffset, const GLsizeiptr chunk)
+    {
+        setSubData(chunkOffset, chunk, bytes + (chunkOffset - offset));
+    });
+}
+
+void Buffer::getSubDataChunked(const GLintptr offset, const GLsizeiptr size, void * data, const GLsizeiptr chunkSize) const
+{
+    unsigned char * bytes = static_cast<unsigned char *>(data);
+
+    forEachChunk(offset, size, chunkSize, [this, bytes, offset](const GLintptr chunkOffset, const GLsizeiptr chunk)
+    {
+        getSubData(chunkOffset, chunk, bytes + (chunkOffset - offset));
+    });
+}
+
 GLenum Buffer::objectType() const
 {
     return GL_BUFFER;
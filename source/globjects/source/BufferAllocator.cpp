@@ -0,0 +1,364 @@
+#include <globjects/BufferAllocator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+
+using namespace gl;
+
+namespace
+{
+
+GLintptr alignUp(const GLintptr offset, const GLsizeiptr alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+const BufferAllocator::Handle BufferAllocator::InvalidHandle = static_cast<BufferAllocator::Handle>(-1);
+
+BufferAllocator::BufferAllocator(const GLsizeiptr pageSize, const GLenum usage)
+: m_pageSize(pageSize)
+, m_usage(usage)
+, m_allocationCount(0)
+, m_allocatedSize(0)
+{
+    assert(pageSize > 0);
+}
+
+BufferAllocator::~BufferAllocator()
+{
+}
+
+BufferAllocator::Handle BufferAllocator::allocate(const GLsizeiptr size, const GLsizeiptr alignment)
+{
+    assert(size > 0);
+    assert(alignment > 0);
+
+    Allocation allocation;
+
+    bool allocated = false;
+    for (std::size_t i = 0; i < m_pages.size() && !allocated; ++i)
+        allocated = allocateInPage(i, size, alignment, allocation);
+
+    if (!allocated)
+    {
+        // pages start at offset zero, which satisfies any alignment
+        allocated = allocateInPage(addPage(std::max(m_pageSize, size)), size, alignment, allocation);
+        assert(allocated);
+    }
+
+    Handle handle;
+
+    if (!m_freeHandles.empty())
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+
+        m_allocations[handle] = allocation;
+    }
+    else
+    {
+        handle = static_cast<Handle>(m_allocations.size());
+        m_allocations.push_back(allocation);
+    }
+
+    ++m_allocationCount;
+    m_allocatedSize += size;
+
+    return handle;
+}
+
+void BufferAllocator::free(const Handle handle)
+{
+    assert(handle < m_allocations.size());
+
+    Allocation & allocation = m_allocations[handle];
+    assert(allocation.live);
+
+    Page & page = m_pages[allocation.page];
+    insertFreeBlock(page, allocation.offset, allocation.size);
+    --page.allocationCount;
+
+    // dedicated pages for oversized allocations are not reused for small ones
+    if (page.allocationCount == 0 && page.size > m_pageSize)
+    {
+        page.buffer = nullptr;
+        page.size = 0;
+        page.freeByOffset.clear();
+        page.freeBySize.clear();
+    }
+
+    allocation.live = false;
+
+    --m_allocationCount;
+    m_allocatedSize -= allocation.size;
+
+    m_freeHandles.push_back(handle);
+}
+
+BufferRange BufferAllocator::range(const Handle handle) const
+{
+    assert(handle < m_allocations.size());
+
+    const Allocation & allocation = m_allocations[handle];
+    assert(allocation.live);
+
+    return BufferRange(m_pages[allocation.page].buffer, allocation.offset, allocation.size);
+}
+
+std::vector<BufferAllocator::Handle> BufferAllocator::defragment()
+{
+    std::vector<Handle> handles;
+    handles.reserve(m_allocationCount);
+
+    for (Handle handle = 0; handle < m_allocations.size(); ++handle)
+    {
+        if (m_allocations[handle].live)
+            handles.push_back(handle);
+    }
+
+    // keeping the current order preserves locality of neighboring allocations
+    std::sort(handles.begin(), handles.end(), [this](const Handle a, const Handle b)
+    {
+        const Allocation & first = m_allocations[a];
+        const Allocation & second = m_allocations[b];
+
+        return first.page < second.page || (first.page == second.page && first.offset < second.offset);
+    });
+
+    std::vector<Page> oldPages;
+    oldPages.swap(m_pages);
+
+    std::size_t current = 0;
+    GLintptr cursor = 0;
+
+    // consecutive allocations that stay adjacent are moved with a single copy
+    struct Copy
+    {
+        Buffer * source;
+        GLintptr readOffset;
+        GLintptr writeOffset;
+        GLsizeiptr size;
+    };
+
+    Copy copy = { nullptr, 0, 0, 0 };
+
+    auto submitCopy = [this, &copy, &current]()
+    {
+        if (copy.size > 0)
+            copy.source->copySubData(m_pages[current].buffer, copy.readOffset, copy.writeOffset, copy.size);
+
+        copy.size = 0;
+    };
+
+    for (const Handle handle : handles)
+    {
+        Allocation & allocation = m_allocations[handle];
+
+        GLintptr offset = alignUp(cursor, allocation.alignment);
+
+        if (m_pages.empty() || offset + allocation.size > m_pages[current].size)
+        {
+            submitCopy();
+
+            if (!m_pages.empty())
+                insertFreeBlock(m_pages[current], cursor, m_pages[current].size - cursor);
+
+            current = addPage(std::max(m_pageSize, allocation.size));
+
+            // the new page is completely free until the pass is finished
+            m_pages[current].freeByOffset.clear();
+            m_pages[current].freeBySize.clear();
+
+            offset = 0;
+        }
+
+        Buffer * source = oldPages[allocation.page].buffer;
+
+        if (copy.size > 0 && copy.source == source && copy.readOffset + copy.size == allocation.offset && copy.writeOffset + copy.size == offset)
+        {
+            copy.size += allocation.size;
+        }
+        else
+        {
+            submitCopy();
+            copy = { source, allocation.offset, offset, allocation.size };
+        }
+
+        allocation.page = current;
+        allocation.offset = offset;
+
+        ++m_pages[current].allocationCount;
+        cursor = offset + allocation.size;
+    }
+
+    submitCopy();
+
+    if (!m_pages.empty() && cursor < m_pages[current].size)
+        insertFreeBlock(m_pages[current], cursor, m_pages[current].size - cursor);
+
+    // the previous pages are released with oldPages
+
+    return handles;
+}
+
+GLsizeiptr BufferAllocator::pageSize() const
+{
+    return m_pageSize;
+}
+
+std::size_t BufferAllocator::pageCount() const
+{
+    return static_cast<std::size_t>(std::count_if(m_pages.begin(), m_pages.end(), [](const Page & page) { return page.buffer != nullptr; }));
+}
+
+std::size_t BufferAllocator::allocationCount() const
+{
+    return m_allocationCount;
+}
+
+GLsizeiptr BufferAllocator::allocatedSize() const
+{
+    return m_allocatedSize;
+}
+
+GLsizeiptr BufferAllocator::reservedSize() const
+{
+    GLsizeiptr size = 0;
+
+    for (const Page & page : m_pages)
+        size += page.size;
+
+    return size;
+}
+
+GLsizeiptr BufferAllocator::uniformBufferAlignment()
+{
+    return static_cast<GLsizeiptr>(getInteger(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT));
+}
+
+GLsizeiptr BufferAllocator::shaderStorageBufferAlignment()
+{
+    return static_cast<GLsizeiptr>(getInteger(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT));
+}
+
+std::size_t BufferAllocator::addPage(const GLsizeiptr size)
+{
+    Page page;
+    page.buffer = new Buffer;
+    page.buffer->setData(size, nullptr, m_usage);
+    page.size = size;
+    page.allocationCount = 0;
+
+    insertFreeBlock(page, 0, size);
+
+    // reuse the slot of a released page, so allocations keep their indices
+    for (std::size_t i = 0; i < m_pages.size(); ++i)
+    {
+        if (m_pages[i].buffer == nullptr)
+        {
+            m_pages[i] = page;
+            return i;
+        }
+    }
+
+    m_pages.push_back(page);
+
+    return m_pages.size() - 1;
+}
+
+bool BufferAllocator::allocateInPage(const std::size_t pageIndex, const GLsizeiptr size, const GLsizeiptr alignment, Allocation & allocation)
+{
+    Page & page = m_pages[pageIndex];
+
+    // best fit: the smallest block that still fits after alignment
+    for (auto it = page.freeBySize.lower_bound(size); it != page.freeBySize.end(); ++it)
+    {
+        const GLsizeiptr blockSize = it->first;
+        const GLintptr blockOffset = it->second;
+        const GLintptr offset = alignUp(blockOffset, alignment);
+
+        if (offset + size > blockOffset + blockSize)
+            continue;
+
+        removeFreeBlock(page, blockOffset, blockSize);
+
+        if (offset > blockOffset)
+            insertFreeBlock(page, blockOffset, offset - blockOffset);
+
+        if (offset + size < blockOffset + blockSize)
+            insertFreeBlock(page, offset + size, blockOffset + blockSize - (offset + size));
+
+        ++page.allocationCount;
+
+        allocation.page = pageIndex;
+        allocation.offset = offset;
+        allocation.size = size;
+        allocation.alignment = alignment;
+        allocation.live = true;
+
+        return true;
+    }
+
+    return false;
+}
+
+void BufferAllocator::insertFreeBlock(Page & page, GLintptr offset, GLsizeiptr size)
+{
+    auto next = page.freeByOffset.lower_bound(offset);
+
+    // merge with the preceding and following free blocks
+    if (next != page.freeByOffset.begin())
+    {
+        const auto previous = std::prev(next);
+
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+
+            removeFreeBlock(page, previous->first, previous->second);
+            next = page.freeByOffset.lower_bound(offset);
+        }
+    }
+
+    if (next != page.freeByOffset.end() && next->first == offset + size)
+    {
+        const GLsizeiptr nextSize = next->second;
+
+        removeFreeBlock(page, next->first, nextSize);
+        size += nextSize;
+    }
+
+    page.freeByOffset.emplace(offset, size);
+    page.freeBySize.emplace(size, offset);
+}
+
+void BufferAllocator::removeFreeBlock(Page & page, const GLintptr offset, const GLsizeiptr size)
+{
+    page.freeByOffset.erase(offset);
+
+    const auto range = page.freeBySize.equal_range(size);
+
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == offset)
+        {
+            page.freeBySize.erase(it);
+            return;
+        }
+    }
+}
+
+} // namespace globjects
@@ -0,0 +1,62 @@
+#include <globjects/BufferRange.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <globjects/Buffer.h>
+
+using namespace gl;
+
+namespace globjects
+{
+
+BufferRange::BufferRange()
+: buffer(nullptr)
+, offset(0)
+, size(0)
+{
+}
+
+BufferRange::BufferRange(Buffer * buffer, const GLintptr offset, const GLsizeiptr size)
+: buffer(buffer)
+, offset(offset)
+, size(size)
+{
+}
+
+bool BufferRange::isValid() const
+{
+    return buffer != nullptr;
+}
+
+void BufferRange::setSubData(const GLintptr offset, const GLsizeiptr size, const GLvoid * data) const
+{
+    assert(buffer != nullptr);
+    assert(offset + size <= this->size);
+
+    buffer->setSubData(this->offset + offset, size, data);
+}
+
+void BufferRange::getSubData(const GLintptr offset, const GLsizeiptr size, void * data) const
+{
+    assert(buffer != nullptr);
+    assert(offset + size <= this->size);
+
+    buffer->getSubData(this->offset + offset, size, data);
+}
+
+void BufferRange::bindRange(const GLenum target, const GLuint index) const
+{
+    assert(buffer != nullptr);
+
+    buffer->bindRange(target, index, offset, size);
+}
+
+void BufferRange::copyTo(const BufferRange & other) const
+{
+    assert(buffer != nullptr && other.buffer != nullptr);
+
+    buffer->copySubData(other.buffer, offset, other.offset, std::min(size, other.size));
+}
+
+} // namespace globjects
@@ -0,0 +1,192 @@
+#include <globjects/BufferUpdater.h>
+
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/StreamingBuffer.h>
+
+using namespace gl;
+
+namespace
+{
+
+// a buffer updated at least every other frame on average is streamed
+const float c_frequentInterval = 2.0f;
+const float c_intervalWeight = 0.25f;
+const float c_initialInterval = 1000.0f; // until a second update was seen
+
+} // namespace
+
+
+namespace globjects
+{
+
+BufferUpdater::BufferUpdater(const GLsizeiptr stagingSize, const GLsizeiptr smallPatchSize)
+: m_staging(new StreamingBuffer(stagingSize))
+, m_smallPatchSize(smallPatchSize)
+, m_frame(0)
+{
+    resetStats();
+}
+
+BufferUpdater::~BufferUpdater()
+{
+}
+
+BufferUpdater::Strategy BufferUpdater::update(Buffer * buffer, const GLintptr offset, const GLsizeiptr size, const void * data)
+{
+    assert(buffer != nullptr);
+    assert(size > 0);
+
+    Pattern & pattern = track(buffer);
+    assert(offset + size <= pattern.bufferSize);
+
+    record(pattern, m_frame);
+
+    // larger updates would make the ring wait for frames still in flight
+    pattern.strategy = select(pattern, offset, size, m_smallPatchSize, m_staging->capacity() / 4);
+
+    switch (pattern.strategy)
+    {
+    case Strategy::Orphan:
+        buffer->setData(size, data, pattern.usage);
+
+        ++m_stats.orphanCount;
+        m_stats.orphanBytes += size;
+        break;
+
+    case Strategy::StreamingWrite:
+        {
+            const StreamingBuffer::Allocation allocation = m_staging->write(data, size);
+            m_staging->buffer()->copySubData(buffer, allocation.offset, offset, size);
+        }
+
+        ++m_stats.streamingWriteCount;
+        m_stats.streamingWriteBytes += size;
+        break;
+
+    case Strategy::SubData:
+        buffer->setSubData(offset, size, data);
+
+        ++m_stats.subDataCount;
+        m_stats.subDataBytes += size;
+        break;
+    }
+
+    return pattern.strategy;
+}
+
+void BufferUpdater::endFrame()
+{
+    m_staging->fence();
+
+    ++m_frame;
+
+    for (auto it = m_tracked.begin(); it != m_tracked.end();)
+    {
+        if (it->second.buffer->refCounter() == 1)
+            it = m_tracked.erase(it);
+        else
+            ++it;
+    }
+
+    m_stats.trackedBuffers = m_tracked.size();
+}
+
+void BufferUpdater::forget(Buffer * buffer)
+{
+    m_tracked.erase(buffer);
+
+    m_stats.trackedBuffers = m_tracked.size();
+}
+
+const BufferUpdater::Pattern * BufferUpdater::pattern(Buffer * buffer) const
+{
+    const auto it = m_tracked.find(buffer);
+
+    return it != m_tracked.end() ? &it->second.pattern : nullptr;
+}
+
+const BufferUpdater::Stats & BufferUpdater::stats() const
+{
+    return m_stats;
+}
+
+void BufferUpdater::resetStats()
+{
+    m_stats.subDataCount = 0;
+    m_stats.orphanCount = 0;
+    m_stats.streamingWriteCount = 0;
+
+    m_stats.subDataBytes = 0;
+    m_stats.orphanBytes = 0;
+    m_stats.streamingWriteBytes = 0;
+
+    m_stats.trackedBuffers = m_tracked.size();
+}
+
+StreamingBuffer * BufferUpdater::staging() const
+{
+    return m_staging;
+}
+
+BufferUpdater::Strategy BufferUpdater::select(const Pattern & pattern, const GLintptr offset, const GLsizeiptr size, const GLsizeiptr smallPatchSize, const GLsizeiptr maxStreamingSize)
+{
+    if (offset == 0 && size == pattern.bufferSize && pattern.orphanable)
+        return Strategy::Orphan;
+
+    if (size > maxStreamingSize)
+        return Strategy::SubData;
+
+    if (pattern.interval <= c_frequentInterval || size > smallPatchSize)
+        return Strategy::StreamingWrite;
+
+    return Strategy::SubData;
+}
+
+void BufferUpdater::record(Pattern & pattern, const unsigned long long frame)
+{
+    // several updates within one frame count as an interval of zero
+    const float interval = static_cast<float>(frame - pattern.lastFrame);
+
+    if (pattern.updateCount == 1)
+        pattern.interval = interval;
+    else if (pattern.updateCount > 1)
+        pattern.interval += c_intervalWeight * (interval - pattern.interval);
+
+    ++pattern.updateCount;
+    pattern.lastFrame = frame;
+}
+
+BufferUpdater::Pattern & BufferUpdater::track(Buffer * buffer)
+{
+    const auto it = m_tracked.find(buffer);
+
+    if (it != m_tracked.end())
+        return it->second.pattern;
+
+    Tracked & tracked = m_tracked[buffer];
+    tracked.buffer = buffer;
+
+    Pattern & pattern = tracked.pattern;
+
+    // queried once, the updater assumes to be the only one to reallocate the buffer
+    pattern.bufferSize = static_cast<GLsizeiptr>(buffer->getParameter64(GL_BUFFER_SIZE));
+    pattern.usage = static_cast<GLenum>(buffer->getParameter(GL_BUFFER_USAGE));
+    pattern.orphanable = !hasExtension(GLextension::GL_ARB_buffer_storage) || buffer->getParameter(GL_BUFFER_IMMUTABLE_STORAGE) == 0;
+
+    pattern.updateCount = 0;
+    pattern.lastFrame = 0;
+    pattern.interval = c_initialInterval;
+    pattern.strategy = Strategy::SubData;
+
+    m_stats.trackedBuffers = m_tracked.size();
+
+    return pattern;
+}
+
+} // namespace globjects
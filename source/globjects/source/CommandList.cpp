@@ -0,0 +1,567 @@
+#include <globjects/CommandList.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/State.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+
+using namespace gl;
+
+namespace globjects
+{
+
+enum class CommandList::Opcode : unsigned int
+{
+    UseProgram
+,   SetUniform
+,   SetNamedUniform
+,   BindActiveTexture
+,   BindBufferBase
+,   BindBufferRange
+,   ApplyState
+,   DrawArrays
+,   DrawArraysInstanced
+,   DrawArraysInstancedBaseInstance
+,   DrawArraysIndirect
+,   MultiDrawArraysIndirect
+,   DrawElements
+,   DrawElementsBaseVertex
+,   DrawElementsInstanced
+,   DrawElementsInstancedBaseInstance
+,   DrawElementsInstancedBaseVertex
+,   DrawElementsInstancedBaseVertexBaseInstance
+,   MultiDrawElementsIndirect
+,   DrawRangeElements
+,   DrawRangeElementsBaseVertex
+,   DispatchCompute
+,   DispatchComputeGroupSize
+};
+
+} // namespace globjects
+
+
+namespace
+{
+
+using namespace globjects;
+
+struct CommandHeader
+{
+    unsigned int opcode;
+    unsigned int size; // of the command following this header
+};
+
+struct ProgramCommand
+{
+    const Program * program;
+};
+
+struct UniformCommand
+{
+    Program * program;
+    GLint location;
+    void (*setter)(Program * program, GLint location, const void * value);
+    // followed by the value
+};
+
+struct NamedUniformCommand
+{
+    Program * program;
+    void (*setter)(Program * program, const char * name, const void * value);
+    unsigned int valueSize;
+    // followed by the value and the null-terminated name
+};
+
+struct TextureCommand
+{
+    const Texture * texture;
+    GLenum unit;
+};
+
+struct BufferCommand
+{
+    const Buffer * buffer;
+    GLenum target;
+    GLuint index;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+
+struct StateCommand
+{
+    State * state;
+};
+
+struct DrawArraysCommand
+{
+    const VertexArray * vao;
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+    GLsizei instanceCount;
+    GLuint baseInstance;
+};
+
+struct DrawElementsCommand
+{
+    const VertexArray * vao;
+    const void * indices;
+    GLenum mode;
+    GLsizei count;
+    GLenum type;
+    GLsizei instanceCount;
+    GLint baseVertex;
+    GLuint baseInstance;
+    GLuint start;
+    GLuint end;
+};
+
+struct DrawIndirectCommand
+{
+    const VertexArray * vao;
+    const void * indirect;
+    GLenum mode;
+    GLenum type;
+    GLsizei drawCount;
+    GLsizei stride;
+};
+
+struct DispatchCommand
+{
+    Program * program;
+    GLuint numGroups[3];
+    GLuint groupSizes[3];
+};
+
+// the arena is not aligned for the commands, so they are copied out
+template <typename Command>
+Command read(const unsigned char * data)
+{
+    Command command;
+    std::memcpy(&command, data, sizeof(Command));
+
+    return command;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+CommandList::CommandList()
+: m_count(0)
+{
+}
+
+CommandList::~CommandList()
+{
+}
+
+void CommandList::use(const Program * program)
+{
+    assert(program != nullptr);
+
+    const ProgramCommand command = { program };
+    record(Opcode::UseProgram, &command, sizeof(command));
+    keep(program);
+}
+
+void CommandList::bindActive(const Texture * texture, const GLenum unit)
+{
+    assert(texture != nullptr);
+
+    const TextureCommand command = { texture, unit };
+    record(Opcode::BindActiveTexture, &command, sizeof(command));
+    keep(texture);
+}
+
+void CommandList::bindBase(const Buffer * buffer, const GLenum target, const GLuint index)
+{
+    assert(buffer != nullptr);
+
+    const BufferCommand command = { buffer, target, index, 0, 0 };
+    record(Opcode::BindBufferBase, &command, sizeof(command));
+    keep(buffer);
+}
+
+void CommandList::bindRange(const Buffer * buffer, const GLenum target, const GLuint index, const GLintptr offset, const GLsizeiptr size)
+{
+    assert(buffer != nullptr);
+
+    const BufferCommand command = { buffer, target, index, offset, size };
+    record(Opcode::BindBufferRange, &command, sizeof(command));
+    keep(buffer);
+}
+
+void CommandList::apply(State * state)
+{
+    assert(state != nullptr);
+
+    const StateCommand command = { state };
+    record(Opcode::ApplyState, &command, sizeof(command));
+    keep(state);
+}
+
+void CommandList::drawArrays(const VertexArray * vao, const GLenum mode, const GLint first, const GLsizei count)
+{
+    const DrawArraysCommand command = { vao, mode, first, count, 1, 0 };
+    record(Opcode::DrawArrays, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawArraysInstanced(const VertexArray * vao, const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount)
+{
+    const DrawArraysCommand command = { vao, mode, first, count, instanceCount, 0 };
+    record(Opcode::DrawArraysInstanced, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawArraysInstancedBaseInstance(const VertexArray * vao, const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount, const GLuint baseInstance)
+{
+    const DrawArraysCommand command = { vao, mode, first, count, instanceCount, baseInstance };
+    record(Opcode::DrawArraysInstancedBaseInstance, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawArraysIndirect(const VertexArray * vao, const GLenum mode, const void * indirect)
+{
+    const DrawIndirectCommand command = { vao, indirect, mode, GL_NONE, 1, 0 };
+    record(Opcode::DrawArraysIndirect, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::multiDrawArraysIndirect(const VertexArray * vao, const GLenum mode, const void * indirect, const GLsizei drawCount, const GLsizei stride)
+{
+    const DrawIndirectCommand command = { vao, indirect, mode, GL_NONE, drawCount, stride };
+    record(Opcode::MultiDrawArraysIndirect, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElements(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, 1, 0, 0, 0, 0 };
+    record(Opcode::DrawElements, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElementsBaseVertex(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLint baseVertex)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, 1, baseVertex, 0, 0, 0 };
+    record(Opcode::DrawElementsBaseVertex, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElementsInstanced(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, instanceCount, 0, 0, 0, 0 };
+    record(Opcode::DrawElementsInstanced, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElementsInstancedBaseInstance(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLuint baseInstance)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, instanceCount, 0, baseInstance, 0, 0 };
+    record(Opcode::DrawElementsInstancedBaseInstance, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElementsInstancedBaseVertex(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLint baseVertex)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, instanceCount, baseVertex, 0, 0, 0 };
+    record(Opcode::DrawElementsInstancedBaseVertex, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawElementsInstancedBaseVertexBaseInstance(const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLint baseVertex, const GLuint baseInstance)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, instanceCount, baseVertex, baseInstance, 0, 0 };
+    record(Opcode::DrawElementsInstancedBaseVertexBaseInstance, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::multiDrawElementsIndirect(const VertexArray * vao, const GLenum mode, const GLenum type, const void * indirect, const GLsizei drawCount, const GLsizei stride)
+{
+    const DrawIndirectCommand command = { vao, indirect, mode, type, drawCount, stride };
+    record(Opcode::MultiDrawElementsIndirect, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawRangeElements(const VertexArray * vao, const GLenum mode, const GLuint start, const GLuint end, const GLsizei count, const GLenum type, const void * indices)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, 1, 0, 0, start, end };
+    record(Opcode::DrawRangeElements, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::drawRangeElementsBaseVertex(const VertexArray * vao, const GLenum mode, const GLuint start, const GLuint end, const GLsizei count, const GLenum type, const void * indices, const GLint baseVertex)
+{
+    const DrawElementsCommand command = { vao, indices, mode, count, type, 1, baseVertex, 0, start, end };
+    record(Opcode::DrawRangeElementsBaseVertex, &command, sizeof(command));
+    keep(vao);
+}
+
+void CommandList::dispatchCompute(Program * program, const GLuint numGroupsX, const GLuint numGroupsY, const GLuint numGroupsZ)
+{
+    assert(program != nullptr);
+
+    const DispatchCommand command = { program, { numGroupsX, numGroupsY, numGroupsZ }, { 0, 0, 0 } };
+    record(Opcode::DispatchCompute, &command, sizeof(command));
+    keep(program);
+}
+
+void CommandList::dispatchComputeGroupSize(Program * program, const GLuint numGroupsX, const GLuint numGroupsY, const GLuint numGroupsZ, const GLuint groupSizeX, const GLuint groupSizeY, const GLuint groupSizeZ)
+{
+    assert(program != nullptr);
+
+    const DispatchCommand command = { program, { numGroupsX, numGroupsY, numGroupsZ }, { groupSizeX, groupSizeY, groupSizeZ } };
+    record(Opcode::DispatchComputeGroupSize, &command, sizeof(command));
+    keep(program);
+}
+
+void CommandList::append(const CommandList & other)
+{
+    m_commands.insert(m_commands.end(), other.m_commands.begin(), other.m_commands.end());
+    m_objects.insert(m_objects.end(), other.m_objects.begin(), other.m_objects.end());
+    m_count += other.m_count;
+}
+
+void CommandList::execute() const
+{
+    const unsigned char * current = m_commands.data();
+    const unsigned char * end = current + m_commands.size();
+
+    while (current < end)
+    {
+        const CommandHeader header = read<CommandHeader>(current);
+        current += sizeof(CommandHeader);
+
+        switch (static_cast<Opcode>(header.opcode))
+        {
+        case Opcode::UseProgram:
+            read<ProgramCommand>(current).program->use();
+            break;
+
+        case Opcode::SetUniform:
+            {
+                const UniformCommand command = read<UniformCommand>(current);
+                command.setter(command.program, command.location, current + sizeof(UniformCommand));
+            }
+            break;
+
+        case Opcode::SetNamedUniform:
+            {
+                const NamedUniformCommand command = read<NamedUniformCommand>(current);
+                const unsigned char * value = current + sizeof(NamedUniformCommand);
+
+                command.setter(command.program, reinterpret_cast<const char *>(value + command.valueSize), value);
+            }
+            break;
+
+        case Opcode::BindActiveTexture:
+            {
+                const TextureCommand command = read<TextureCommand>(current);
+                command.texture->bindActive(command.unit);
+            }
+            break;
+
+        case Opcode::BindBufferBase:
+            {
+                const BufferCommand command = read<BufferCommand>(current);
+                command.buffer->bindBase(command.target, command.index);
+            }
+            break;
+
+        case Opcode::BindBufferRange:
+            {
+                const BufferCommand command = read<BufferCommand>(current);
+                command.buffer->bindRange(command.target, command.index, command.offset, command.size);
+            }
+            break;
+
+        case Opcode::ApplyState:
+            read<StateCommand>(current).state->apply();
+            break;
+
+        case Opcode::DrawArrays:
+        case Opcode::DrawArraysInstanced:
+        case Opcode::DrawArraysInstancedBaseInstance:
+            {
+                const DrawArraysCommand c = read<DrawArraysCommand>(current);
+
+                switch (static_cast<Opcode>(header.opcode))
+                {
+                case Opcode::DrawArrays:
+                    c.vao->drawArrays(c.mode, c.first, c.count);
+                    break;
+                case Opcode::DrawArraysInstanced:
+                    c.vao->drawArraysInstanced(c.mode, c.first, c.count, c.instanceCount);
+                    break;
+                default:
+                    c.vao->drawArraysInstancedBaseInstance(c.mode, c.first, c.count, c.instanceCount, c.baseInstance);
+                    break;
+                }
+            }
+            break;
+
+        case Opcode::DrawArraysIndirect:
+        case Opcode::MultiDrawArraysIndirect:
+        case Opcode::MultiDrawElementsIndirect:
+            {
+                const DrawIndirectCommand c = read<DrawIndirectCommand>(current);
+
+                switch (static_cast<Opcode>(header.opcode))
+                {
+                case Opcode::DrawArraysIndirect:
+                    c.vao->drawArraysIndirect(c.mode, c.indirect);
+                    break;
+                case Opcode::MultiDrawArraysIndirect:
+                    c.vao->multiDrawArraysIndirect(c.mode, c.indirect, c.drawCount, c.stride);
+                    break;
+                default:
+                    c.vao->multiDrawElementsIndirect(c.mode, c.type, c.indirect, c.drawCount, c.stride);
+                    break;
+                }
+            }
+            break;
+
+        case Opcode::DrawElements:
+        case Opcode::DrawElementsBaseVertex:
+        case Opcode::DrawElementsInstanced:
+        case Opcode::DrawElementsInstancedBaseInstance:
+        case Opcode::DrawElementsInstancedBaseVertex:
+        case Opcode::DrawElementsInstancedBaseVertexBaseInstance:
+        case Opcode::DrawRangeElements:
+        case Opcode::DrawRangeElementsBaseVertex:
+            {
+                const DrawElementsCommand c = read<DrawElementsCommand>(current);
+
+                switch (static_cast<Opcode>(header.opcode))
+                {
+                case Opcode::DrawElements:
+                    c.vao->drawElements(c.mode, c.count, c.type, c.indices);
+                    break;
+                case Opcode::DrawElementsBaseVertex:
+                    c.vao->drawElementsBaseVertex(c.mode, c.count, c.type, c.indices, c.baseVertex);
+                    break;
+                case Opcode::DrawElementsInstanced:
+                    c.vao->drawElementsInstanced(c.mode, c.count, c.type, c.indices, c.instanceCount);
+                    break;
+                case Opcode::DrawElementsInstancedBaseInstance:
+                    c.vao->drawElementsInstancedBaseInstance(c.mode, c.count, c.type, c.indices, c.instanceCount, c.baseInstance);
+                    break;
+                case Opcode::DrawElementsInstancedBaseVertex:
+                    c.vao->drawElementsInstancedBaseVertex(c.mode, c.count, c.type, c.indices, c.instanceCount, c.baseVertex);
+                    break;
+                case Opcode::DrawElementsInstancedBaseVertexBaseInstance:
+                    c.vao->drawElementsInstancedBaseVertexBaseInstance(c.mode, c.count, c.type, c.indices, c.instanceCount, c.baseVertex, c.baseInstance);
+                    break;
+                case Opcode::DrawRangeElements:
+                    c.vao->drawRangeElements(c.mode, c.start, c.end, c.count, c.type, c.indices);
+                    break;
+                default:
+                    c.vao->drawRangeElementsBaseVertex(c.mode, c.start, c.end, c.count, c.type, c.indices, c.baseVertex);
+                    break;
+                }
+            }
+            break;
+
+        case Opcode::DispatchCompute:
+            {
+                const DispatchCommand c = read<DispatchCommand>(current);
+                c.program->dispatchCompute(c.numGroups[0], c.numGroups[1], c.numGroups[2]);
+            }
+            break;
+
+        case Opcode::DispatchComputeGroupSize:
+            {
+                const DispatchCommand c = read<DispatchCommand>(current);
+                c.program->dispatchComputeGroupSize(c.numGroups[0], c.numGroups[1], c.numGroups[2], c.groupSizes[0], c.groupSizes[1], c.groupSizes[2]);
+            }
+            break;
+        }
+
+        current += header.size;
+    }
+}
+
+void CommandList::clear()
+{
+    m_commands.clear();
+    m_objects.clear();
+    m_count = 0;
+}
+
+bool CommandList::isEmpty() const
+{
+    return m_count == 0;
+}
+
+std::size_t CommandList::count() const
+{
+    return m_count;
+}
+
+std::size_t CommandList::byteSize() const
+{
+    return m_commands.size();
+}
+
+void CommandList::record(const Opcode opcode, const void * command, const std::size_t size, const void * data, const std::size_t dataSize)
+{
+    const CommandHeader header = { static_cast<unsigned int>(opcode), static_cast<unsigned int>(size + dataSize) };
+
+    const std::size_t offset = m_commands.size();
+    m_commands.resize(offset + sizeof(CommandHeader) + size + dataSize);
+
+    unsigned char * target = m_commands.data() + offset;
+    std::memcpy(target, &header, sizeof(CommandHeader));
+    std::memcpy(target + sizeof(CommandHeader), command, size);
+
+    if (dataSize > 0)
+        std::memcpy(target + sizeof(CommandHeader) + size, data, dataSize);
+
+    ++m_count;
+}
+
+void CommandList::recordUniform(Program * program, const GLint location, const UniformSetter setter, const void * value, const std::size_t size)
+{
+    assert(program != nullptr);
+
+    const UniformCommand command = { program, location, setter };
+    record(Opcode::SetUniform, &command, sizeof(command), value, size);
+    keep(program);
+}
+
+void CommandList::recordUniform(Program * program, const std::string & name, const NamedUniformSetter setter, const void * value, const std::size_t size)
+{
+    assert(program != nullptr);
+
+    // value and name (including its terminator) are stored back to back
+    std::vector<unsigned char> data(size + name.size() + 1);
+    std::memcpy(data.data(), value, size);
+    std::memcpy(data.data() + size, name.c_str(), name.size() + 1);
+
+    const NamedUniformCommand command = { program, setter, static_cast<unsigned int>(size) };
+    record(Opcode::SetNamedUniform, &command, sizeof(command), data.data(), data.size());
+    keep(program);
+}
+
+void CommandList::keep(const Referenced * object)
+{
+    assert(object != nullptr);
+
+    // consecutive commands often refer to the same object
+    if (!m_objects.empty() && m_objects.back() == object)
+        return;
+
+    m_objects.push_back(object);
+}
+
+} // namespace globjects
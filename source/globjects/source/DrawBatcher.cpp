@@ -0,0 +1,157 @@
+#include <globjects/DrawBatcher.h>
+
+#include <cassert>
+#include <cstdint>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/State.h>
+#include <globjects/VertexArray.h>
+
+using namespace gl;
+
+namespace
+{
+
+GLuint indexSize(const GLenum type)
+{
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+DrawBatcher::DrawBatcher()
+: m_indirectBuffer(new Buffer)
+{
+}
+
+DrawBatcher::~DrawBatcher()
+{
+}
+
+GLuint DrawBatcher::drawElementsBaseVertex(Program * program, State * state, const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLint baseVertex)
+{
+    const DrawElementsIndirectCommand command = { static_cast<GLuint>(count), 1, 0, baseVertex, static_cast<GLuint>(m_commands.size()) };
+
+    return add(program, state, vao, mode, type, indices, command);
+}
+
+GLuint DrawBatcher::drawElementsInstancedBaseVertexBaseInstance(Program * program, State * state, const VertexArray * vao, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLint baseVertex, const GLuint baseInstance)
+{
+    const DrawElementsIndirectCommand command = { static_cast<GLuint>(count), static_cast<GLuint>(instanceCount), 0, baseVertex, baseInstance };
+
+    return add(program, state, vao, mode, type, indices, command);
+}
+
+GLuint DrawBatcher::add(Program * program, State * state, const VertexArray * vao, const GLenum mode, const GLenum type, const void * indices, const DrawElementsIndirectCommand & command)
+{
+    assert(program != nullptr);
+    assert(vao != nullptr);
+
+    const std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(indices);
+    assert(offset % indexSize(type) == 0);
+
+    const GLuint drawIndex = static_cast<GLuint>(m_commands.size());
+
+    m_commands.push_back(command);
+    m_commands.back().firstIndex = static_cast<GLuint>(offset / indexSize(type));
+
+    if (!m_runs.empty())
+    {
+        Run & run = m_runs.back();
+
+        if (run.program == program && run.state == state && run.vao == vao && run.mode == mode && run.type == type)
+        {
+            ++run.count;
+
+            return drawIndex;
+        }
+    }
+
+    const Run run = { program, state, vao, mode, type, m_commands.size() - 1, 1 };
+    m_runs.push_back(run);
+
+    return drawIndex;
+}
+
+void DrawBatcher::flush()
+{
+    if (m_commands.empty())
+        return;
+
+    const bool multiDrawIndirect = hasExtension(GLextension::GL_ARB_multi_draw_indirect);
+    const GLsizei stride = static_cast<GLsizei>(sizeof(DrawElementsIndirectCommand));
+
+    if (multiDrawIndirect)
+    {
+        // orphan the previous storage, so the upload does not wait for pending draws
+        m_indirectBuffer->setData(m_commands, GL_STREAM_DRAW);
+        m_indirectBuffer->bind(GL_DRAW_INDIRECT_BUFFER);
+    }
+
+    const Run * previous = nullptr;
+
+    for (const Run & run : m_runs)
+    {
+        if (!previous || previous->program != run.program)
+            run.program->use();
+
+        if (run.state && (!previous || previous->state != run.state))
+            run.state->apply();
+
+        if (multiDrawIndirect)
+        {
+            const void * indirect = reinterpret_cast<const void *>(run.first * sizeof(DrawElementsIndirectCommand));
+
+            run.vao->multiDrawElementsIndirect(run.mode, run.type, indirect, static_cast<GLsizei>(run.count), stride);
+        }
+        else
+        {
+            for (std::size_t i = run.first; i < run.first + run.count; ++i)
+            {
+                const DrawElementsIndirectCommand & command = m_commands[i];
+                const void * indices = reinterpret_cast<const void *>(static_cast<std::uintptr_t>(command.firstIndex) * indexSize(run.type));
+
+                run.vao->drawElementsInstancedBaseVertexBaseInstance(run.mode, command.count, run.type, indices, command.instanceCount, command.baseVertex, command.baseInstance);
+            }
+        }
+
+        previous = &run;
+    }
+
+    m_commands.clear();
+    m_runs.clear();
+}
+
+std::size_t DrawBatcher::pendingDraws() const
+{
+    return m_commands.size();
+}
+
+std::size_t DrawBatcher::pendingRuns() const
+{
+    return m_runs.size();
+}
+
+Buffer * DrawBatcher::indirectBuffer() const
+{
+    return m_indirectBuffer;
+}
+
+} // namespace globjects
@@ -0,0 +1,251 @@
+#include <globjects/FenceScheduler.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Sync.h>
+
+using namespace gl;
+
+namespace
+{
+
+const GLuint64 c_waitTimeout = 1000000; // 1 ms, in nanoseconds
+
+} // namespace
+
+
+namespace globjects
+{
+
+FenceScheduler::FenceScheduler()
+: m_nextId(0)
+, m_signaledId(0)
+, m_stopWaiting(false)
+, m_flushPending(false)
+{
+}
+
+FenceScheduler::~FenceScheduler()
+{
+    stopWaitThread();
+}
+
+void FenceScheduler::after(Sync * fence, const Callback & callback)
+{
+    assert(fence != nullptr);
+
+    push(fence, callback);
+}
+
+void FenceScheduler::afterCurrentFrame(const Callback & callback)
+{
+    m_frameCallbacks.push_back(callback);
+}
+
+std::size_t FenceScheduler::poll()
+{
+    fenceFrame();
+
+    const bool waitThread = hasWaitThread();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // fences only become visible to the wait thread's context once they are flushed
+        if (waitThread && m_flushPending)
+            glFlush();
+
+        m_flushPending = false;
+    }
+
+    std::size_t count = 0;
+
+    while (true)
+    {
+        Continuation continuation;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_continuations.empty())
+                break;
+
+            if (waitThread && m_continuations.front().id >= m_signaledId)
+                break;
+
+            if (!waitThread && !isSignaled(m_continuations.front().fence, false))
+                break;
+
+            continuation = m_continuations.front();
+            m_continuations.pop_front();
+        }
+
+        // callbacks may schedule further continuations
+        if (continuation.callback)
+            continuation.callback();
+
+        ++count;
+    }
+
+    return count;
+}
+
+void FenceScheduler::finish()
+{
+    fenceFrame();
+
+    while (true)
+    {
+        Continuation continuation;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_continuations.empty())
+                break;
+
+            continuation = m_continuations.front();
+            m_continuations.pop_front();
+        }
+
+        isSignaled(continuation.fence, true);
+
+        if (continuation.callback)
+            continuation.callback();
+    }
+}
+
+void FenceScheduler::startWaitThread(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent)
+{
+    assert(!hasWaitThread());
+
+    m_stopWaiting = false;
+
+    m_waitThread = std::thread([this, makeCurrent, doneCurrent]()
+    {
+        if (makeCurrent)
+            makeCurrent();
+
+        waitLoop();
+
+        if (doneCurrent)
+            doneCurrent();
+    });
+}
+
+void FenceScheduler::stopWaitThread()
+{
+    if (!hasWaitThread())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopWaiting = true;
+    }
+
+    m_condition.notify_one();
+    m_waitThread.join();
+}
+
+bool FenceScheduler::hasWaitThread() const
+{
+    return m_waitThread.joinable();
+}
+
+std::size_t FenceScheduler::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_continuations.size() + m_frameCallbacks.size();
+}
+
+bool FenceScheduler::isSignaled(Sync * fence, const bool wait)
+{
+    // consecutive continuations often share a fence, e.g., all callbacks of a frame
+    if (m_lastSignaled == fence)
+        return true;
+
+    GLenum result = fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+    while (wait && result == GL_TIMEOUT_EXPIRED)
+        result = fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, c_waitTimeout);
+
+    // GL_WAIT_FAILED is treated as passed, otherwise the queue would be stuck
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    m_lastSignaled = fence;
+
+    return true;
+}
+
+void FenceScheduler::fenceFrame()
+{
+    if (m_frameCallbacks.empty())
+        return;
+
+    // one fence serves all callbacks of the frame
+    ref_ptr<Sync> fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+    for (const Callback & callback : m_frameCallbacks)
+        push(fence, callback);
+
+    m_frameCallbacks.clear();
+}
+
+void FenceScheduler::push(Sync * fence, const Callback & callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Continuation continuation;
+        continuation.id = m_nextId++;
+        continuation.fence = fence;
+        continuation.callback = callback;
+
+        m_continuations.push_back(continuation);
+        m_flushPending = true;
+    }
+
+    m_condition.notify_one();
+}
+
+void FenceScheduler::waitLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopWaiting)
+    {
+        // continuations are signaled in order, so only the oldest unsignaled one is waited for
+        const auto next = std::find_if(m_continuations.begin(), m_continuations.end(), [this](const Continuation & continuation)
+        {
+            return continuation.id >= m_signaledId;
+        });
+
+        if (next == m_continuations.end())
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        const unsigned long long id = next->id;
+        ref_ptr<Sync> fence = next->fence;
+
+        lock.unlock();
+
+        const GLenum result = fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, c_waitTimeout);
+
+        lock.lock();
+
+        if (result != GL_TIMEOUT_EXPIRED)
+            m_signaledId = std::max(m_signaledId, id + 1);
+    }
+}
+
+} // namespace globjects
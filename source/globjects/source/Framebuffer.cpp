@@ -17,6 +17,7 @@
 
 #include "registry/ImplementationRegistry.h"
 #include "registry/ObjectRegistry.h"
+#include "registry/BindingRegistry.h"
 
 #include "implementations/AbstractFramebufferImplementation.h"
 
@@ -75,22 +76,22 @@ void Framebuffer::accept(ObjectVisitor & visitor)
 
 void Framebuffer::bind() const
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, id());
+    BindingRegistry::current().bindFramebuffer(GL_FRAMEBUFFER, id());
 }
 
 void Framebuffer::bind(const GLenum target) const
 {
-    glBindFramebuffer(target, id());
+    BindingRegistry::current().bindFramebuffer(target, id());
 }
 
 void Framebuffer::unbind()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    BindingRegistry::current().bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::unbind(const GLenum target)
 {
-    glBindFramebuffer(target, 0);
+    BindingRegistry::current().bindFramebuffer(target, 0);
 }
 
 void Framebuffer::setParameter(const GLenum pname, const GLint param)
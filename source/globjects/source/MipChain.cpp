@@ -0,0 +1,433 @@
+#include <globjects/MipChain.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+#include "pixelkernels.h"
+
+using namespace gl;
+
+namespace
+{
+
+const double c_pi = 3.14159265358979323846;
+
+// filter radius in destination pixels and window shape, as used by common texture tools
+const double c_kaiserWidth = 3.0;
+const double c_kaiserAlpha = 4.0;
+
+const int c_minimumRowsPerThread = 16;
+
+const int c_encodeTableSize = 16384;
+
+using globjects::MipChain;
+using globjects::pixels::Kernels;
+
+double bessel0(const double x)
+{
+    // power series of the modified Bessel function of the first kind
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+double kaiser(const double x)
+{
+    if (std::abs(x) >= c_kaiserWidth)
+        return 0.0;
+
+    const double t = x / c_kaiserWidth;
+    const double window = bessel0(c_kaiserAlpha * std::sqrt(1.0 - t * t)) / bessel0(c_kaiserAlpha);
+
+    const double sinc = std::abs(x) < 1e-6 ? 1.0 : std::sin(c_pi * x) / (c_pi * x);
+
+    return sinc * window;
+}
+
+// returns -1 for the border
+int wrap(const int index, const int size, const GLenum mode)
+{
+    if (index >= 0 && index < size)
+        return index;
+
+    switch (mode)
+    {
+    case GL_REPEAT:
+        return (index % size + size) % size;
+
+    case GL_MIRRORED_REPEAT:
+        {
+            const int period = (index % (2 * size) + 2 * size) % (2 * size);
+            return period < size ? period : 2 * size - 1 - period;
+        }
+
+    case GL_MIRROR_CLAMP_TO_EDGE:
+        return std::min(index < 0 ? -1 - index : index, size - 1);
+
+    case GL_CLAMP_TO_BORDER:
+        return -1;
+
+    default:
+        return std::max(0, std::min(index, size - 1));
+    }
+}
+
+// weights of the source pixels contributing to each destination pixel along one axis
+struct Taps
+{
+    int count;                          // per destination pixel
+    std::vector<int> indices;
+    std::vector<float> weights;
+    std::vector<float> borderWeights;   // of samples outside the image for GL_CLAMP_TO_BORDER
+};
+
+Taps computeTaps(const int sourceSize, const int destinationSize, const MipChain::Filter filter, const GLenum wrapMode)
+{
+    const double scale = static_cast<double>(sourceSize) / destinationSize;
+    const double radius = (filter == MipChain::Filter::Box ? 0.5 : c_kaiserWidth) * scale;
+
+    Taps taps;
+    taps.count = 1;
+
+    // source pixels overlapping the filter footprint
+    for (int i = 0; i < destinationSize; ++i)
+    {
+        const double center = (i + 0.5) * scale;
+        taps.count = std::max(taps.count, static_cast<int>(std::ceil(center + radius) - std::floor(center - radius)));
+    }
+
+    taps.indices.resize(static_cast<std::size_t>(destinationSize * taps.count), 0);
+    taps.weights.resize(taps.indices.size(), 0.0f);
+    taps.borderWeights.resize(static_cast<std::size_t>(destinationSize), 0.0f);
+
+    std::vector<double> weights(static_cast<std::size_t>(taps.count));
+
+    for (int i = 0; i < destinationSize; ++i)
+    {
+        const double center = (i + 0.5) * scale;
+        const int first = static_cast<int>(std::floor(center - radius));
+
+        double total = 0.0;
+
+        for (int t = 0; t < taps.count; ++t)
+        {
+            const int index = first + t;
+
+            // the box filter weighs source pixels by their coverage, to handle odd sizes
+            weights[t] = filter == MipChain::Filter::Box
+                ? std::max(0.0, std::min(index + 1.0, center + radius) - std::max(static_cast<double>(index), center - radius))
+                : kaiser((index + 0.5 - center) / scale);
+
+            total += weights[t];
+        }
+
+        for (int t = 0; t < taps.count; ++t)
+        {
+            const float weight = static_cast<float>(weights[t] / total);
+            const int index = wrap(first + t, sourceSize, wrapMode);
+
+            if (index < 0)
+            {
+                taps.borderWeights[i] += weight;
+                continue;
+            }
+
+            taps.indices[i * taps.count + t] = index;
+            taps.weights[i * taps.count + t] = weight;
+        }
+    }
+
+    return taps;
+}
+
+void addBorder(float * pixels, const float * weights, const glm::vec4 & color, const int components, const int count)
+{
+    for (int i = 0; i < count; ++i, pixels += components)
+    {
+        for (int c = 0; c < components; ++c)
+            pixels[c] += weights[i] * color[c];
+    }
+}
+
+// runs function on ranges of [0, count) on up to threadCount threads, including the calling one
+void parallelFor(const int count, const unsigned int threadCount, const std::function<void(int begin, int end)> & function)
+{
+    const int chunks = std::max(1, std::min(static_cast<int>(threadCount), count / c_minimumRowsPerThread));
+
+    std::vector<std::thread> threads;
+
+    for (int i = 1; i < chunks; ++i)
+        threads.emplace_back(function, count * i / chunks, count * (i + 1) / chunks);
+
+    function(0, count / chunks);
+
+    for (std::thread & thread : threads)
+        thread.join();
+}
+
+struct EncodeTable
+{
+    EncodeTable()
+    {
+        for (int i = 0; i < c_encodeTableSize; ++i)
+        {
+            const double value = static_cast<double>(i) / (c_encodeTableSize - 1);
+            const double encoded = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+
+            values[i] = static_cast<unsigned char>(encoded * 255.0 + 0.5);
+        }
+    }
+
+    unsigned char values[c_encodeTableSize];
+};
+
+void encode(const float * source, unsigned char * destination, const int components, const int alphaComponent, const bool sRGB, const int count)
+{
+    static const EncodeTable table;
+
+    for (int i = 0; i < count; ++i, source += components, destination += components)
+    {
+        for (int c = 0; c < components; ++c)
+        {
+            const float value = std::max(0.0f, std::min(source[c], 1.0f));
+
+            destination[c] = sRGB && c != alphaComponent
+                ? table.values[static_cast<int>(value * (c_encodeTableSize - 1) + 0.5f)]
+                : static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+int alphaComponent(const GLenum format)
+{
+    switch (format)
+    {
+    case GL_ALPHA:
+        return 0;
+    case GL_RGBA:
+    case GL_BGRA:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+MipChain::Options::Options()
+: filter(Filter::Box)
+, wrapS(GL_CLAMP_TO_EDGE)
+, wrapT(GL_CLAMP_TO_EDGE)
+, borderColor(0.0f)
+, sRGB(false)
+, levels(0)
+, threadCount(0)
+{
+}
+
+GLsizei MipChain::levelCount(const glm::ivec2 & size)
+{
+    GLsizei count = 1;
+
+    for (int extent = std::max(size.x, size.y); extent > 1; extent /= 2)
+        ++count;
+
+    return count;
+}
+
+MipChain::MipChain(const void * data, const pixels::Layout & layout, const glm::ivec2 & size, const Options & options)
+: m_layout(layout.format, layout.type)
+{
+    generate(data, layout, size, options);
+}
+
+MipChain::~MipChain()
+{
+}
+
+bool MipChain::isValid() const
+{
+    return !m_levels.empty();
+}
+
+const pixels::Layout & MipChain::layout() const
+{
+    return m_layout;
+}
+
+const std::vector<MipChain::Level> & MipChain::levels() const
+{
+    return m_levels;
+}
+
+std::size_t MipChain::byteSize() const
+{
+    std::size_t size = 0;
+
+    for (const Level & level : m_levels)
+        size += level.data.size();
+
+    return size;
+}
+
+void MipChain::generate(const void * data, const pixels::Layout & layout, const glm::ivec2 & size, const Options & options)
+{
+    if (layout.type != GL_UNSIGNED_BYTE && layout.type != GL_FLOAT)
+        return;
+
+    // filtering happens on linear floats
+    const bool decode = options.sRGB && layout.type == GL_UNSIGNED_BYTE;
+    const pixels::Layout floatLayout(layout.format, GL_FLOAT);
+
+    if (size.x <= 0 || size.y <= 0 || !pixels::isSupported(layout, floatLayout, decode))
+        return;
+
+    const int components = pixelSizeInBytes(layout.format, GL_UNSIGNED_BYTE);
+    const int alpha = alphaComponent(layout.format);
+
+    const GLsizei levels = options.levels > 0 ? std::min(options.levels, levelCount(size)) : levelCount(size);
+    const unsigned int threadCount = options.threadCount > 0 ? options.threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+    const pixels::ScaleAddKernel scaleAdd = pixels::select(&Kernels::scaleAdd);
+    const pixels::FilterKernel filter = pixels::select(&Kernels::filter);
+
+    m_levels.resize(static_cast<std::size_t>(levels));
+
+    m_levels[0].size = size;
+    m_levels[0].data.resize(m_layout.byteSize(size));
+    pixels::convert(data, layout, m_levels[0].data.data(), m_layout, size);
+
+    std::vector<float> source(floatLayout.byteSize(size) / sizeof(float));
+    pixels::convert(data, layout, source.data(), floatLayout, size, decode);
+
+    std::vector<float> destination;
+
+    for (std::size_t i = 1; i < m_levels.size(); ++i)
+    {
+        const glm::ivec2 sourceSize = m_levels[i - 1].size;
+        const glm::ivec2 destinationSize(std::max(sourceSize.x / 2, 1), std::max(sourceSize.y / 2, 1));
+
+        Level & level = m_levels[i];
+        level.size = destinationSize;
+        level.data.resize(m_layout.byteSize(destinationSize));
+
+        destination.resize(static_cast<std::size_t>(destinationSize.x * destinationSize.y * components));
+
+        const Taps horizontal = computeTaps(sourceSize.x, destinationSize.x, options.filter, options.wrapS);
+        const Taps vertical = computeTaps(sourceSize.y, destinationSize.y, options.filter, options.wrapT);
+
+        const int sourceRowSize = sourceSize.x * components;
+        const int destinationRowSize = destinationSize.x * components;
+        const std::size_t stride = m_layout.rowStride(destinationSize.x);
+
+        parallelFor(destinationSize.y, threadCount, [&](const int begin, const int end)
+        {
+            std::vector<float> row(static_cast<std::size_t>(sourceRowSize));
+
+            for (int y = begin; y < end; ++y)
+            {
+                // filters columns into one row, then the row
+                std::fill(row.begin(), row.end(), 0.0f);
+
+                for (int t = 0; t < vertical.count; ++t)
+                {
+                    const int tap = y * vertical.count + t;
+                    scaleAdd(source.data() + vertical.indices[tap] * sourceRowSize, vertical.weights[tap], row.data(), sourceRowSize);
+                }
+
+                if (vertical.borderWeights[y] > 0.0f)
+                {
+                    const std::vector<float> weights(static_cast<std::size_t>(sourceSize.x), vertical.borderWeights[y]);
+                    addBorder(row.data(), weights.data(), options.borderColor, components, sourceSize.x);
+                }
+
+                float * filtered = destination.data() + y * destinationRowSize;
+
+                filter(row.data(), horizontal.indices.data(), horizontal.weights.data(), horizontal.count, components, filtered, destinationSize.x);
+                addBorder(filtered, horizontal.borderWeights.data(), options.borderColor, components, destinationSize.x);
+
+                unsigned char * encoded = level.data.data() + static_cast<std::size_t>(y) * stride;
+
+                if (layout.type == GL_FLOAT)
+                    std::memcpy(encoded, filtered, static_cast<std::size_t>(destinationRowSize) * sizeof(float));
+                else
+                    encode(filtered, encoded, components, alpha, decode, destinationSize.x);
+            }
+        });
+
+        source.swap(destination);
+    }
+}
+
+Texture * MipChain::createTexture(const GLenum internalFormat) const
+{
+    if (!isValid())
+        return nullptr;
+
+    Texture * texture = new Texture(GL_TEXTURE_2D);
+
+    texture->setParameter(GL_TEXTURE_MIN_FILTER, static_cast<GLint>(m_levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    texture->setParameter(GL_TEXTURE_MAG_FILTER, static_cast<GLint>(GL_LINEAR));
+
+    texture->storage2D(static_cast<GLsizei>(m_levels.size()), internalFormat, m_levels[0].size);
+
+    subImage(texture);
+
+    return texture;
+}
+
+void MipChain::subImage(Texture * texture) const
+{
+    upload(texture, -1);
+}
+
+void MipChain::subImage(Texture * texture, const GLint layer) const
+{
+    upload(texture, layer);
+}
+
+void MipChain::upload(Texture * texture, const GLint layer) const
+{
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    const GLint rowLength = getInteger(GL_UNPACK_ROW_LENGTH);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, m_layout.alignment);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    for (std::size_t i = 0; i < m_levels.size(); ++i)
+    {
+        const Level & level = m_levels[i];
+        const GLint index = static_cast<GLint>(i);
+
+        if (layer < 0)
+            texture->subImage2D(index, glm::ivec2(0), level.size, m_layout.format, m_layout.type, level.data.data());
+        else
+            texture->subImage3D(index, glm::ivec3(0, 0, layer), glm::ivec3(level.size.x, level.size.y, 1), m_layout.format, m_layout.type, level.data.data());
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+}
+
+} // namespace globjects
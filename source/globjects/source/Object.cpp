@@ -3,6 +3,7 @@
 
 #include "registry/ObjectRegistry.h"
 #include "registry/ImplementationRegistry.h"
+#include "registry/MemoryRegistry.h"
 #include "implementations/AbstractObjectNameImplementation.h"
 
 #include "Resource.h"
@@ -51,6 +52,11 @@ bool Object::isDefault() const
     return id() == 0;
 }
 
+bool Object::hasOwnership() const
+{
+    return m_resource->hasOwnership();
+}
+
 std::string Object::name() const
 {
     return nameImplementation().getLabel(this);
@@ -59,6 +65,8 @@ std::string Object::name() const
 void Object::setName(const std::string & name)
 {
     nameImplementation().setLabel(this, name);
+
+    MemoryRegistry::current().setLabel(objectType(), id(), name);
 }
 
 bool Object::hasName() const
@@ -0,0 +1,137 @@
+#include <globjects/ParallelRecorder.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <globjects/CommandList.h>
+
+namespace globjects
+{
+
+ParallelRecorder::ParallelRecorder(const unsigned int threadCount)
+: m_taskCount(0)
+, m_function(nullptr)
+, m_nextTask(0)
+, m_busyThreads(0)
+, m_generation(0)
+, m_quit(false)
+{
+    const unsigned int count = threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int i = 0; i < count; ++i)
+        m_threads.emplace_back(&ParallelRecorder::work, this);
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+
+    m_start.notify_all();
+
+    for (std::thread & thread : m_threads)
+        thread.join();
+}
+
+void ParallelRecorder::record(const std::size_t taskCount, const RecordFunction & function)
+{
+    // lists are reused, so their arenas keep their capacity across frames
+    for (ref_ptr<CommandList> & list : m_lists)
+        list->clear();
+
+    while (m_lists.size() < taskCount)
+        m_lists.push_back(new CommandList);
+
+    m_taskCount = taskCount;
+
+    if (taskCount == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_function = &function;
+        m_nextTask = 0;
+        m_busyThreads = m_threads.size();
+        ++m_generation;
+    }
+
+    m_start.notify_all();
+
+    // the calling thread records as well instead of idling
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_busyThreads == 0; });
+
+    m_function = nullptr;
+}
+
+void ParallelRecorder::work()
+{
+    unsigned long long generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [this, generation]() { return m_quit || m_generation != generation; });
+
+            if (m_quit)
+                return;
+
+            generation = m_generation;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (--m_busyThreads == 0)
+                m_finished.notify_one();
+        }
+    }
+}
+
+void ParallelRecorder::runTasks()
+{
+    // tasks are claimed dynamically to balance uneven workloads
+    for (std::size_t task = m_nextTask++; task < m_taskCount; task = m_nextTask++)
+        (*m_function)(m_lists[task], task);
+}
+
+void ParallelRecorder::submit() const
+{
+    for (std::size_t i = 0; i < m_taskCount; ++i)
+        m_lists[i]->execute();
+}
+
+void ParallelRecorder::merge(CommandList * commands) const
+{
+    assert(commands != nullptr);
+
+    for (std::size_t i = 0; i < m_taskCount; ++i)
+        commands->append(*m_lists[i]);
+}
+
+std::size_t ParallelRecorder::taskCount() const
+{
+    return m_taskCount;
+}
+
+CommandList * ParallelRecorder::commandList(const std::size_t task) const
+{
+    assert(task < m_taskCount);
+
+    return m_lists[task];
+}
+
+unsigned int ParallelRecorder::threadCount() const
+{
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+} // namespace globjects
@@ -18,6 +18,7 @@
 
 #include "Resource.h"
 #include "registry/ImplementationRegistry.h"
+#include "registry/BindingRegistry.h"
 #include "implementations/AbstractProgramBinaryImplementation.h"
 
 
@@ -84,7 +85,7 @@ void Program::use() const
     if (!isLinked())
         return;
 
-    glUseProgram(id());
+    BindingRegistry::current().useProgram(id());
 }
 
 void Program::release() const
@@ -92,7 +93,7 @@ void Program::release() const
     if (!isLinked())
         return;
 
-    glUseProgram(0);
+    BindingRegistry::current().useProgram(0);
 }
 
 bool Program::isUsed() const
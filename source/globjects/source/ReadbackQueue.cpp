@@ -0,0 +1,222 @@
+#include <globjects/ReadbackQueue.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/Sync.h>
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+
+using namespace gl;
+
+namespace
+{
+
+const GLuint64 c_waitTimeout = 1000000; // 1 ms, in nanoseconds
+
+} // namespace
+
+
+namespace globjects
+{
+
+ReadbackQueue::ReadbackQueue(const unsigned int bufferCount)
+: m_buffers(bufferCount)
+, m_capacities(bufferCount, 0)
+, m_next(0)
+, m_stallCount(0)
+{
+    assert(bufferCount > 0);
+
+    for (ref_ptr<Buffer> & buffer : m_buffers)
+        buffer = new Buffer;
+}
+
+ReadbackQueue::~ReadbackQueue()
+{
+}
+
+void ReadbackQueue::readPixels(const Framebuffer * fbo, const GLenum readBuffer, const std::array<GLint, 4> & rect, const GLenum format, const GLenum type, const Callback & callback)
+{
+    assert(fbo != nullptr);
+
+    const GLsizeiptr size = imageSizeInBytes(rect[2], rect[3], format, type);
+
+    std::size_t slot;
+    Buffer * buffer = acquire(size, slot);
+
+    buffer->bind(GL_PIXEL_PACK_BUFFER);
+    fbo->readPixels(readBuffer, rect, format, type, nullptr);
+    Buffer::unbind(GL_PIXEL_PACK_BUFFER);
+
+    submit(slot, size, callback);
+}
+
+void ReadbackQueue::readPixels(const Framebuffer * fbo, const GLenum readBuffer, const std::array<GLint, 4> & rect, const GLenum format, const GLenum type, void * destination)
+{
+    readPixels(fbo, readBuffer, rect, format, type, copyTo(destination));
+}
+
+void ReadbackQueue::getImage(const Texture * texture, const GLint level, const GLenum format, const GLenum type, const Callback & callback)
+{
+    assert(texture != nullptr);
+
+    const GLint width = texture->getLevelParameter(level, GL_TEXTURE_WIDTH);
+    const GLint height = texture->getLevelParameter(level, GL_TEXTURE_HEIGHT);
+    const GLint depth = texture->getLevelParameter(level, GL_TEXTURE_DEPTH);
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(imageSizeInBytes(width, height, format, type)) * depth;
+
+    std::size_t slot;
+    Buffer * buffer = acquire(size, slot);
+
+    buffer->bind(GL_PIXEL_PACK_BUFFER);
+    texture->getImage(level, format, type, nullptr);
+    Buffer::unbind(GL_PIXEL_PACK_BUFFER);
+
+    submit(slot, size, callback);
+}
+
+void ReadbackQueue::getImage(const Texture * texture, const GLint level, const GLenum format, const GLenum type, void * destination)
+{
+    getImage(texture, level, format, type, copyTo(destination));
+}
+
+void ReadbackQueue::readBuffer(const Buffer * source, const GLintptr offset, const GLsizeiptr size, const Callback & callback)
+{
+    assert(source != nullptr);
+
+    std::size_t slot;
+    Buffer * buffer = acquire(size, slot);
+
+    source->copySubData(buffer, offset, 0, size);
+
+    submit(slot, size, callback);
+}
+
+void ReadbackQueue::readBuffer(const Buffer * source, const GLintptr offset, const GLsizeiptr size, void * destination)
+{
+    readBuffer(source, offset, size, copyTo(destination));
+}
+
+Buffer * ReadbackQueue::acquire(const GLsizeiptr size, std::size_t & slot)
+{
+    // slots are used in order, so the next slot is busy only if the ring is full
+    if (m_requests.size() == m_buffers.size())
+    {
+        ++m_stallCount;
+        deliver(true);
+    }
+
+    slot = m_next;
+    m_next = (m_next + 1) % m_buffers.size();
+
+    Buffer * buffer = m_buffers[slot];
+
+    if (m_capacities[slot] < size)
+    {
+        buffer->setData(size, nullptr, GL_STREAM_READ);
+        m_capacities[slot] = size;
+    }
+
+    return buffer;
+}
+
+void ReadbackQueue::submit(const std::size_t slot, const GLsizeiptr size, const Callback & callback)
+{
+    Request request;
+    request.slot = slot;
+    request.size = size;
+    request.sync = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    request.callback = callback;
+
+    m_requests.push_back(request);
+}
+
+std::size_t ReadbackQueue::poll()
+{
+    std::size_t count = 0;
+
+    while (deliver(false))
+        ++count;
+
+    return count;
+}
+
+void ReadbackQueue::finish()
+{
+    while (deliver(true))
+    {
+    }
+}
+
+bool ReadbackQueue::deliver(const bool wait)
+{
+    if (m_requests.empty())
+        return false;
+
+    const Request & request = m_requests.front();
+
+    GLenum result = request.sync->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        if (!wait)
+            return false;
+
+        do
+        {
+            result = request.sync->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, c_waitTimeout);
+        }
+        while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    Buffer * buffer = m_buffers[request.slot];
+
+    const void * data = buffer->mapRange(0, request.size, GL_MAP_READ_BIT);
+
+    if (data)
+    {
+        if (request.callback)
+            request.callback(data, request.size);
+
+        buffer->unmap();
+    }
+
+    m_requests.pop_front();
+
+    return true;
+}
+
+ReadbackQueue::Callback ReadbackQueue::copyTo(void * destination)
+{
+    assert(destination != nullptr);
+
+    return [destination](const void * data, const GLsizeiptr size)
+    {
+        std::memcpy(destination, data, static_cast<std::size_t>(size));
+    };
+}
+
+std::size_t ReadbackQueue::pendingCount() const
+{
+    return m_requests.size();
+}
+
+unsigned int ReadbackQueue::bufferCount() const
+{
+    return static_cast<unsigned int>(m_buffers.size());
+}
+
+std::size_t ReadbackQueue::stallCount() const
+{
+    return m_stallCount;
+}
+
+} // namespace globjects
@@ -0,0 +1,361 @@
+#include <globjects/RenderQueue.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <unordered_map>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/CommandList.h>
+#include <globjects/Program.h>
+#include <globjects/State.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+
+using namespace gl;
+
+namespace
+{
+
+using namespace globjects;
+
+// key layout (most to least significant) for StateOrder:
+//   program (12) | state (12) | vertex array (12) | textures (12) | depth (16)
+// for depth-first sort modes the depth moves to the most significant bits
+const int c_indexBits = 12;
+const std::uint64_t c_indexMask = (1u << c_indexBits) - 1;
+
+// dense indices in order of first appearance, so the key stays compact
+template <typename Key>
+class IndexMap
+{
+public:
+    std::uint64_t operator()(const Key & key)
+    {
+        auto it = m_indices.find(key);
+
+        if (it != m_indices.end())
+            return it->second;
+
+        const std::uint64_t index = m_indices.size() & c_indexMask;
+        m_indices.emplace(key, index);
+
+        return index;
+    }
+
+protected:
+    std::unordered_map<Key, std::uint64_t> m_indices;
+};
+
+std::uint64_t quantizedDepth(const float depth)
+{
+    // the bit pattern of non-negative floats increases monotonically
+    const float clamped = std::max(depth, 0.0f);
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &clamped, sizeof(bits));
+
+    return bits >> 16;
+}
+
+std::uint64_t textureHash(const RenderQueue::DrawItem & item)
+{
+    // FNV-1a over units and textures
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (int i = 0; i < item.textureCount; ++i)
+    {
+        const std::uint64_t values[] = {
+            static_cast<std::uint64_t>(item.textures[i].unit),
+            static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(item.textures[i].texture))
+        };
+
+        for (std::uint64_t value : values)
+        {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
+
+void radixSort(std::vector<std::uint64_t> & keys, std::vector<std::uint32_t> & order, std::vector<std::uint64_t> & keyScratch, std::vector<std::uint32_t> & orderScratch)
+{
+    const std::size_t size = keys.size();
+
+    keyScratch.resize(size);
+    orderScratch.resize(size);
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        std::size_t offsets[256] = { 0 };
+
+        for (std::uint64_t key : keys)
+            ++offsets[(key >> shift) & 0xff];
+
+        // skip passes where all keys share the same byte
+        if (offsets[(keys.front() >> shift) & 0xff] == size)
+            continue;
+
+        std::size_t sum = 0;
+        for (std::size_t & offset : offsets)
+        {
+            const std::size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const std::size_t target = offsets[(keys[i] >> shift) & 0xff]++;
+
+            keyScratch[target] = keys[i];
+            orderScratch[target] = order[i];
+        }
+
+        keys.swap(keyScratch);
+        order.swap(orderScratch);
+    }
+}
+
+bool sameTextures(const RenderQueue::DrawItem & a, const RenderQueue::DrawItem & b)
+{
+    if (a.textureCount != b.textureCount)
+        return false;
+
+    for (int i = 0; i < a.textureCount; ++i)
+    {
+        if (a.textures[i].unit != b.textures[i].unit || a.textures[i].texture != b.textures[i].texture)
+            return false;
+    }
+
+    return true;
+}
+
+struct ImmediateSubmission
+{
+    void use(const Program * program) { program->use(); }
+    void apply(State * state) { state->apply(); }
+    void bindActive(const Texture * texture, GLenum unit) { texture->bindActive(unit); }
+
+    void draw(const RenderQueue::DrawItem & item)
+    {
+        if (item.type == GL_NONE)
+        {
+            if (item.instanceCount == 1 && item.baseInstance == 0)
+                item.vao->drawArrays(item.mode, item.first, item.count);
+            else if (item.baseInstance == 0)
+                item.vao->drawArraysInstanced(item.mode, item.first, item.count, item.instanceCount);
+            else
+                item.vao->drawArraysInstancedBaseInstance(item.mode, item.first, item.count, item.instanceCount, item.baseInstance);
+        }
+        else
+        {
+            if (item.instanceCount == 1 && item.baseInstance == 0 && item.baseVertex == 0)
+                item.vao->drawElements(item.mode, item.count, item.type, item.indices);
+            else if (item.instanceCount == 1 && item.baseInstance == 0)
+                item.vao->drawElementsBaseVertex(item.mode, item.count, item.type, item.indices, item.baseVertex);
+            else
+                item.vao->drawElementsInstancedBaseVertexBaseInstance(item.mode, item.count, item.type, item.indices, item.instanceCount, item.baseVertex, item.baseInstance);
+        }
+    }
+};
+
+struct RecordedSubmission
+{
+    CommandList * commands;
+
+    void use(const Program * program) { commands->use(program); }
+    void apply(State * state) { commands->apply(state); }
+    void bindActive(const Texture * texture, GLenum unit) { commands->bindActive(texture, unit); }
+
+    void draw(const RenderQueue::DrawItem & item)
+    {
+        if (item.type == GL_NONE)
+        {
+            if (item.instanceCount == 1 && item.baseInstance == 0)
+                commands->drawArrays(item.vao, item.mode, item.first, item.count);
+            else if (item.baseInstance == 0)
+                commands->drawArraysInstanced(item.vao, item.mode, item.first, item.count, item.instanceCount);
+            else
+                commands->drawArraysInstancedBaseInstance(item.vao, item.mode, item.first, item.count, item.instanceCount, item.baseInstance);
+        }
+        else
+        {
+            if (item.instanceCount == 1 && item.baseInstance == 0 && item.baseVertex == 0)
+                commands->drawElements(item.vao, item.mode, item.count, item.type, item.indices);
+            else if (item.instanceCount == 1 && item.baseInstance == 0)
+                commands->drawElementsBaseVertex(item.vao, item.mode, item.count, item.type, item.indices, item.baseVertex);
+            else
+                commands->drawElementsInstancedBaseVertexBaseInstance(item.vao, item.mode, item.count, item.type, item.indices, item.instanceCount, item.baseVertex, item.baseInstance);
+        }
+    }
+};
+
+template <typename Submission>
+void submitSorted(const std::vector<RenderQueue::DrawItem> & items, const std::vector<std::uint32_t> & order, Submission & submission)
+{
+    const RenderQueue::DrawItem * previous = nullptr;
+
+    for (std::uint32_t index : order)
+    {
+        const RenderQueue::DrawItem & item = items[index];
+
+        if (!previous || previous->program != item.program)
+            submission.use(item.program);
+
+        if (item.state && (!previous || previous->state != item.state))
+            submission.apply(item.state);
+
+        if (!previous || !sameTextures(*previous, item))
+        {
+            for (int i = 0; i < item.textureCount; ++i)
+                submission.bindActive(item.textures[i].texture, item.textures[i].unit);
+        }
+
+        submission.draw(item);
+
+        previous = &item;
+    }
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+RenderQueue::DrawItem::DrawItem()
+: program(nullptr)
+, state(nullptr)
+, vao(nullptr)
+, textureCount(0)
+, mode(GL_TRIANGLES)
+, type(GL_NONE)
+, first(0)
+, count(0)
+, indices(nullptr)
+, baseVertex(0)
+, instanceCount(1)
+, baseInstance(0)
+, depth(0.0f)
+{
+}
+
+RenderQueue::RenderQueue(const SortMode sortMode)
+: m_sortMode(sortMode)
+, m_sorted(true)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::setSortMode(const SortMode sortMode)
+{
+    m_sortMode = sortMode;
+    m_sorted = false;
+}
+
+RenderQueue::SortMode RenderQueue::sortMode() const
+{
+    return m_sortMode;
+}
+
+void RenderQueue::add(const DrawItem & item)
+{
+    assert(item.program != nullptr);
+    assert(item.vao != nullptr);
+    assert(item.textureCount >= 0 && item.textureCount <= MaxTextures);
+
+    m_items.push_back(item);
+    m_sorted = false;
+}
+
+void RenderQueue::clear()
+{
+    m_items.clear();
+    m_keys.clear();
+    m_order.clear();
+    m_sorted = true;
+}
+
+std::size_t RenderQueue::size() const
+{
+    return m_items.size();
+}
+
+bool RenderQueue::isEmpty() const
+{
+    return m_items.empty();
+}
+
+void RenderQueue::submit()
+{
+    sort();
+
+    ImmediateSubmission submission;
+    submitSorted(m_items, m_order, submission);
+}
+
+void RenderQueue::record(CommandList * commands)
+{
+    assert(commands != nullptr);
+
+    sort();
+
+    RecordedSubmission submission = { commands };
+    submitSorted(m_items, m_order, submission);
+}
+
+void RenderQueue::sort()
+{
+    if (m_sorted)
+        return;
+
+    IndexMap<const Program *> programs;
+    IndexMap<const State *> states;
+    IndexMap<const VertexArray *> vaos;
+    IndexMap<std::uint64_t> textureSets;
+
+    m_keys.resize(m_items.size());
+    m_order.resize(m_items.size());
+
+    for (std::size_t i = 0; i < m_items.size(); ++i)
+    {
+        const DrawItem & item = m_items[i];
+
+        const std::uint64_t stateKey =
+            programs(item.program) << (3 * c_indexBits)
+          | states(item.state) << (2 * c_indexBits)
+          | vaos(item.vao) << c_indexBits
+          | textureSets(textureHash(item));
+
+        const std::uint64_t depth = quantizedDepth(item.depth);
+
+        switch (m_sortMode)
+        {
+        case SortMode::StateOrder:
+            m_keys[i] = stateKey << 16 | depth;
+            break;
+        case SortMode::FrontToBack:
+            m_keys[i] = depth << 48 | stateKey;
+            break;
+        case SortMode::BackToFront:
+            m_keys[i] = (0xffff - depth) << 48 | stateKey;
+            break;
+        }
+
+        m_order[i] = static_cast<std::uint32_t>(i);
+    }
+
+    if (!m_keys.empty())
+        radixSort(m_keys, m_order, m_keyScratch, m_orderScratch);
+
+    m_sorted = true;
+}
+
+} // namespace globjects
@@ -1,11 +1,15 @@
 #include <globjects/Renderbuffer.h>
 
+#include <algorithm>
+
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/enum.h>
 
 #include <globjects/ObjectVisitor.h>
 
+#include "pixelformat.h"
 #include "Resource.h"
+#include "registry/MemoryRegistry.h"
 
 
 using namespace gl;
@@ -52,6 +56,9 @@ void Renderbuffer::storage(const GLenum internalformat, const GLsizei width, con
     bind(GL_RENDERBUFFER);
 
     glRenderbufferStorage(GL_RENDERBUFFER, internalformat, width, height);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_RENDERBUFFER, id(), storageSizeInBytes(internalformat, width, height, 1));
 }
 
 void Renderbuffer::storageMultisample(const GLsizei samples, const GLenum internalformat, const GLsizei width, const GLsizei height)
@@ -59,6 +66,9 @@ void Renderbuffer::storageMultisample(const GLsizei samples, const GLenum intern
     bind(GL_RENDERBUFFER);
 
     glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalformat, width, height);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_RENDERBUFFER, id(), storageSizeInBytes(internalformat, width, height, 1) * std::max(samples, 1));
 }
 
 GLint Renderbuffer::getParameter(const GLenum pname) const
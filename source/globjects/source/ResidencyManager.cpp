@@ -0,0 +1,284 @@
+#include <globjects/ResidencyManager.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+
+using namespace gl;
+
+namespace
+{
+
+GLint levelParameter(const GLenum target, const GLint level, const GLenum pname)
+{
+    GLint value = 0;
+
+    glGetTexLevelParameteriv(target, level, pname, &value);
+
+    return value;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+ResidencyManager::ResidencyManager(const GLint64 budget)
+: m_budget(budget)
+, m_frame(0)
+, m_overBudget(false)
+{
+    resetStats();
+}
+
+ResidencyManager::~ResidencyManager()
+{
+    clear();
+}
+
+void ResidencyManager::setBudget(const GLint64 budget)
+{
+    m_budget = budget;
+}
+
+GLint64 ResidencyManager::budget() const
+{
+    return m_budget;
+}
+
+TextureHandle ResidencyManager::reference(Texture * texture)
+{
+    assert(texture != nullptr);
+
+    auto it = m_entries.find(texture);
+
+    if (it == m_entries.end())
+    {
+        Entry & entry = m_entries[texture];
+        entry.texture = texture;
+        entry.handle = texture->textureHandle();
+        entry.size = textureSize(texture);
+        entry.resident = false;
+        entry.lastFrame = m_frame;
+        entry.lru = m_lru.insert(m_lru.begin(), texture);
+
+        m_pending.push_back(texture);
+        m_stats.trackedTextures = m_entries.size();
+
+        return entry.handle;
+    }
+
+    Entry & entry = it->second;
+
+    m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+    entry.lastFrame = m_frame;
+
+    if (!entry.resident && (m_pending.empty() || m_pending.back() != texture))
+        m_pending.push_back(texture);
+
+    return entry.handle;
+}
+
+void ResidencyManager::commit()
+{
+    for (const Texture * texture : m_pending)
+    {
+        const auto it = m_entries.find(texture);
+
+        if (it != m_entries.end() && !it->second.resident)
+            makeResident(it->second);
+    }
+
+    m_pending.clear();
+
+    evict();
+}
+
+void ResidencyManager::endFrame()
+{
+    commit();
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.texture->refCounter() > 1)
+        {
+            ++it;
+            continue;
+        }
+
+        makeNonResident(it->second);
+        m_lru.erase(it->second.lru);
+        it = m_entries.erase(it);
+    }
+
+    m_stats.trackedTextures = m_entries.size();
+
+    ++m_frame;
+    m_overBudget = false;
+}
+
+void ResidencyManager::release(Texture * texture)
+{
+    const auto it = m_entries.find(texture);
+
+    if (it == m_entries.end())
+        return;
+
+    makeNonResident(it->second);
+    m_lru.erase(it->second.lru);
+    m_entries.erase(it);
+
+    m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), texture), m_pending.end());
+
+    m_stats.trackedTextures = m_entries.size();
+}
+
+void ResidencyManager::clear()
+{
+    for (auto & pair : m_entries)
+        makeNonResident(pair.second);
+
+    m_entries.clear();
+    m_lru.clear();
+    m_pending.clear();
+
+    m_stats.trackedTextures = 0;
+}
+
+bool ResidencyManager::isResident(const Texture * texture) const
+{
+    const auto it = m_entries.find(texture);
+
+    return it != m_entries.end() && it->second.resident;
+}
+
+const ResidencyManager::Stats & ResidencyManager::stats() const
+{
+    return m_stats;
+}
+
+void ResidencyManager::resetStats()
+{
+    m_stats.madeResident = 0;
+    m_stats.madeNonResident = 0;
+    m_stats.framesOverBudget = 0;
+
+    // gauges are kept up to date by the operations
+    if (m_entries.empty())
+    {
+        m_stats.trackedTextures = 0;
+        m_stats.residentTextures = 0;
+        m_stats.residentBytes = 0;
+    }
+}
+
+void ResidencyManager::makeResident(Entry & entry)
+{
+    glMakeTextureHandleResidentARB(entry.handle);
+    entry.resident = true;
+
+    ++m_stats.residentTextures;
+    m_stats.residentBytes += entry.size;
+    ++m_stats.madeResident;
+}
+
+void ResidencyManager::makeNonResident(Entry & entry)
+{
+    if (!entry.resident)
+        return;
+
+    glMakeTextureHandleNonResidentARB(entry.handle);
+    entry.resident = false;
+
+    --m_stats.residentTextures;
+    m_stats.residentBytes -= entry.size;
+    ++m_stats.madeNonResident;
+}
+
+void ResidencyManager::evict()
+{
+    // the least recently used textures are at the back, the current frame's at the front
+    for (auto it = m_lru.rbegin(); it != m_lru.rend() && m_stats.residentBytes > m_budget; ++it)
+    {
+        Entry & entry = m_entries.at(*it);
+
+        if (entry.lastFrame == m_frame)
+        {
+            if (!m_overBudget)
+                ++m_stats.framesOverBudget;
+
+            m_overBudget = true;
+            return;
+        }
+
+        makeNonResident(entry);
+    }
+}
+
+GLint64 ResidencyManager::textureSize(const Texture * texture)
+{
+    assert(texture != nullptr);
+
+    texture->bind();
+
+    const GLenum target = texture->target();
+
+    // level parameters of cube maps are queried per face, all faces are alike
+    const bool cubeMap = target == GL_TEXTURE_CUBE_MAP;
+    const GLenum queryTarget = cubeMap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+    const GLint64 faces = cubeMap ? 6 : 1;
+
+    const GLint width = levelParameter(queryTarget, 0, GL_TEXTURE_WIDTH);
+    const GLint height = levelParameter(queryTarget, 0, GL_TEXTURE_HEIGHT);
+    const GLint depth = levelParameter(queryTarget, 0, GL_TEXTURE_DEPTH);
+
+    if (width == 0)
+        return 0;
+
+    if (target == GL_TEXTURE_2D_MULTISAMPLE || target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY)
+    {
+        const GLint samples = std::max(levelParameter(queryTarget, 0, GL_TEXTURE_SAMPLES), 1);
+        const GLenum internalFormat = static_cast<GLenum>(levelParameter(queryTarget, 0, GL_TEXTURE_INTERNAL_FORMAT));
+
+        return storageSizeInBytes(internalFormat, width, height, depth) * samples;
+    }
+
+    // querying beyond the largest possible level is an error
+    GLint levels = 1;
+    for (GLint extent = std::max(width, std::max(height, depth)); extent > 1; extent /= 2)
+        ++levels;
+
+    GLint64 size = 0;
+
+    for (GLint level = 0; level < levels; ++level)
+    {
+        const GLint levelWidth = levelParameter(queryTarget, level, GL_TEXTURE_WIDTH);
+
+        if (levelWidth == 0)
+            break;
+
+        if (levelParameter(queryTarget, level, GL_TEXTURE_COMPRESSED) == static_cast<GLint>(GL_TRUE))
+        {
+            size += levelParameter(queryTarget, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE);
+            continue;
+        }
+
+        const GLenum internalFormat = static_cast<GLenum>(levelParameter(queryTarget, level, GL_TEXTURE_INTERNAL_FORMAT));
+
+        size += storageSizeInBytes(internalFormat, levelWidth
+            , levelParameter(queryTarget, level, GL_TEXTURE_HEIGHT)
+            , levelParameter(queryTarget, level, GL_TEXTURE_DEPTH));
+    }
+
+    return size * faces;
+}
+
+} // namespace globjects
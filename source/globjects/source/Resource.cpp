@@ -1,8 +1,11 @@
 #include "Resource.h"
 
 #include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/BindingRegistry.h"
+#include "registry/MemoryRegistry.h"
 
 #include "implementations/AbstractBufferImplementation.h"
 #include "implementations/AbstractFramebufferImplementation.h"
@@ -101,8 +104,12 @@ BufferResource::BufferResource()
 
 BufferResource::~BufferResource()
 {
-    if (hasOwnership())
-        ImplementationRegistry::current().bufferImplementation().destroy(id());
+    if (!hasOwnership())
+        return;
+
+    ImplementationRegistry::current().bufferImplementation().destroy(id());
+    BindingRegistry::current().bufferDeleted(id());
+    MemoryRegistry::current().deallocate(GL_BUFFER, id());
 }
 
 
@@ -113,8 +120,11 @@ FrameBufferObjectResource::FrameBufferObjectResource()
 
 FrameBufferObjectResource::~FrameBufferObjectResource()
 {
-    if (hasOwnership())
-        ImplementationRegistry::current().framebufferImplementation().destroy(id());
+    if (!hasOwnership())
+        return;
+
+    ImplementationRegistry::current().framebufferImplementation().destroy(id());
+    BindingRegistry::current().framebufferDeleted(id());
 }
 
 
@@ -128,6 +138,7 @@ ProgramResource::~ProgramResource()
     if (hasOwnership())
     {
         glDeleteProgram(id());
+        BindingRegistry::current().programDeleted(id());
     }
 }
 
@@ -151,6 +162,9 @@ RenderBufferObjectResource::RenderBufferObjectResource()
 RenderBufferObjectResource::~RenderBufferObjectResource()
 {
     deleteObject(glDeleteRenderbuffers, id(), hasOwnership());
+
+    if (hasOwnership())
+        MemoryRegistry::current().deallocate(GL_RENDERBUFFER, id());
 }
 
 
@@ -162,6 +176,9 @@ SamplerResource::SamplerResource()
 SamplerResource::~SamplerResource()
 {
     deleteObject(glDeleteSamplers, id(), hasOwnership());
+
+    if (hasOwnership())
+        BindingRegistry::current().samplerDeleted(id());
 }
 
 ShaderResource::ShaderResource(GLenum type)
@@ -186,6 +203,12 @@ TextureResource::TextureResource()
 TextureResource::~TextureResource()
 {
     deleteObject(glDeleteTextures, id(), hasOwnership());
+
+    if (hasOwnership())
+    {
+        BindingRegistry::current().textureDeleted(id());
+        MemoryRegistry::current().deallocate(GL_TEXTURE, id());
+    }
 }
 
 
@@ -208,6 +231,9 @@ VertexArrayObjectResource::VertexArrayObjectResource()
 VertexArrayObjectResource::~VertexArrayObjectResource()
 {
     deleteObject(glDeleteVertexArrays, id(), hasOwnership());
+
+    if (hasOwnership())
+        BindingRegistry::current().vertexArrayDeleted(id());
 }
 
 } // namespace globjects
@@ -2,17 +2,100 @@
 
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
 
+#include <glm/gtc/type_ptr.hpp>
+
+#include <globjects/globjects.h>
 #include <globjects/ObjectVisitor.h>
 
 #include "Resource.h"
+#include "registry/BindingRegistry.h"
+#include "registry/SamplerRegistry.h"
 
 
 using namespace gl;
 
+namespace
+{
+
+template <typename T>
+void hashCombine(std::size_t & seed, const T & value)
+{
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void hashCombine(std::size_t & seed, const GLenum value)
+{
+    hashCombine(seed, static_cast<unsigned int>(value));
+}
+
+} // namespace
+
+
 namespace globjects
 {
 
+SamplerParameters::SamplerParameters()
+: minFilter(GL_NEAREST_MIPMAP_LINEAR)
+, magFilter(GL_LINEAR)
+, wrapS(GL_REPEAT)
+, wrapT(GL_REPEAT)
+, wrapR(GL_REPEAT)
+, minLod(-1000.0f)
+, maxLod(1000.0f)
+, lodBias(0.0f)
+, compareMode(GL_NONE)
+, compareFunc(GL_LEQUAL)
+, maxAnisotropy(1.0f)
+, borderColor(0.0f)
+{
+}
+
+bool SamplerParameters::operator==(const SamplerParameters & other) const
+{
+    return minFilter == other.minFilter
+        && magFilter == other.magFilter
+        && wrapS == other.wrapS
+        && wrapT == other.wrapT
+        && wrapR == other.wrapR
+        && minLod == other.minLod
+        && maxLod == other.maxLod
+        && lodBias == other.lodBias
+        && compareMode == other.compareMode
+        && compareFunc == other.compareFunc
+        && maxAnisotropy == other.maxAnisotropy
+        && borderColor == other.borderColor;
+}
+
+bool SamplerParameters::operator!=(const SamplerParameters & other) const
+{
+    return !(*this == other);
+}
+
+std::size_t SamplerParameters::hash() const
+{
+    std::size_t seed = 0;
+
+    hashCombine(seed, minFilter);
+    hashCombine(seed, magFilter);
+    hashCombine(seed, wrapS);
+    hashCombine(seed, wrapT);
+    hashCombine(seed, wrapR);
+    hashCombine(seed, minLod);
+    hashCombine(seed, maxLod);
+    hashCombine(seed, lodBias);
+    hashCombine(seed, compareMode);
+    hashCombine(seed, compareFunc);
+    hashCombine(seed, maxAnisotropy);
+
+    for (int i = 0; i < 4; ++i)
+        hashCombine(seed, borderColor[i]);
+
+    return seed;
+}
+
+
 Sampler::Sampler()
 : Object(new SamplerResource)
 {
@@ -28,6 +111,11 @@ Sampler * Sampler::fromId(const GLuint id)
     return new Sampler(new ExternalResource(id));
 }
 
+const Sampler * Sampler::shared(const SamplerParameters & parameters)
+{
+    return SamplerRegistry::current().sampler(parameters);
+}
+
 Sampler::~Sampler()
 {
 }
@@ -39,12 +127,12 @@ void Sampler::accept(ObjectVisitor & visitor)
 
 void Sampler::bind(const GLuint unit) const
 {
-    glBindSampler(unit, id());
+    BindingRegistry::current().bindSampler(unit, id());
 }
 
 void Sampler::unbind(const GLuint unit)
 {
-    glBindSampler(unit, 0);
+    BindingRegistry::current().bindSampler(unit, 0);
 }
 
 void Sampler::setParameter(const GLenum name, const GLint value)
@@ -57,6 +145,29 @@ void Sampler::setParameter(const GLenum name, const GLfloat value)
     glSamplerParameterf(id(), name, value);
 }
 
+void Sampler::setParameter(const GLenum name, const glm::vec4 & value)
+{
+    glSamplerParameterfv(id(), name, glm::value_ptr(value));
+}
+
+void Sampler::setParameters(const SamplerParameters & parameters)
+{
+    setParameter(GL_TEXTURE_MIN_FILTER, static_cast<GLint>(parameters.minFilter));
+    setParameter(GL_TEXTURE_MAG_FILTER, static_cast<GLint>(parameters.magFilter));
+    setParameter(GL_TEXTURE_WRAP_S, static_cast<GLint>(parameters.wrapS));
+    setParameter(GL_TEXTURE_WRAP_T, static_cast<GLint>(parameters.wrapT));
+    setParameter(GL_TEXTURE_WRAP_R, static_cast<GLint>(parameters.wrapR));
+    setParameter(GL_TEXTURE_MIN_LOD, parameters.minLod);
+    setParameter(GL_TEXTURE_MAX_LOD, parameters.maxLod);
+    setParameter(GL_TEXTURE_LOD_BIAS, parameters.lodBias);
+    setParameter(GL_TEXTURE_COMPARE_MODE, static_cast<GLint>(parameters.compareMode));
+    setParameter(GL_TEXTURE_COMPARE_FUNC, static_cast<GLint>(parameters.compareFunc));
+    setParameter(GL_TEXTURE_BORDER_COLOR, parameters.borderColor);
+
+    if (hasExtension(GLextension::GL_EXT_texture_filter_anisotropic))
+        setParameter(GL_TEXTURE_MAX_ANISOTROPY_EXT, parameters.maxAnisotropy);
+}
+
 GLint Sampler::getParameteri(const GLenum pname) const
 {
     GLint value = 0;
@@ -0,0 +1,53 @@
+#include <globjects/StateGuard.h>
+
+#include <globjects/globjects.h>
+
+#include "registry/StateRegistry.h"
+
+using namespace gl;
+
+namespace globjects
+{
+
+StateGuard::StateGuard()
+: m_active(true)
+{
+    StateRegistry::current().registerGuard(this);
+}
+
+StateGuard::~StateGuard()
+{
+    restore();
+}
+
+void StateGuard::restore()
+{
+    if (!m_active)
+        return;
+
+    // deregister first, so restoring does not record into this guard again
+    StateRegistry::current().deregisterGuard(this);
+    m_active = false;
+
+    for (const auto & capability : m_capabilities)
+    {
+        setEnabled(capability.first, capability.second);
+    }
+    for (const auto & capability : m_indexedCapabilities)
+    {
+        setEnabled(capability.first.first, capability.first.second, capability.second);
+    }
+    for (auto & settings : m_settings)
+    {
+        for (StateSetting & setting : settings.second)
+        {
+            setting.apply();
+        }
+    }
+
+    m_capabilities.clear();
+    m_indexedCapabilities.clear();
+    m_settings.clear();
+}
+
+} // namespace globjects
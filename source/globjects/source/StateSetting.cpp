@@ -3,6 +3,8 @@
 
 #include <glbinding/gl/enum.h>
 
+#include "registry/StateRegistry.h"
+
 using namespace gl;
 
 namespace globjects
@@ -45,8 +47,9 @@ StateSetting::~StateSetting()
 
 void StateSetting::apply()
 {
-    (*m_functionCall)();
+    StateRegistry::current().settingChanged(*this);
 
+    (*m_functionCall)();
 }
 
 const StateSettingType & StateSetting::type() const
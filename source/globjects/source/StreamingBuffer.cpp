@@ -0,0 +1,199 @@
+#include <globjects/StreamingBuffer.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+using namespace gl;
+
+namespace
+{
+
+const GLuint64 c_waitTimeout = 1000000; // 1 ms, in nanoseconds
+
+} // namespace
+
+
+namespace globjects
+{
+
+StreamingBuffer::StreamingBuffer(const GLsizeiptr capacity, const FlushMode flushMode)
+: m_buffer(new Buffer)
+, m_capacity(capacity)
+, m_flushMode(flushMode)
+, m_data(nullptr)
+, m_head(0)
+, m_regionBegin(0)
+, m_stallCount(0)
+{
+    assert(capacity > 0);
+
+    if (flushMode == FlushMode::Coherent)
+    {
+        m_buffer->setStorage(capacity, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        m_data = static_cast<unsigned char *>(m_buffer->mapRange(0, capacity, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+    }
+    else
+    {
+        m_buffer->setStorage(capacity, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+        m_data = static_cast<unsigned char *>(m_buffer->mapRange(0, capacity, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+    }
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (m_data)
+        m_buffer->unmap();
+}
+
+StreamingBuffer::Allocation StreamingBuffer::allocate(const GLsizeiptr size, const GLsizeiptr alignment)
+{
+    assert(size > 0 && size <= m_capacity);
+    assert(alignment > 0);
+
+    const unsigned long long capacity = static_cast<unsigned long long>(m_capacity);
+    const unsigned long long length = static_cast<unsigned long long>(size);
+
+    m_head = place(m_head, m_capacity, size, alignment);
+
+    waitFor(m_head + length);
+
+    const Allocation allocation = { m_data + m_head % capacity, static_cast<GLintptr>(m_head % capacity), size };
+    m_head += length;
+
+    return allocation;
+}
+
+unsigned long long StreamingBuffer::nextPosition(const GLsizeiptr size, const GLsizeiptr alignment) const
+{
+    return place(m_head, m_capacity, size, alignment);
+}
+
+unsigned long long StreamingBuffer::place(const unsigned long long head, const GLsizeiptr capacity, const GLsizeiptr size, const GLsizeiptr alignment)
+{
+    const unsigned long long ring = static_cast<unsigned long long>(capacity);
+    const unsigned long long step = static_cast<unsigned long long>(alignment);
+    const unsigned long long length = static_cast<unsigned long long>(size);
+
+    const unsigned long long offset = head % ring;
+    const unsigned long long aligned = (offset + step - 1) / step * step;
+
+    // allocations never straddle the end, the remainder is skipped instead
+    if (aligned + length > ring)
+        return head + (ring - offset);
+
+    return head + (aligned - offset);
+}
+
+StreamingBuffer::Allocation StreamingBuffer::write(const void * data, const GLsizeiptr size, const GLsizeiptr alignment)
+{
+    const Allocation allocation = allocate(size, alignment);
+    std::memcpy(allocation.data, data, static_cast<std::size_t>(size));
+
+    return allocation;
+}
+
+void StreamingBuffer::waitFor(const unsigned long long position)
+{
+    const unsigned long long capacity = static_cast<unsigned long long>(m_capacity);
+
+    if (position <= capacity)
+        return;
+
+    // everything before this position of the previous lap gets overwritten
+    const unsigned long long reused = position - capacity;
+
+    // a single frame exceeding the capacity has to be fenced and waited for as well
+    if (m_regionBegin < reused && m_regionBegin < m_head)
+        fence();
+
+    bool stalled = false;
+
+    while (!m_regions.empty() && m_regions.front().begin < reused)
+    {
+        Sync * sync = m_regions.front().sync;
+
+        GLenum result = sync->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            stalled = true;
+
+            do
+            {
+                result = sync->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, c_waitTimeout);
+            }
+            while (result == GL_TIMEOUT_EXPIRED);
+        }
+
+        m_regions.pop_front();
+    }
+
+    if (stalled)
+        ++m_stallCount;
+}
+
+void StreamingBuffer::fence()
+{
+    if (m_head == m_regionBegin)
+        return;
+
+    if (m_flushMode == FlushMode::Explicit)
+        flush(m_regionBegin, m_head);
+
+    const Region region = { m_regionBegin, m_head, Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE) };
+    m_regions.push_back(region);
+
+    m_regionBegin = m_head;
+}
+
+void StreamingBuffer::flush(const unsigned long long begin, const unsigned long long end)
+{
+    const unsigned long long capacity = static_cast<unsigned long long>(m_capacity);
+
+    if (end - begin >= capacity)
+    {
+        m_buffer->flushMappedRange(0, m_capacity);
+        return;
+    }
+
+    const unsigned long long first = begin % capacity;
+    const unsigned long long last = end % capacity;
+
+    if (first < last || last == 0)
+    {
+        m_buffer->flushMappedRange(static_cast<GLintptr>(first), static_cast<GLsizeiptr>(end - begin));
+    }
+    else
+    {
+        m_buffer->flushMappedRange(static_cast<GLintptr>(first), static_cast<GLsizeiptr>(capacity - first));
+        m_buffer->flushMappedRange(0, static_cast<GLsizeiptr>(last));
+    }
+}
+
+Buffer * StreamingBuffer::buffer() const
+{
+    return m_buffer;
+}
+
+GLsizeiptr StreamingBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+StreamingBuffer::FlushMode StreamingBuffer::flushMode() const
+{
+    return m_flushMode;
+}
+
+std::size_t StreamingBuffer::stallCount() const
+{
+    return m_stallCount;
+}
+
+} // namespace globjects
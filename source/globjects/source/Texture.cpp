@@ -1,20 +1,107 @@
 #include <globjects/Texture.h>
 
+#include <algorithm>
+
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/boolean.h>
+#include <glbinding/gl/extension.h>
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <globjects/globjects.h>
 #include <globjects/Buffer.h>
 #include <globjects/ObjectVisitor.h>
+#include <globjects/Sampler.h>
 
 #include "pixelformat.h"
 #include "Resource.h"
+#include "registry/BindingRegistry.h"
+#include "registry/MemoryRegistry.h"
 
 
 using namespace gl;
 
+namespace
+{
+
+glm::vec4 parameterValue(const GLint value)
+{
+    return glm::vec4(static_cast<GLfloat>(value), 0.0f, 0.0f, 0.0f);
+}
+
+glm::vec4 parameterValue(const GLenum value)
+{
+    return parameterValue(static_cast<GLint>(value));
+}
+
+glm::vec4 parameterValue(const GLfloat value)
+{
+    return glm::vec4(value, 0.0f, 0.0f, 0.0f);
+}
+
+// returns false for parameters whose initial value is not known
+bool initialParameterValue(const GLenum target, const GLenum name, glm::vec4 & value)
+{
+    const bool rectangle = target == GL_TEXTURE_RECTANGLE;
+
+    switch (name)
+    {
+    case GL_TEXTURE_MIN_FILTER:
+        value = parameterValue(rectangle ? GL_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
+        return true;
+
+    case GL_TEXTURE_MAG_FILTER:
+        value = parameterValue(GL_LINEAR);
+        return true;
+
+    case GL_TEXTURE_WRAP_S:
+    case GL_TEXTURE_WRAP_T:
+    case GL_TEXTURE_WRAP_R:
+        value = parameterValue(rectangle ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+        return true;
+
+    case GL_TEXTURE_MIN_LOD:
+        value = parameterValue(-1000.0f);
+        return true;
+
+    case GL_TEXTURE_MAX_LOD:
+        value = parameterValue(1000.0f);
+        return true;
+
+    case GL_TEXTURE_LOD_BIAS:
+    case GL_TEXTURE_BORDER_COLOR:
+        value = glm::vec4(0.0f);
+        return true;
+
+    case GL_TEXTURE_BASE_LEVEL:
+        value = parameterValue(0);
+        return true;
+
+    case GL_TEXTURE_MAX_LEVEL:
+        value = parameterValue(1000);
+        return true;
+
+    case GL_TEXTURE_COMPARE_MODE:
+        value = parameterValue(GL_NONE);
+        return true;
+
+    case GL_TEXTURE_COMPARE_FUNC:
+        value = parameterValue(GL_LEQUAL);
+        return true;
+
+    case GL_TEXTURE_MAX_ANISOTROPY_EXT:
+        value = parameterValue(1.0f);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+
 namespace globjects
 {
 
@@ -26,12 +113,14 @@ Texture::Texture()
 Texture::Texture(const GLenum target)
 : Object(new TextureResource)
 , m_target(target)
+, m_defaultParameters(true)
 {
 }
 
 Texture::Texture(IDResource * resource, const GLenum target)
 : Object(resource)
 , m_target(target)
+, m_defaultParameters(false)
 {
 }
 
@@ -65,7 +154,7 @@ Texture * Texture::createDefault(const GLenum target)
 
 void Texture::bind() const
 {
-    glBindTexture(m_target, id());
+    BindingRegistry::current().bindTexture(m_target, id());
 }
 
 void Texture::unbind() const
@@ -75,19 +164,19 @@ void Texture::unbind() const
 
 void Texture::unbind(const GLenum target)
 {
-    glBindTexture(target, 0);
+    BindingRegistry::current().bindTexture(target, 0);
 }
 
 void Texture::bindActive(const GLenum texture) const
 {
-    glActiveTexture(texture);
-    glBindTexture(m_target, id());
+    BindingRegistry::current().activeTexture(texture);
+    BindingRegistry::current().bindTexture(m_target, id());
 }
 
 void Texture::unbindActive(const GLenum texture) const
 {
-    glActiveTexture(texture);
-    glBindTexture(m_target, 0);
+    BindingRegistry::current().activeTexture(texture);
+    BindingRegistry::current().bindTexture(m_target, 0);
 }
 
 GLenum Texture::target() const
@@ -102,18 +191,87 @@ void Texture::setParameter(const GLenum name, const GLenum value)
 
 void Texture::setParameter(const GLenum name, const GLint value)
 {
-	bind();
+    if (!shadowParameter(name, parameterValue(value)))
+        return;
+
+    bind();
 
     glTexParameteri(m_target, name, value);
 }
 
 void Texture::setParameter(const GLenum name, const GLfloat value)
 {
-	bind();
+    if (!shadowParameter(name, parameterValue(value)))
+        return;
+
+    bind();
 
     glTexParameterf(m_target, name, value);
 }
 
+void Texture::setParameter(const GLenum name, const glm::vec4 & value)
+{
+    if (!shadowParameter(name, value))
+        return;
+
+    bind();
+
+    glTexParameterfv(m_target, name, glm::value_ptr(value));
+}
+
+void Texture::setParameters(const SamplerParameters & parameters)
+{
+    setParameter(GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    setParameter(GL_TEXTURE_MAG_FILTER, parameters.magFilter);
+    setParameter(GL_TEXTURE_WRAP_S, parameters.wrapS);
+    setParameter(GL_TEXTURE_WRAP_T, parameters.wrapT);
+    setParameter(GL_TEXTURE_WRAP_R, parameters.wrapR);
+    setParameter(GL_TEXTURE_MIN_LOD, parameters.minLod);
+    setParameter(GL_TEXTURE_MAX_LOD, parameters.maxLod);
+    setParameter(GL_TEXTURE_LOD_BIAS, parameters.lodBias);
+    setParameter(GL_TEXTURE_COMPARE_MODE, parameters.compareMode);
+    setParameter(GL_TEXTURE_COMPARE_FUNC, parameters.compareFunc);
+    setParameter(GL_TEXTURE_BORDER_COLOR, parameters.borderColor);
+
+    if (hasExtension(GLextension::GL_EXT_texture_filter_anisotropic))
+        setParameter(GL_TEXTURE_MAX_ANISOTROPY_EXT, parameters.maxAnisotropy);
+}
+
+void Texture::invalidateParameters()
+{
+    m_parameters.clear();
+    m_defaultParameters = false;
+}
+
+bool Texture::shadowParameter(const GLenum name, const glm::vec4 & value)
+{
+    for (ShadowedParameter & parameter : m_parameters)
+    {
+        if (parameter.name != name)
+            continue;
+
+        if (parameter.value == value)
+            return false;
+
+        parameter.value = value;
+
+        return true;
+    }
+
+    glm::vec4 initialValue;
+
+    if (m_defaultParameters && initialParameterValue(m_target, name, initialValue) && initialValue == value)
+        return false;
+
+    ShadowedParameter parameter;
+    parameter.name = name;
+    parameter.value = value;
+
+    m_parameters.push_back(parameter);
+
+    return true;
+}
+
 GLint Texture::getParameter(const GLenum pname) const
 {
 	bind();
@@ -178,6 +336,9 @@ void Texture::image1D(const GLint level, const GLenum internalFormat, const GLsi
     bind();
 
     glTexImage1D(m_target, level, static_cast<GLint>(internalFormat), width, border, format, type, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, storageSizeInBytes(internalFormat, width, 1, 1));
 }
 
 void Texture::compressedImage1D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLint border, const GLsizei imageSize, const GLvoid * data)
@@ -185,6 +346,9 @@ void Texture::compressedImage1D(const GLint level, const GLenum internalFormat,
     bind();
 
     glCompressedTexImage1D(m_target, level, internalFormat, width, border, imageSize, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, imageSize);
 }
 
 void Texture::subImage1D(const GLint level, const GLint xOffset, const GLsizei width, const GLenum format, const GLenum type, const GLvoid * data)
@@ -199,6 +363,9 @@ void Texture::image2D(const GLint level, const GLenum internalFormat, const GLsi
 	bind();
 
     glTexImage2D(m_target, level, static_cast<GLint>(internalFormat), width, height, border, format, type, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, storageSizeInBytes(internalFormat, width, height, 1));
 }
 
 void Texture::image2D(const GLint level, const GLenum internalFormat, const glm::ivec2 & size, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
@@ -211,6 +378,9 @@ void Texture::image2D(const GLenum target, const GLint level, const GLenum inter
     bind();
 
     glTexImage2D(target, level, static_cast<GLint>(internalFormat), width, height, border, format, type, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), target, level, storageSizeInBytes(internalFormat, width, height, 1));
 }
 
 void Texture::image2D(const GLenum target, const GLint level, const GLenum internalFormat, const glm::ivec2 & size, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
@@ -223,6 +393,9 @@ void Texture::compressedImage2D(const GLint level, const GLenum internalFormat,
     bind();
 
     glCompressedTexImage2D(m_target, level, internalFormat, width, height, border, imageSize, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, imageSize);
 }
 
 void Texture::compressedImage2D(const GLint level, const GLenum internalFormat, const glm::ivec2 & size, const GLint border, const GLsizei imageSize, const GLvoid * data)
@@ -242,11 +415,26 @@ void Texture::subImage2D(const GLint level, const glm::ivec2& offset, const glm:
     subImage2D(level, offset.x, offset.y, size.x, size.y, format, type, data);
 }
 
+void Texture::compressedSubImage2D(const GLint level, const GLint xOffset, const GLint yOffset, const GLsizei width, const GLsizei height, const GLenum format, const GLsizei imageSize, const GLvoid * data)
+{
+    bind();
+
+    glCompressedTexSubImage2D(m_target, level, xOffset, yOffset, width, height, format, imageSize, data);
+}
+
+void Texture::compressedSubImage2D(const GLint level, const glm::ivec2 & offset, const glm::ivec2 & size, const GLenum format, const GLsizei imageSize, const GLvoid * data)
+{
+    compressedSubImage2D(level, offset.x, offset.y, size.x, size.y, format, imageSize, data);
+}
+
 void Texture::image3D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei depth, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
 {
     bind();
 
     glTexImage3D(m_target, level, static_cast<GLint>(internalFormat), width, height, depth, border, format, type, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, storageSizeInBytes(internalFormat, width, height, depth));
 }
 
 void Texture::image3D(const GLint level, const GLenum internalFormat, const glm::ivec3 & size, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
@@ -259,6 +447,9 @@ void Texture::compressedImage3D(const GLint level, const GLenum internalFormat,
     bind();
 
     glCompressedTexImage3D(m_target, level, internalFormat, width, height, depth, border, imageSize, data);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocateImage(id(), m_target, level, imageSize);
 }
 
 void Texture::compressedImage3D(GLint level, GLenum internalFormat, const glm::ivec3 & size, GLint border, GLsizei imageSize, const GLvoid * data)
@@ -278,11 +469,26 @@ void Texture::subImage3D(const GLint level, const glm::ivec3& offset, const glm:
     subImage3D(level, offset.x, offset.y, offset.z, size.x, size.y, size.z, format, type, data);
 }
 
+void Texture::compressedSubImage3D(const GLint level, const GLint xOffset, const GLint yOffset, const GLint zOffset, const GLsizei width, const GLsizei height, const GLsizei depth, const GLenum format, const GLsizei imageSize, const GLvoid * data)
+{
+    bind();
+
+    glCompressedTexSubImage3D(m_target, level, xOffset, yOffset, zOffset, width, height, depth, format, imageSize, data);
+}
+
+void Texture::compressedSubImage3D(const GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, const GLenum format, const GLsizei imageSize, const GLvoid * data)
+{
+    compressedSubImage3D(level, offset.x, offset.y, offset.z, size.x, size.y, size.z, format, imageSize, data);
+}
+
 void Texture::image2DMultisample(const GLsizei samples, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLboolean fixedSamplesLocations)
 {
     bind();
 
     glTexImage2DMultisample(m_target, samples, internalFormat, width, height, fixedSamplesLocations);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_TEXTURE, id(), storageSizeInBytes(internalFormat, width, height, 1) * std::max(samples, 1));
 }
 
 void Texture::image2DMultisample(const GLsizei samples, const GLenum internalFormat, const glm::ivec2 & size, const GLboolean fixedSamplesLocations)
@@ -295,6 +501,9 @@ void Texture::image3DMultisample(const GLsizei samples, const GLenum internalFor
     bind();
 
     glTexImage3DMultisample(m_target, samples, internalFormat, width, height, depth, fixedSamplesLocations);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_TEXTURE, id(), storageSizeInBytes(internalFormat, width, height, depth) * std::max(samples, 1));
 }
 
 void Texture::image3DMultisample(const GLsizei samples, const GLenum internalFormat, const glm::ivec3 & size, const GLboolean fixedSamplesLocations)
@@ -307,6 +516,9 @@ void Texture::storage1D(const GLsizei levels, const GLenum internalFormat, const
     bind();
 
     glTexStorage1D(m_target, levels, internalFormat, width);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_TEXTURE, id(), storageSizeInBytes(m_target, levels, internalFormat, width, 1, 1));
 }
 
 void Texture::storage2D(const GLsizei levels, const GLenum internalFormat, const GLsizei width, const GLsizei height)
@@ -314,6 +526,9 @@ void Texture::storage2D(const GLsizei levels, const GLenum internalFormat, const
 	bind();
 
     glTexStorage2D(m_target, levels, internalFormat, width, height);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_TEXTURE, id(), storageSizeInBytes(m_target, levels, internalFormat, width, height, 1));
 }
 
 void Texture::storage2D(const GLsizei levels, const GLenum internalFormat, const glm::ivec2 & size)
@@ -326,6 +541,9 @@ void Texture::storage3D(const GLsizei levels, const GLenum internalFormat, const
     bind();
 
     glTexStorage3D(m_target, levels, internalFormat, width, height, depth);
+
+    if (hasOwnership())
+        MemoryRegistry::current().allocate(GL_TEXTURE, id(), storageSizeInBytes(m_target, levels, internalFormat, width, height, depth));
 }
 
 void Texture::storage3D(const GLsizei levels, const GLenum internalFormat, const glm::ivec3 & size)
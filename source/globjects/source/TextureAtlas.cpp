@@ -0,0 +1,468 @@
+#include <globjects/TextureAtlas.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+
+using namespace gl;
+
+namespace
+{
+
+int alignUp(const int value, const int alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+SkylinePacker::SkylinePacker()
+: SkylinePacker(glm::ivec2(0))
+{
+}
+
+SkylinePacker::SkylinePacker(const glm::ivec2 & size)
+: m_size(size)
+, m_usedArea(0)
+{
+    clear();
+}
+
+bool SkylinePacker::insert(const glm::ivec2 & size, glm::ivec2 & position)
+{
+    assert(size.x > 0 && size.y > 0);
+
+    std::size_t best = m_skyline.size();
+    int bestTop = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    int bestY = 0;
+
+    for (std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        const int y = fit(i, size);
+
+        if (y < 0)
+            continue;
+
+        const int top = y + size.y;
+
+        if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth))
+        {
+            best = i;
+            bestTop = top;
+            bestWidth = m_skyline[i].width;
+            bestY = y;
+        }
+    }
+
+    if (best == m_skyline.size())
+        return false;
+
+    position = glm::ivec2(m_skyline[best].x, bestY);
+
+    const Node node = { position.x, bestTop, size.x };
+    m_skyline.insert(m_skyline.begin() + best, node);
+
+    // the new node covers the start of the following ones
+    for (std::size_t i = best + 1; i < m_skyline.size();)
+    {
+        const Node & previous = m_skyline[i - 1];
+        Node & current = m_skyline[i];
+
+        const int overlap = previous.x + previous.width - current.x;
+
+        if (overlap <= 0)
+            break;
+
+        current.x += overlap;
+        current.width -= overlap;
+
+        if (current.width > 0)
+            break;
+
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    for (std::size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+            ++i;
+    }
+
+    m_usedArea += static_cast<long long>(size.x) * size.y;
+
+    return true;
+}
+
+int SkylinePacker::fit(const std::size_t index, const glm::ivec2 & size) const
+{
+    if (m_skyline[index].x + size.x > m_size.x)
+        return -1;
+
+    int y = 0;
+    int remaining = size.x;
+
+    // the skyline spans the whole width, so the nodes suffice
+    for (std::size_t i = index; remaining > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+
+        if (y + size.y > m_size.y)
+            return -1;
+
+        remaining -= m_skyline[i].width;
+    }
+
+    return y;
+}
+
+void SkylinePacker::clear()
+{
+    m_skyline.clear();
+    m_skyline.push_back({ 0, 0, m_size.x });
+
+    m_usedArea = 0;
+}
+
+glm::ivec2 SkylinePacker::size() const
+{
+    return m_size;
+}
+
+long long SkylinePacker::usedArea() const
+{
+    return m_usedArea;
+}
+
+
+const TextureAtlas::Handle TextureAtlas::InvalidHandle = std::numeric_limits<TextureAtlas::Handle>::max();
+
+TextureAtlas::TextureAtlas(const GLenum internalFormat, const glm::ivec2 & layerSize, const GLsizei layers, const GLsizei levels, const GLint padding)
+: m_internalFormat(internalFormat)
+, m_layerSize(layerSize)
+, m_levels(levels)
+, m_padding(padding)
+, m_alignment(1 << (levels - 1))
+, m_packers(layers, SkylinePacker(layerSize))
+, m_liveCounts(layers, 0)
+, m_removedAreas(layers, 0)
+, m_mipmapsDirty(false)
+{
+    assert(layers > 0);
+    assert(levels > 0);
+    assert(padding >= 0);
+
+    m_texture = createTexture(layers);
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+TextureAtlas::Handle TextureAtlas::insert(const glm::ivec2 & size, const GLenum format, const GLenum type, const void * data)
+{
+    assert(data != nullptr);
+
+    const glm::ivec2 block = blockSize(size);
+
+    if (size.x <= 0 || size.y <= 0 || block.x > m_layerSize.x || block.y > m_layerSize.y)
+        return InvalidHandle;
+
+    Entry entry;
+    entry.live = true;
+    entry.size = size;
+
+    if (!place(block, entry.layer, entry.position))
+    {
+        grow();
+        place(block, entry.layer, entry.position);
+    }
+
+    // replicate the edges into the padding
+    const int pixelSize = imageSizeInBytes(1, 1, format, type, 1);
+    const glm::ivec2 padded = size + glm::ivec2(2 * m_padding);
+
+    m_staging.resize(static_cast<std::size_t>(padded.x) * padded.y * pixelSize);
+
+    const unsigned char * source = reinterpret_cast<const unsigned char *>(data);
+
+    for (int y = 0; y < padded.y; ++y)
+    {
+        const int sourceY = std::min(std::max(y - m_padding, 0), size.y - 1);
+
+        const unsigned char * sourceRow = source + static_cast<std::size_t>(sourceY) * size.x * pixelSize;
+        unsigned char * row = m_staging.data() + static_cast<std::size_t>(y) * padded.x * pixelSize;
+
+        std::memcpy(row + m_padding * pixelSize, sourceRow, static_cast<std::size_t>(size.x) * pixelSize);
+
+        for (int x = 0; x < m_padding; ++x)
+        {
+            std::memcpy(row + x * pixelSize, sourceRow, pixelSize);
+            std::memcpy(row + (m_padding + size.x + x) * pixelSize, sourceRow + (size.x - 1) * pixelSize, pixelSize);
+        }
+    }
+
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    m_texture->subImage3D(0, entry.position.x, entry.position.y, entry.layer, padded.x, padded.y, 1, format, type, m_staging.data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    ++m_liveCounts[entry.layer];
+    m_mipmapsDirty = true;
+
+    Handle handle;
+
+    if (m_freeHandles.empty())
+    {
+        handle = static_cast<Handle>(m_entries.size());
+        m_entries.push_back(entry);
+    }
+    else
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+        m_entries[handle] = entry;
+    }
+
+    return handle;
+}
+
+void TextureAtlas::remove(const Handle handle)
+{
+    assert(handle < m_entries.size() && m_entries[handle].live);
+
+    Entry & entry = m_entries[handle];
+    entry.live = false;
+
+    m_freeHandles.push_back(handle);
+
+    const glm::ivec2 block = blockSize(entry.size);
+    m_removedAreas[entry.layer] += static_cast<long long>(block.x) * block.y;
+
+    // an empty layer is reused from scratch
+    if (--m_liveCounts[entry.layer] == 0)
+    {
+        m_packers[entry.layer].clear();
+        m_removedAreas[entry.layer] = 0;
+    }
+}
+
+TextureAtlas::Slot TextureAtlas::slot(const Handle handle) const
+{
+    assert(handle < m_entries.size() && m_entries[handle].live);
+
+    const Entry & entry = m_entries[handle];
+
+    const glm::ivec2 offset = entry.position + glm::ivec2(m_padding);
+    const glm::vec2 layerSize(m_layerSize);
+
+    Slot slot;
+    slot.texture = m_texture;
+    slot.layer = entry.layer;
+    slot.uvRect = glm::vec4(glm::vec2(offset) / layerSize, glm::vec2(offset + entry.size) / layerSize);
+    slot.rect = glm::ivec4(offset.x, offset.y, entry.size.x, entry.size.y);
+
+    return slot;
+}
+
+void TextureAtlas::generateMipmaps()
+{
+    if (m_levels == 1 || !m_mipmapsDirty)
+        return;
+
+    m_texture->generateMipmap();
+    m_mipmapsDirty = false;
+}
+
+std::vector<TextureAtlas::Handle> TextureAtlas::defragment()
+{
+    std::vector<Handle> handles;
+
+    for (Handle handle = 0; handle < m_entries.size(); ++handle)
+    {
+        if (m_entries[handle].live)
+            handles.push_back(handle);
+    }
+
+    // tall blocks first leave a flatter skyline
+    std::stable_sort(handles.begin(), handles.end(), [this](const Handle a, const Handle b)
+    {
+        const glm::ivec2 first = blockSize(m_entries[a].size);
+        const glm::ivec2 second = blockSize(m_entries[b].size);
+
+        return first.y > second.y || (first.y == second.y && first.x > second.x);
+    });
+
+    std::vector<SkylinePacker> packers(1, SkylinePacker(m_layerSize));
+    std::vector<Entry> placed(m_entries);
+
+    for (const Handle handle : handles)
+    {
+        Entry & entry = placed[handle];
+        const glm::ivec2 block = blockSize(entry.size);
+
+        entry.layer = 0;
+
+        while (!packers[entry.layer].insert(block, entry.position))
+        {
+            if (++entry.layer == static_cast<GLint>(packers.size()))
+                packers.push_back(SkylinePacker(m_layerSize));
+        }
+    }
+
+    ref_ptr<Texture> texture = createTexture(static_cast<GLsizei>(packers.size()));
+
+    std::vector<Handle> moved;
+
+    for (const Handle handle : handles)
+    {
+        copy(texture, m_entries[handle], placed[handle]);
+
+        if (placed[handle].layer != m_entries[handle].layer || placed[handle].position != m_entries[handle].position)
+            moved.push_back(handle);
+    }
+
+    m_texture = texture;
+    m_entries = placed;
+    m_packers = packers;
+
+    m_liveCounts.assign(packers.size(), 0);
+    m_removedAreas.assign(packers.size(), 0);
+
+    for (const Handle handle : handles)
+        ++m_liveCounts[m_entries[handle].layer];
+
+    return moved;
+}
+
+Texture * TextureAtlas::texture() const
+{
+    return m_texture;
+}
+
+glm::ivec2 TextureAtlas::layerSize() const
+{
+    return m_layerSize;
+}
+
+GLsizei TextureAtlas::layers() const
+{
+    return static_cast<GLsizei>(m_packers.size());
+}
+
+std::size_t TextureAtlas::imageCount() const
+{
+    return m_entries.size() - m_freeHandles.size();
+}
+
+float TextureAtlas::occupancy() const
+{
+    long long used = 0;
+
+    for (std::size_t layer = 0; layer < m_packers.size(); ++layer)
+        used += m_packers[layer].usedArea() - m_removedAreas[layer];
+
+    return static_cast<float>(used) / (static_cast<float>(m_layerSize.x) * static_cast<float>(m_layerSize.y) * static_cast<float>(m_packers.size()));
+}
+
+float TextureAtlas::fragmentation() const
+{
+    long long placed = 0;
+    long long removed = 0;
+
+    for (std::size_t layer = 0; layer < m_packers.size(); ++layer)
+    {
+        placed += m_packers[layer].usedArea();
+        removed += m_removedAreas[layer];
+    }
+
+    return placed > 0 ? static_cast<float>(removed) / static_cast<float>(placed) : 0.0f;
+}
+
+glm::ivec2 TextureAtlas::blockSize(const glm::ivec2 & size) const
+{
+    // aligned blocks keep their texels apart in all levels
+    return glm::ivec2(alignUp(size.x + 2 * m_padding, m_alignment), alignUp(size.y + 2 * m_padding, m_alignment));
+}
+
+bool TextureAtlas::place(const glm::ivec2 & block, GLint & layer, glm::ivec2 & position)
+{
+    for (std::size_t i = 0; i < m_packers.size(); ++i)
+    {
+        if (m_packers[i].insert(block, position))
+        {
+            layer = static_cast<GLint>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Texture * TextureAtlas::createTexture(const GLsizei layers) const
+{
+    Texture * texture = new Texture(GL_TEXTURE_2D_ARRAY);
+
+    texture->setParameter(GL_TEXTURE_MIN_FILTER, static_cast<GLint>(m_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    texture->setParameter(GL_TEXTURE_MAG_FILTER, static_cast<GLint>(GL_LINEAR));
+    texture->setParameter(GL_TEXTURE_WRAP_S, static_cast<GLint>(GL_CLAMP_TO_EDGE));
+    texture->setParameter(GL_TEXTURE_WRAP_T, static_cast<GLint>(GL_CLAMP_TO_EDGE));
+
+    texture->storage3D(m_levels, m_internalFormat, m_layerSize.x, m_layerSize.y, layers);
+
+    return texture;
+}
+
+void TextureAtlas::grow()
+{
+    const GLsizei layers = static_cast<GLsizei>(m_packers.size());
+
+    ref_ptr<Texture> texture = createTexture(layers * 2);
+
+    for (GLint level = 0; level < m_levels; ++level)
+    {
+        glCopyImageSubData(m_texture->id(), GL_TEXTURE_2D_ARRAY, level, 0, 0, 0
+            , texture->id(), GL_TEXTURE_2D_ARRAY, level, 0, 0, 0
+            , std::max(m_layerSize.x >> level, 1), std::max(m_layerSize.y >> level, 1), layers);
+    }
+
+    m_texture = texture;
+
+    m_packers.resize(layers * 2, SkylinePacker(m_layerSize));
+    m_liveCounts.resize(layers * 2, 0);
+    m_removedAreas.resize(layers * 2, 0);
+}
+
+void TextureAtlas::copy(Texture * destination, const Entry & from, const Entry & to) const
+{
+    const glm::ivec2 block = blockSize(from.size);
+
+    for (GLint level = 0; level < m_levels; ++level)
+    {
+        glCopyImageSubData(m_texture->id(), GL_TEXTURE_2D_ARRAY, level, from.position.x >> level, from.position.y >> level, from.layer
+            , destination->id(), GL_TEXTURE_2D_ARRAY, level, to.position.x >> level, to.position.y >> level, to.layer
+            , block.x >> level, block.y >> level, 1);
+    }
+}
+
+} // namespace globjects
@@ -0,0 +1,769 @@
+#include <globjects/TextureFile.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Buffer.h>
+#include <globjects/Texture.h>
+
+using namespace gl;
+
+namespace
+{
+
+struct FormatInfo
+{
+    std::uint32_t code;
+    GLenum internalFormat;
+    GLenum format;
+    GLenum type;
+    int blockWidth;
+    int blockHeight;
+    int blockByteSize;
+};
+
+// keyed by VkFormat
+const FormatInfo c_vulkanFormats[] = {
+    {   9, GL_R8,             GL_RED,  GL_UNSIGNED_BYTE, 1, 1,  1 },
+    {  16, GL_RG8,            GL_RG,   GL_UNSIGNED_BYTE, 1, 1,  2 },
+    {  23, GL_RGB8,           GL_RGB,  GL_UNSIGNED_BYTE, 1, 1,  3 },
+    {  29, GL_SRGB8,          GL_RGB,  GL_UNSIGNED_BYTE, 1, 1,  3 },
+    {  30, GL_RGB8,           GL_BGR,  GL_UNSIGNED_BYTE, 1, 1,  3 },
+    {  37, GL_RGBA8,          GL_RGBA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    {  43, GL_SRGB8_ALPHA8,   GL_RGBA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    {  44, GL_RGBA8,          GL_BGRA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    {  50, GL_SRGB8_ALPHA8,   GL_BGRA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    {  76, GL_R16F,           GL_RED,  GL_HALF_FLOAT,    1, 1,  2 },
+    {  83, GL_RG16F,          GL_RG,   GL_HALF_FLOAT,    1, 1,  4 },
+    {  97, GL_RGBA16F,        GL_RGBA, GL_HALF_FLOAT,    1, 1,  8 },
+    { 100, GL_R32F,           GL_RED,  GL_FLOAT,         1, 1,  4 },
+    { 103, GL_RG32F,          GL_RG,   GL_FLOAT,         1, 1,  8 },
+    { 109, GL_RGBA32F,        GL_RGBA, GL_FLOAT,         1, 1, 16 },
+    { 122, GL_R11F_G11F_B10F, GL_RGB,  GL_UNSIGNED_INT_10F_11F_11F_REV, 1, 1, 4 },
+    { 123, GL_RGB9_E5,        GL_RGB,  GL_UNSIGNED_INT_5_9_9_9_REV,     1, 1, 4 },
+    { 131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,              GL_COMPRESSED_RGB_S3TC_DXT1_EXT,              GL_NONE, 4, 4,  8 },
+    { 132, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,             GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,             GL_NONE, 4, 4,  8 },
+    { 133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,             GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,             GL_NONE, 4, 4,  8 },
+    { 134, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,       GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,       GL_NONE, 4, 4,  8 },
+    { 135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,             GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,             GL_NONE, 4, 4, 16 },
+    { 136, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,       GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,       GL_NONE, 4, 4, 16 },
+    { 137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,             GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,             GL_NONE, 4, 4, 16 },
+    { 138, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,       GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,       GL_NONE, 4, 4, 16 },
+    { 139, GL_COMPRESSED_RED_RGTC1,                      GL_COMPRESSED_RED_RGTC1,                      GL_NONE, 4, 4,  8 },
+    { 140, GL_COMPRESSED_SIGNED_RED_RGTC1,               GL_COMPRESSED_SIGNED_RED_RGTC1,               GL_NONE, 4, 4,  8 },
+    { 141, GL_COMPRESSED_RG_RGTC2,                       GL_COMPRESSED_RG_RGTC2,                       GL_NONE, 4, 4, 16 },
+    { 142, GL_COMPRESSED_SIGNED_RG_RGTC2,                GL_COMPRESSED_SIGNED_RG_RGTC2,                GL_NONE, 4, 4, 16 },
+    { 143, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,        GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,        GL_NONE, 4, 4, 16 },
+    { 144, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,          GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,          GL_NONE, 4, 4, 16 },
+    { 145, GL_COMPRESSED_RGBA_BPTC_UNORM,                GL_COMPRESSED_RGBA_BPTC_UNORM,                GL_NONE, 4, 4, 16 },
+    { 146, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,          GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,          GL_NONE, 4, 4, 16 },
+    { 147, GL_COMPRESSED_RGB8_ETC2,                      GL_COMPRESSED_RGB8_ETC2,                      GL_NONE, 4, 4,  8 },
+    { 148, GL_COMPRESSED_SRGB8_ETC2,                     GL_COMPRESSED_SRGB8_ETC2,                     GL_NONE, 4, 4,  8 },
+    { 149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,  GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,  GL_NONE, 4, 4,  8 },
+    { 150, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, GL_NONE, 4, 4,  8 },
+    { 151, GL_COMPRESSED_RGBA8_ETC2_EAC,                 GL_COMPRESSED_RGBA8_ETC2_EAC,                 GL_NONE, 4, 4, 16 },
+    { 152, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,          GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,          GL_NONE, 4, 4, 16 },
+    { 157, GL_COMPRESSED_RGBA_ASTC_4x4_KHR,              GL_COMPRESSED_RGBA_ASTC_4x4_KHR,              GL_NONE, 4, 4, 16 },
+    { 158, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR,      GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR,      GL_NONE, 4, 4, 16 }
+};
+
+// keyed by DXGI_FORMAT
+const FormatInfo c_dxgiFormats[] = {
+    {  2, GL_RGBA32F,        GL_RGBA, GL_FLOAT,         1, 1, 16 },
+    { 10, GL_RGBA16F,        GL_RGBA, GL_HALF_FLOAT,    1, 1,  8 },
+    { 16, GL_RG32F,          GL_RG,   GL_FLOAT,         1, 1,  8 },
+    { 26, GL_R11F_G11F_B10F, GL_RGB,  GL_UNSIGNED_INT_10F_11F_11F_REV, 1, 1, 4 },
+    { 28, GL_RGBA8,          GL_RGBA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    { 29, GL_SRGB8_ALPHA8,   GL_RGBA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    { 34, GL_RG16F,          GL_RG,   GL_HALF_FLOAT,    1, 1,  4 },
+    { 41, GL_R32F,           GL_RED,  GL_FLOAT,         1, 1,  4 },
+    { 49, GL_RG8,            GL_RG,   GL_UNSIGNED_BYTE, 1, 1,  2 },
+    { 54, GL_R16F,           GL_RED,  GL_HALF_FLOAT,    1, 1,  2 },
+    { 61, GL_R8,             GL_RED,  GL_UNSIGNED_BYTE, 1, 1,  1 },
+    { 67, GL_RGB9_E5,        GL_RGB,  GL_UNSIGNED_INT_5_9_9_9_REV, 1, 1, 4 },
+    { 71, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,       GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,       GL_NONE, 4, 4,  8 },
+    { 72, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_NONE, 4, 4,  8 },
+    { 74, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,       GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,       GL_NONE, 4, 4, 16 },
+    { 75, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_NONE, 4, 4, 16 },
+    { 77, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,       GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,       GL_NONE, 4, 4, 16 },
+    { 78, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_NONE, 4, 4, 16 },
+    { 80, GL_COMPRESSED_RED_RGTC1,                GL_COMPRESSED_RED_RGTC1,                GL_NONE, 4, 4,  8 },
+    { 81, GL_COMPRESSED_SIGNED_RED_RGTC1,         GL_COMPRESSED_SIGNED_RED_RGTC1,         GL_NONE, 4, 4,  8 },
+    { 83, GL_COMPRESSED_RG_RGTC2,                 GL_COMPRESSED_RG_RGTC2,                 GL_NONE, 4, 4, 16 },
+    { 84, GL_COMPRESSED_SIGNED_RG_RGTC2,          GL_COMPRESSED_SIGNED_RG_RGTC2,          GL_NONE, 4, 4, 16 },
+    { 87, GL_RGBA8,          GL_BGRA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    { 91, GL_SRGB8_ALPHA8,   GL_BGRA, GL_UNSIGNED_BYTE, 1, 1,  4 },
+    { 95, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,  GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,  GL_NONE, 4, 4, 16 },
+    { 96, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,    GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,    GL_NONE, 4, 4, 16 },
+    { 98, GL_COMPRESSED_RGBA_BPTC_UNORM,          GL_COMPRESSED_RGBA_BPTC_UNORM,          GL_NONE, 4, 4, 16 },
+    { 99, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,    GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,    GL_NONE, 4, 4, 16 }
+};
+
+const unsigned char c_ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+const std::size_t c_ktx2LevelIndexOffset = 80;
+const std::size_t c_ktx2LevelIndexEntrySize = 24;
+
+const std::size_t c_ddsHeaderSize = 128;        // including the magic number
+const std::size_t c_ddsHeaderDX10Size = 148;
+
+const std::uint32_t c_ddsPixelFormatFourCC = 0x4;
+const std::uint32_t c_ddsPixelFormatRGB = 0x40;
+const std::uint32_t c_ddsPixelFormatLuminance = 0x20000;
+const std::uint32_t c_ddsCaps2CubeMap = 0x200;
+const std::uint32_t c_ddsCaps2Volume = 0x200000;
+const std::uint32_t c_ddsMiscTextureCube = 0x4;
+const std::uint32_t c_ddsDimensionTexture1D = 2;
+const std::uint32_t c_ddsDimensionTexture3D = 4;
+
+std::uint32_t fourCC(const char a, const char b, const char c, const char d)
+{
+    return static_cast<std::uint32_t>(a) | static_cast<std::uint32_t>(b) << 8 | static_cast<std::uint32_t>(c) << 16 | static_cast<std::uint32_t>(d) << 24;
+}
+
+// both containers are little endian, as are all supported platforms
+std::uint32_t read32(const unsigned char * data, const std::size_t offset)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+
+    return value;
+}
+
+std::uint64_t read64(const unsigned char * data, const std::size_t offset)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+
+    return value;
+}
+
+template <std::size_t Count>
+const FormatInfo * findFormat(const FormatInfo (&formats)[Count], const std::uint32_t code)
+{
+    for (const FormatInfo & info : formats)
+    {
+        if (info.code == code)
+            return &info;
+    }
+
+    return nullptr;
+}
+
+// maps pre-DX10 pixel formats to their DXGI equivalent, 0 if unsupported
+std::uint32_t legacyDXGIFormat(const unsigned char * header)
+{
+    const std::uint32_t flags = read32(header, 80);
+    const std::uint32_t code = read32(header, 84);
+    const std::uint32_t bitCount = read32(header, 88);
+    const std::uint32_t redMask = read32(header, 92);
+
+    if (flags & c_ddsPixelFormatFourCC)
+    {
+        if (code == fourCC('D', 'X', 'T', '1'))
+            return 71;
+        if (code == fourCC('D', 'X', 'T', '2') || code == fourCC('D', 'X', 'T', '3'))
+            return 74;
+        if (code == fourCC('D', 'X', 'T', '4') || code == fourCC('D', 'X', 'T', '5'))
+            return 77;
+        if (code == fourCC('A', 'T', 'I', '1') || code == fourCC('B', 'C', '4', 'U'))
+            return 80;
+        if (code == fourCC('B', 'C', '4', 'S'))
+            return 81;
+        if (code == fourCC('A', 'T', 'I', '2') || code == fourCC('B', 'C', '5', 'U'))
+            return 83;
+        if (code == fourCC('B', 'C', '5', 'S'))
+            return 84;
+
+        // D3DFMT values of float formats
+        switch (code)
+        {
+        case 111: return 54;
+        case 112: return 34;
+        case 113: return 10;
+        case 114: return 41;
+        case 115: return 16;
+        case 116: return 2;
+        default:  return 0;
+        }
+    }
+
+    if ((flags & c_ddsPixelFormatRGB) && bitCount == 32)
+    {
+        if (redMask == 0x000000ff)
+            return 28;
+        if (redMask == 0x00ff0000)
+            return 87;
+    }
+
+    if ((flags & c_ddsPixelFormatLuminance) && bitCount == 8)
+        return 61;
+
+    return 0;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+TextureFile::TextureFile(const std::string & filePath)
+: m_data(nullptr)
+, m_size(0)
+, m_mapped(false)
+, m_container(Container::None)
+, m_target(GL_NONE)
+, m_internalFormat(GL_NONE)
+, m_format(GL_NONE)
+, m_type(GL_NONE)
+, m_blockSize(1)
+, m_blockByteSize(0)
+, m_extent(0)
+, m_levels(0)
+, m_layers(0)
+, m_generateMipmaps(false)
+{
+    if (!map(filePath))
+    {
+        warning() << "Could not map texture file " << filePath;
+        return;
+    }
+
+    parse();
+
+    if (!isValid())
+        warning() << "Unsupported texture file " << filePath;
+}
+
+TextureFile::TextureFile(const void * data, const std::size_t size)
+: m_data(static_cast<const unsigned char *>(data))
+, m_size(size)
+, m_mapped(false)
+, m_container(Container::None)
+, m_target(GL_NONE)
+, m_internalFormat(GL_NONE)
+, m_format(GL_NONE)
+, m_type(GL_NONE)
+, m_blockSize(1)
+, m_blockByteSize(0)
+, m_extent(0)
+, m_levels(0)
+, m_layers(0)
+, m_generateMipmaps(false)
+{
+    parse();
+}
+
+TextureFile::~TextureFile()
+{
+    unmap();
+}
+
+bool TextureFile::map(const std::string & filePath)
+{
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+        return false;
+
+    // the view keeps the mapping alive
+    const void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!view)
+        return false;
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int file = open(filePath.c_str(), O_RDONLY);
+
+    if (file < 0)
+        return false;
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void * view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    m_size = static_cast<std::size_t>(status.st_size);
+
+    // all of the file is read front to back during upload
+    // the advice values are not flags and cannot be combined
+    posix_madvise(view, m_size, POSIX_MADV_SEQUENTIAL);
+    posix_madvise(view, m_size, POSIX_MADV_WILLNEED);
+#endif
+
+    m_data = static_cast<const unsigned char *>(view);
+    m_mapped = true;
+
+    return true;
+}
+
+void TextureFile::unmap()
+{
+    if (!m_mapped)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<unsigned char *>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+void TextureFile::parse()
+{
+    if (parseKTX2())
+        m_container = Container::KTX2;
+    else if (parseDDS())
+        m_container = Container::DDS;
+    else
+        m_images.clear();
+}
+
+bool TextureFile::parseKTX2()
+{
+    if (m_size < c_ktx2LevelIndexOffset || std::memcmp(m_data, c_ktx2Identifier, sizeof(c_ktx2Identifier)) != 0)
+        return false;
+
+    const std::uint32_t vkFormat = read32(m_data, 12);
+    const std::uint32_t width = read32(m_data, 20);
+    const std::uint32_t height = read32(m_data, 24);
+    const std::uint32_t depth = read32(m_data, 28);
+    const std::uint32_t layerCount = read32(m_data, 32);
+    const std::uint32_t faceCount = read32(m_data, 36);
+    const std::uint32_t levelCount = read32(m_data, 40);
+    const std::uint32_t supercompressionScheme = read32(m_data, 44);
+
+    if (supercompressionScheme != 0 || width == 0 || (faceCount != 1 && faceCount != 6))
+        return false;
+
+    const FormatInfo * info = findFormat(c_vulkanFormats, vkFormat);
+
+    if (!info)
+        return false;
+
+    m_internalFormat = info->internalFormat;
+    m_format = info->format;
+    m_type = info->type;
+    m_blockSize = glm::ivec2(info->blockWidth, info->blockHeight);
+    m_blockByteSize = static_cast<std::size_t>(info->blockByteSize);
+
+    m_extent = glm::ivec3(width, std::max(height, 1u), std::max(depth, 1u));
+
+    if (!setTarget(depth > 0, faceCount == 6, height == 0, layerCount > 0, std::max(layerCount, 1u)))
+        return false;
+
+    const std::uint32_t indexedLevels = std::max(levelCount, 1u);
+
+    if (m_size < c_ktx2LevelIndexOffset + indexedLevels * c_ktx2LevelIndexEntrySize)
+        return false;
+
+    m_generateMipmaps = levelCount == 0;
+
+    if (m_generateMipmaps)
+    {
+        const int maximum = std::max(m_extent.x, std::max(m_extent.y, m_extent.z));
+
+        m_levels = 1;
+        while (maximum >> m_levels)
+            ++m_levels;
+    }
+    else
+    {
+        m_levels = static_cast<GLsizei>(levelCount);
+    }
+
+    // levels are stored consecutively, each with all layers, faces and slices
+    for (std::uint32_t level = 0; level < indexedLevels; ++level)
+    {
+        const std::size_t offset = static_cast<std::size_t>(read64(m_data, c_ktx2LevelIndexOffset + level * c_ktx2LevelIndexEntrySize));
+
+        glm::ivec3 size(std::max(m_extent.x >> level, 1), std::max(m_extent.y >> level, 1), std::max(m_extent.z >> level, 1));
+
+        if (m_target == GL_TEXTURE_CUBE_MAP)
+        {
+            for (GLint face = 0; face < 6; ++face)
+            {
+                if (!addImage(level, face, size, offset + face * imageByteSize(size)))
+                    return false;
+            }
+
+            continue;
+        }
+
+        if (m_target != GL_TEXTURE_3D)
+            size.z = m_layers;
+
+        if (!addImage(level, 0, size, offset))
+            return false;
+    }
+
+    return true;
+}
+
+bool TextureFile::parseDDS()
+{
+    if (m_size < c_ddsHeaderSize || read32(m_data, 0) != fourCC('D', 'D', 'S', ' ') || read32(m_data, 4) != 124)
+        return false;
+
+    const std::uint32_t height = read32(m_data, 12);
+    const std::uint32_t width = read32(m_data, 16);
+    const std::uint32_t depth = read32(m_data, 24);
+    const std::uint32_t mipMapCount = read32(m_data, 28);
+    const std::uint32_t caps2 = read32(m_data, 112);
+
+    bool volume = (caps2 & c_ddsCaps2Volume) != 0;
+    bool cubeMap = (caps2 & c_ddsCaps2CubeMap) != 0;
+    bool oneDimensional = false;
+    std::uint32_t arraySize = 1;
+
+    std::uint32_t dxgiFormat = legacyDXGIFormat(m_data);
+    std::size_t offset = c_ddsHeaderSize;
+
+    if ((read32(m_data, 80) & c_ddsPixelFormatFourCC) && read32(m_data, 84) == fourCC('D', 'X', '1', '0'))
+    {
+        if (m_size < c_ddsHeaderDX10Size)
+            return false;
+
+        dxgiFormat = read32(m_data, 128);
+
+        const std::uint32_t dimension = read32(m_data, 132);
+
+        volume = dimension == c_ddsDimensionTexture3D;
+        oneDimensional = dimension == c_ddsDimensionTexture1D;
+        cubeMap = (read32(m_data, 136) & c_ddsMiscTextureCube) != 0;
+        arraySize = std::max(read32(m_data, 140), 1u);
+
+        offset = c_ddsHeaderDX10Size;
+    }
+
+    const FormatInfo * info = findFormat(c_dxgiFormats, dxgiFormat);
+
+    if (!info || width == 0)
+        return false;
+
+    m_internalFormat = info->internalFormat;
+    m_format = info->format;
+    m_type = info->type;
+    m_blockSize = glm::ivec2(info->blockWidth, info->blockHeight);
+    m_blockByteSize = static_cast<std::size_t>(info->blockByteSize);
+
+    m_extent = glm::ivec3(width, oneDimensional ? 1u : std::max(height, 1u), volume ? std::max(depth, 1u) : 1u);
+    m_levels = static_cast<GLsizei>(std::max(mipMapCount, 1u));
+
+    if (!setTarget(volume, cubeMap, oneDimensional, arraySize > 1, arraySize))
+        return false;
+
+    const GLint faces = cubeMap ? 6 : 1;
+
+    // each layer and face is stored with all of its levels
+    for (GLint layer = 0; layer < static_cast<GLint>(arraySize); ++layer)
+    {
+        for (GLint face = 0; face < faces; ++face)
+        {
+            for (GLint level = 0; level < m_levels; ++level)
+            {
+                const glm::ivec3 size(std::max(m_extent.x >> level, 1), std::max(m_extent.y >> level, 1), std::max(m_extent.z >> level, 1));
+
+                if (!addImage(level, layer * faces + face, size, offset))
+                    return false;
+
+                offset += imageByteSize(size);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TextureFile::setTarget(const bool volume, const bool cubeMap, const bool oneDimensional, const bool array, const GLsizei layers)
+{
+    if (volume)
+    {
+        if (cubeMap || oneDimensional || array)
+            return false;
+
+        m_target = GL_TEXTURE_3D;
+        m_layers = 1;
+    }
+    else if (cubeMap)
+    {
+        m_target = array ? GL_TEXTURE_CUBE_MAP_ARRAY : GL_TEXTURE_CUBE_MAP;
+        m_layers = layers * 6;
+    }
+    else if (oneDimensional)
+    {
+        // there are no compressed 1D formats
+        if (m_blockSize != glm::ivec2(1))
+            return false;
+
+        m_target = array ? GL_TEXTURE_1D_ARRAY : GL_TEXTURE_1D;
+        m_layers = layers;
+    }
+    else
+    {
+        m_target = array ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+        m_layers = layers;
+    }
+
+    return true;
+}
+
+std::size_t TextureFile::imageByteSize(const glm::ivec3 & size) const
+{
+    const std::size_t blocksX = static_cast<std::size_t>((size.x + m_blockSize.x - 1) / m_blockSize.x);
+    const std::size_t blocksY = static_cast<std::size_t>((size.y + m_blockSize.y - 1) / m_blockSize.y);
+
+    return blocksX * blocksY * static_cast<std::size_t>(size.z) * m_blockByteSize;
+}
+
+bool TextureFile::addImage(const GLint level, const GLint layer, const glm::ivec3 & size, const std::size_t offset)
+{
+    const std::size_t byteSize = imageByteSize(size);
+
+    if (offset > m_size || byteSize > m_size - offset)
+        return false;
+
+    Image image;
+    image.level = level;
+    image.layer = layer;
+    image.size = size;
+    image.offset = offset;
+    image.byteSize = byteSize;
+
+    m_images.push_back(image);
+
+    return true;
+}
+
+bool TextureFile::isValid() const
+{
+    return m_container != Container::None;
+}
+
+TextureFile::Container TextureFile::container() const
+{
+    return m_container;
+}
+
+GLenum TextureFile::target() const
+{
+    return m_target;
+}
+
+GLenum TextureFile::internalFormat() const
+{
+    return m_internalFormat;
+}
+
+GLenum TextureFile::format() const
+{
+    return m_format;
+}
+
+GLenum TextureFile::type() const
+{
+    return m_type;
+}
+
+bool TextureFile::isCompressed() const
+{
+    return m_blockSize != glm::ivec2(1);
+}
+
+glm::ivec3 TextureFile::size() const
+{
+    return m_extent;
+}
+
+GLsizei TextureFile::levels() const
+{
+    return m_levels;
+}
+
+GLsizei TextureFile::layers() const
+{
+    return m_layers;
+}
+
+bool TextureFile::generatesMipmaps() const
+{
+    return m_generateMipmaps;
+}
+
+const std::vector<TextureFile::Image> & TextureFile::images() const
+{
+    return m_images;
+}
+
+const unsigned char * TextureFile::data() const
+{
+    return m_data;
+}
+
+std::size_t TextureFile::byteSize() const
+{
+    return m_size;
+}
+
+Texture * TextureFile::createTexture(Buffer * unpackBuffer) const
+{
+    if (!isValid())
+        return nullptr;
+
+    Texture * texture = new Texture(m_target);
+
+    allocate(texture);
+
+    if (unpackBuffer)
+    {
+        unpackBuffer->setData(static_cast<GLsizeiptr>(m_size), m_data, GL_STREAM_DRAW);
+        unpackBuffer->bind(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    // rows are tightly packed in both containers
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (const Image & image : m_images)
+    {
+        // with an unpack buffer bound, data pointers are offsets into it
+        const unsigned char * data = unpackBuffer ? reinterpret_cast<const unsigned char *>(image.offset) : m_data + image.offset;
+
+        upload(texture, image, data);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    if (unpackBuffer)
+        Buffer::unbind(GL_PIXEL_UNPACK_BUFFER);
+
+    if (m_generateMipmaps)
+        texture->generateMipmap();
+
+    return texture;
+}
+
+void TextureFile::allocate(Texture * texture) const
+{
+    switch (m_target)
+    {
+    case GL_TEXTURE_1D:
+        texture->storage1D(m_levels, m_internalFormat, m_extent.x);
+        break;
+
+    case GL_TEXTURE_1D_ARRAY:
+        texture->storage2D(m_levels, m_internalFormat, m_extent.x, m_layers);
+        break;
+
+    case GL_TEXTURE_2D:
+    case GL_TEXTURE_CUBE_MAP:
+        texture->storage2D(m_levels, m_internalFormat, m_extent.x, m_extent.y);
+        break;
+
+    case GL_TEXTURE_3D:
+        texture->storage3D(m_levels, m_internalFormat, m_extent);
+        break;
+
+    default:
+        texture->storage3D(m_levels, m_internalFormat, m_extent.x, m_extent.y, m_layers);
+        break;
+    }
+}
+
+void TextureFile::upload(Texture * texture, const Image & image, const unsigned char * data) const
+{
+    const bool compressed = isCompressed();
+    const GLsizei byteSize = static_cast<GLsizei>(image.byteSize);
+
+    switch (m_target)
+    {
+    case GL_TEXTURE_1D:
+        texture->subImage1D(image.level, 0, image.size.x, m_format, m_type, data);
+        break;
+
+    case GL_TEXTURE_1D_ARRAY:
+        texture->subImage2D(image.level, glm::ivec2(0, image.layer), glm::ivec2(image.size.x, image.size.z), m_format, m_type, data);
+        break;
+
+    case GL_TEXTURE_2D:
+        if (compressed)
+            texture->compressedSubImage2D(image.level, glm::ivec2(0), glm::ivec2(image.size.x, image.size.y), m_format, byteSize, data);
+        else
+            texture->subImage2D(image.level, glm::ivec2(0), glm::ivec2(image.size.x, image.size.y), m_format, m_type, data);
+        break;
+
+    case GL_TEXTURE_CUBE_MAP:
+        {
+            const GLenum face = static_cast<GLenum>(static_cast<unsigned int>(GL_TEXTURE_CUBE_MAP_POSITIVE_X) + image.layer);
+
+            texture->bind();
+
+            if (compressed)
+                glCompressedTexSubImage2D(face, image.level, 0, 0, image.size.x, image.size.y, m_format, byteSize, data);
+            else
+                glTexSubImage2D(face, image.level, 0, 0, image.size.x, image.size.y, m_format, m_type, data);
+        }
+        break;
+
+    default:
+        if (compressed)
+            texture->compressedSubImage3D(image.level, glm::ivec3(0, 0, image.layer), image.size, m_format, byteSize, data);
+        else
+            texture->subImage3D(image.level, glm::ivec3(0, 0, image.layer), image.size, m_format, m_type, data);
+        break;
+    }
+}
+
+} // namespace globjects
@@ -0,0 +1,399 @@
+#include <globjects/TextureLoader.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/MipChain.h>
+#include <globjects/Sync.h>
+#include <globjects/Texture.h>
+
+#include "registry/ImplementationRegistry.h"
+#include "registry/Registry.h"
+
+using namespace gl;
+
+namespace
+{
+
+const std::chrono::milliseconds c_finishInterval(1);
+
+bool isSRGB(const GLenum internalFormat)
+{
+    return internalFormat == GL_SRGB8 || internalFormat == GL_SRGB8_ALPHA8
+        || internalFormat == GL_SRGB || internalFormat == GL_SRGB_ALPHA;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+TextureLoader::TextureLoader(const Decoder & decoder, const unsigned int workerCount)
+: m_decoder(decoder)
+, m_contextId(glbinding::getCurrentContext())
+, m_pendingCount(0)
+, m_stopWorkers(false)
+, m_stopUpload(false)
+{
+    assert(decoder);
+
+    // the render and upload threads need a core each
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    const unsigned int count = workerCount > 0 ? workerCount : std::max(hardwareThreads, 2u) - 1;
+
+    for (unsigned int i = 0; i < count; ++i)
+        m_workers.emplace_back(&TextureLoader::decodeLoop, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWorkers = true;
+    }
+
+    m_decodeCondition.notify_all();
+
+    for (std::thread & worker : m_workers)
+        worker.join();
+
+    stopUploadThread();
+}
+
+void TextureLoader::load(const std::string & path, const Callback & callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Request request;
+        request.path = path;
+        request.callback = callback;
+        request.image.filterLevels = false;
+
+        m_decodeQueue.push_back(std::move(request));
+        ++m_pendingCount;
+    }
+
+    m_decodeCondition.notify_one();
+}
+
+void TextureLoader::startUploadThread(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent)
+{
+    assert(!hasUploadThread());
+
+    m_stopUpload = false;
+
+    // implementations are selected lazily per share group, so the upload thread finds them selected already
+    ImplementationRegistry::current().bufferImplementation();
+    ImplementationRegistry::current().objectNameImplementation();
+
+    m_uploadThread = std::thread(&TextureLoader::uploadLoop, this, makeCurrent, doneCurrent);
+}
+
+void TextureLoader::stopUploadThread()
+{
+    if (!hasUploadThread())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopUpload = true;
+    }
+
+    m_uploadCondition.notify_one();
+    m_uploadThread.join();
+}
+
+bool TextureLoader::hasUploadThread() const
+{
+    return m_uploadThread.joinable();
+}
+
+std::size_t TextureLoader::poll()
+{
+    if (!hasUploadThread())
+        uploadDecoded();
+
+    std::vector<Result> ready;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // uploads are independent, so any completed one is delivered
+        for (auto it = m_results.begin(); it != m_results.end();)
+        {
+            if (it->fence && it->fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                ++it;
+                continue;
+            }
+
+            ready.push_back(std::move(*it));
+            it = m_results.erase(it);
+        }
+
+        m_pendingCount -= ready.size();
+    }
+
+    for (const Result & result : ready)
+    {
+        if (result.callback)
+            result.callback(result.texture);
+    }
+
+    return ready.size();
+}
+
+void TextureLoader::finish()
+{
+    while (pendingCount() > 0)
+    {
+        if (poll() == 0)
+            std::this_thread::sleep_for(c_finishInterval);
+    }
+}
+
+std::size_t TextureLoader::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_pendingCount;
+}
+
+unsigned int TextureLoader::workerCount() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+void TextureLoader::decodeLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_decodeCondition.wait(lock, [this]() { return m_stopWorkers || !m_decodeQueue.empty(); });
+
+        if (m_stopWorkers)
+            return;
+
+        Request request = std::move(m_decodeQueue.front());
+        m_decodeQueue.pop_front();
+
+        lock.unlock();
+
+        const bool decoded = m_decoder(request.path, request.image);
+
+        if (decoded)
+            filterLevels(request);
+
+        lock.lock();
+
+        if (decoded)
+        {
+            m_uploadQueue.push_back(std::move(request));
+            m_uploadCondition.notify_one();
+        }
+        else
+        {
+            Result result;
+            result.callback = request.callback;
+
+            m_results.push_back(std::move(result));
+        }
+    }
+}
+
+void TextureLoader::uploadLoop(const ContextFunction & makeCurrent, const ContextFunction & doneCurrent)
+{
+    if (makeCurrent)
+        makeCurrent();
+
+    // objects created here belong to the render context's share group
+    registerCurrentContext(m_contextId);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_uploadCondition.wait(lock, [this]() { return m_stopUpload || !m_uploadQueue.empty(); });
+
+        if (m_stopUpload)
+            break;
+
+        Request request = std::move(m_uploadQueue.front());
+        m_uploadQueue.pop_front();
+
+        lock.unlock();
+
+        Result result = upload(request);
+
+        // the fence becomes visible to the render context only once it is flushed
+        glFlush();
+
+        lock.lock();
+
+        m_results.push_back(std::move(result));
+    }
+
+    lock.unlock();
+
+    m_staging = nullptr;
+
+    Registry::deregisterContext(glbinding::getCurrentContext());
+
+    if (doneCurrent)
+        doneCurrent();
+}
+
+void TextureLoader::uploadDecoded()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_uploadQueue.empty())
+    {
+        Request request = std::move(m_uploadQueue.front());
+        m_uploadQueue.pop_front();
+
+        lock.unlock();
+
+        Result result = upload(request);
+
+        lock.lock();
+
+        m_results.push_back(std::move(result));
+    }
+}
+
+void TextureLoader::filterLevels(Request & request)
+{
+    Image & image = request.image;
+
+    if (!image.filterLevels || image.levels <= 1)
+        return;
+
+    MipChain::Options options;
+    options.sRGB = isSRGB(image.internalFormat);
+    options.levels = image.levels;
+    options.threadCount = 1;    // the worker pool is parallel already
+
+    request.mipChain = new MipChain(image.data.data(), pixels::Layout(image.format, image.type, 1), image.size, options);
+
+    // the chain holds the first level as well
+    if (request.mipChain->isValid())
+    {
+        image.data.clear();
+        image.data.shrink_to_fit();
+    }
+    else
+    {
+        request.mipChain = nullptr;
+    }
+}
+
+TextureLoader::Result TextureLoader::upload(Request & request)
+{
+    const Image & image = request.image;
+
+    assert(image.levels > 0);
+
+    ref_ptr<Texture> texture = new Texture(GL_TEXTURE_2D);
+
+    texture->setParameter(GL_TEXTURE_MIN_FILTER, static_cast<GLint>(image.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    texture->setParameter(GL_TEXTURE_MAG_FILTER, static_cast<GLint>(GL_LINEAR));
+
+    texture->storage2D(image.levels, image.internalFormat, image.size);
+
+    const MipChain * mipChain = request.mipChain.get();
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(mipChain ? mipChain->byteSize() : image.data.size());
+
+    if (!m_staging)
+        m_staging = new Buffer;
+
+    // reallocating orphans the storage of the previous upload, which may still be read
+    m_staging->setData(size, nullptr, GL_STREAM_DRAW);
+
+    void * mapped = m_staging->mapRange(0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (mapped)
+    {
+        if (mipChain)
+            uploadLevels(texture, *mipChain, static_cast<unsigned char *>(mapped));
+        else
+            uploadImage(texture, image, mapped);
+
+        if (image.levels > 1 && !mipChain)
+            texture->generateMipmap();
+    }
+
+    // the decoded pixels are no longer needed
+    request.image.data.clear();
+    request.image.data.shrink_to_fit();
+    request.mipChain = nullptr;
+
+    Result result;
+    result.texture = mapped ? texture.get() : nullptr;
+    result.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    result.callback = request.callback;
+
+    return result;
+}
+
+void TextureLoader::uploadImage(Texture * texture, const Image & image, void * mapped)
+{
+    std::memcpy(mapped, image.data.data(), image.data.size());
+    m_staging->unmap();
+
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    m_staging->bind(GL_PIXEL_UNPACK_BUFFER);
+    texture->subImage2D(0, glm::ivec2(0), image.size, image.format, image.type, nullptr);
+    Buffer::unbind(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+void TextureLoader::uploadLevels(Texture * texture, const MipChain & mipChain, unsigned char * mapped)
+{
+    const std::vector<MipChain::Level> & levels = mipChain.levels();
+
+    std::size_t offset = 0;
+
+    for (const MipChain::Level & level : levels)
+    {
+        std::memcpy(mapped + offset, level.data.data(), level.data.size());
+        offset += level.data.size();
+    }
+
+    m_staging->unmap();
+
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, mipChain.layout().alignment);
+
+    m_staging->bind(GL_PIXEL_UNPACK_BUFFER);
+
+    offset = 0;
+
+    // with an unpack buffer bound, the data pointers are offsets into it
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        texture->subImage2D(static_cast<GLint>(i), glm::ivec2(0), levels[i].size, mipChain.layout().format, mipChain.layout().type, reinterpret_cast<const GLvoid *>(offset));
+        offset += levels[i].data.size();
+    }
+
+    Buffer::unbind(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+} // namespace globjects
@@ -0,0 +1,212 @@
+#include <globjects/UploadManager.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/StreamingBuffer.h>
+#include <globjects/Texture.h>
+
+using namespace gl;
+
+namespace
+{
+
+// offsets into unpack buffers have to be multiples of the component size
+const GLsizeiptr c_stagingAlignment = 16;
+
+} // namespace
+
+
+namespace globjects
+{
+
+UploadManager::UploadManager(const GLsizeiptr stagingSize)
+: m_staging(new StreamingBuffer(stagingSize))
+, m_pendingBytes(0)
+{
+}
+
+UploadManager::~UploadManager()
+{
+}
+
+UploadManager::Staging UploadManager::reserve(const GLsizeiptr size)
+{
+    assert(size > 0 && size <= m_staging->capacity());
+
+    const GLsizeiptr capacity = m_staging->capacity();
+    const unsigned long long begin = m_staging->nextPosition(size, c_stagingAlignment);
+
+    // queued regions must not be overwritten before their transfers are issued, so the queue is drained
+    bool drain = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const Request & request : m_requests)
+            drain |= overwrites(request.staging.mark, begin, size, capacity);
+    }
+
+    // issued transfers are fenced, so allocate() waits for the GPU to finish reading them
+    if (drain)
+        process();
+
+    const StreamingBuffer::Allocation allocation = m_staging->allocate(size, c_stagingAlignment);
+
+    const Staging staging = { allocation.data, allocation.offset, allocation.size, begin };
+    return staging;
+}
+
+bool UploadManager::overwrites(const unsigned long long queued, const unsigned long long begin, const GLsizeiptr size, const GLsizeiptr capacity)
+{
+    return begin + static_cast<unsigned long long>(size) > queued + static_cast<unsigned long long>(capacity);
+}
+
+void UploadManager::enqueue(const Staging & staging, Buffer * buffer, const GLintptr offset)
+{
+    assert(buffer != nullptr);
+
+    Request request;
+    request.staging = staging;
+    request.buffer = buffer;
+    request.bufferOffset = offset;
+
+    push(request);
+}
+
+void UploadManager::enqueue(const Staging & staging, Texture * texture, const GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, const GLenum format, const GLenum type)
+{
+    assert(texture != nullptr);
+
+    Request request;
+    request.staging = staging;
+    request.texture = texture;
+    request.level = level;
+    request.offset = offset;
+    request.size = size;
+    request.format = format;
+    request.type = type;
+
+    push(request);
+}
+
+void UploadManager::upload(Buffer * buffer, const GLintptr offset, const GLsizeiptr size, const void * data)
+{
+    const Staging staging = reserve(size);
+    std::memcpy(staging.data, data, static_cast<std::size_t>(size));
+
+    enqueue(staging, buffer, offset);
+}
+
+void UploadManager::upload(Texture * texture, const GLint level, const glm::ivec3 & offset, const glm::ivec3 & size, const GLenum format, const GLenum type, const GLsizeiptr dataSize, const void * data)
+{
+    const Staging staging = reserve(dataSize);
+    std::memcpy(staging.data, data, static_cast<std::size_t>(dataSize));
+
+    enqueue(staging, texture, level, offset, size, format, type);
+}
+
+GLsizeiptr UploadManager::process(const GLsizeiptr budget)
+{
+    std::deque<Request> batch;
+    GLsizeiptr bytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        while (!m_requests.empty() && (budget < 0 || bytes < budget))
+        {
+            bytes += m_requests.front().staging.size;
+
+            batch.push_back(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        m_pendingBytes -= bytes;
+    }
+
+    if (batch.empty())
+        return 0;
+
+    bool unpackBound = false;
+
+    for (const Request & request : batch)
+    {
+        if (request.texture && !unpackBound)
+        {
+            m_staging->buffer()->bind(GL_PIXEL_UNPACK_BUFFER);
+            unpackBound = true;
+        }
+
+        issue(request);
+    }
+
+    if (unpackBound)
+        Buffer::unbind(GL_PIXEL_UNPACK_BUFFER);
+
+    m_staging->fence();
+
+    return bytes;
+}
+
+void UploadManager::issue(const Request & request) const
+{
+    if (request.buffer)
+    {
+        m_staging->buffer()->copySubData(request.buffer, request.staging.offset, request.bufferOffset, request.staging.size);
+        return;
+    }
+
+    // with an unpack buffer bound, the data pointer is an offset into it
+    const void * data = reinterpret_cast<const void *>(request.staging.offset);
+
+    Texture * texture = request.texture;
+
+    switch (texture->target())
+    {
+    case GL_TEXTURE_1D:
+        texture->subImage1D(request.level, request.offset.x, request.size.x, request.format, request.type, data);
+        break;
+
+    case GL_TEXTURE_3D:
+    case GL_TEXTURE_2D_ARRAY:
+    case GL_TEXTURE_CUBE_MAP_ARRAY:
+        texture->subImage3D(request.level, request.offset, request.size, request.format, request.type, data);
+        break;
+
+    default:
+        texture->subImage2D(request.level, glm::ivec2(request.offset.x, request.offset.y), glm::ivec2(request.size.x, request.size.y), request.format, request.type, data);
+        break;
+    }
+}
+
+void UploadManager::push(const Request & request)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_requests.push_back(request);
+    m_pendingBytes += request.staging.size;
+}
+
+std::size_t UploadManager::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_requests.size();
+}
+
+GLsizeiptr UploadManager::pendingBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_pendingBytes;
+}
+
+StreamingBuffer * UploadManager::staging() const
+{
+    return m_staging;
+}
+
+} // namespace globjects
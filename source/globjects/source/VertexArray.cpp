@@ -9,6 +9,7 @@
 #include <globjects/VertexAttributeBinding.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/BindingRegistry.h"
 #include "implementations/AbstractVertexAttributeBindingImplementation.h"
 
 #include "container_helpers.hpp"
@@ -66,12 +67,12 @@ void VertexArray::accept(ObjectVisitor & visitor)
 
 void VertexArray::bind() const
 {
-	glBindVertexArray(id());
+	BindingRegistry::current().bindVertexArray(id());
 }
 
 void VertexArray::unbind()
 {
-	glBindVertexArray(0);
+	BindingRegistry::current().bindVertexArray(0);
 }
 
 VertexAttributeBinding * VertexArray::binding(const GLuint bindingIndex)
@@ -160,6 +161,12 @@ void VertexArray::multiDrawArraysIndirect(const GLenum mode, const void* indirec
     glMultiDrawArraysIndirect(mode, indirect, drawCount, stride);
 }
 
+void VertexArray::multiDrawArraysIndirectCount(const GLenum mode, const void* indirect, const GLintptr drawCount, const GLsizei maxDrawCount, const GLsizei stride) const
+{
+    bind();
+    glMultiDrawArraysIndirectCountARB(mode, indirect, drawCount, maxDrawCount, stride);
+}
+
 void VertexArray::drawElements(const GLenum mode, const GLsizei count, const GLenum type, const void * indices) const
 {
     bind();
@@ -214,6 +221,12 @@ void VertexArray::multiDrawElementsIndirect(const GLenum mode, const GLenum type
     glMultiDrawElementsIndirect(mode, type, indirect, drawCount, stride);
 }
 
+void VertexArray::multiDrawElementsIndirectCount(const GLenum mode, const GLenum type, const void* indirect, const GLintptr drawCount, const GLsizei maxDrawCount, const GLsizei stride) const
+{
+    bind();
+    glMultiDrawElementsIndirectCountARB(mode, type, indirect, drawCount, maxDrawCount, stride);
+}
+
 void VertexArray::drawRangeElements(const GLenum mode, const GLuint start, const GLuint end, const GLsizei count, const GLenum type, const void* indices) const
 {
     bind();
@@ -2,6 +2,7 @@
 
 #include <cassert>
 
+#include <globjects/BufferRange.h>
 #include <globjects/VertexArray.h>
 #include <globjects/globjects.h>
 
@@ -82,6 +83,11 @@ void VertexAttributeBinding::setBuffer(const Buffer * vbo, const GLint baseoffse
     attributeImplementation().bindBuffer(this, vbo, baseoffset, stride);
 }
 
+void VertexAttributeBinding::setBuffer(const BufferRange & range, const GLint stride)
+{
+    setBuffer(range.buffer, static_cast<GLint>(range.offset), stride);
+}
+
 void VertexAttributeBinding::setFormat(const GLint size, const GLenum type, const GLboolean normalized, const GLuint relativeoffset)
 {
     attributeImplementation().setFormat(this, size, type, normalized, relativeoffset);
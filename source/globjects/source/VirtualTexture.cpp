@@ -0,0 +1,565 @@
+#include <globjects/VirtualTexture.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/boolean.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/ReadbackQueue.h>
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+
+using namespace gl;
+
+namespace
+{
+
+const char * s_feedbackShaderSource = R"(
+{
+    uint virtualPageRequests[];
+};
+
+uniform ivec2 virtualPageSize;
+uniform int virtualSparseLevels;
+
+void requestVirtualPage(sampler2D virtualTexture, vec2 uv)
+{
+    int level = int(floor(textureQueryLod(virtualTexture, uv).x));
+
+    // the mip tail is always resident
+    if (level >= virtualSparseLevels)
+        return;
+
+    int first = 0;
+    for (int l = 0; l < level; ++l)
+    {
+        ivec2 count = (textureSize(virtualTexture, l) + virtualPageSize - 1) / virtualPageSize;
+        first += count.x * count.y;
+    }
+
+    ivec2 levelSize = textureSize(virtualTexture, level);
+    ivec2 count = (levelSize + virtualPageSize - 1) / virtualPageSize;
+    ivec2 page = clamp(ivec2(fract(uv) * vec2(levelSize)) / virtualPageSize, ivec2(0), count - 1);
+
+    virtualPageRequests[first + page.y * count.x + page.x] = 1u;
+}
+)";
+
+const gl::GLsizeiptr c_defaultUploadBudget = 4 << 20;
+const std::size_t c_defaultMaxCommittedPages = 4096;
+const unsigned int c_defaultRetainFrames = 30;
+
+} // namespace
+
+
+namespace globjects
+{
+
+VirtualPageTable::VirtualPageTable()
+: VirtualPageTable(glm::ivec2(1), glm::ivec2(1), 0)
+{
+}
+
+VirtualPageTable::VirtualPageTable(const glm::ivec2 & size, const glm::ivec2 & pageSize, const GLint levels)
+: m_size(size)
+, m_pageSize(pageSize)
+, m_committedCount(0)
+{
+    assert(pageSize.x > 0 && pageSize.y > 0);
+
+    std::size_t offset = 0;
+
+    for (GLint level = 0; level < levels; ++level)
+    {
+        m_levelOffsets.push_back(offset);
+
+        const glm::ivec2 count = pageCount(level);
+        offset += static_cast<std::size_t>(count.x) * count.y;
+    }
+
+    m_levelOffsets.push_back(offset);
+
+    m_entries.resize(offset, { 0, false, false, 0 });
+}
+
+GLint VirtualPageTable::levels() const
+{
+    return static_cast<GLint>(m_levelOffsets.size()) - 1;
+}
+
+glm::ivec2 VirtualPageTable::pageSize() const
+{
+    return m_pageSize;
+}
+
+glm::ivec2 VirtualPageTable::levelSize(const GLint level) const
+{
+    return glm::max(glm::ivec2(m_size.x >> level, m_size.y >> level), glm::ivec2(1));
+}
+
+glm::ivec2 VirtualPageTable::pageCount(const GLint level) const
+{
+    return (levelSize(level) + m_pageSize - glm::ivec2(1)) / m_pageSize;
+}
+
+std::size_t VirtualPageTable::size() const
+{
+    return m_entries.size();
+}
+
+std::size_t VirtualPageTable::index(const Page & page) const
+{
+    assert(page.level >= 0 && page.level < levels());
+
+    return m_levelOffsets[page.level] + static_cast<std::size_t>(page.y) * pageCount(page.level).x + page.x;
+}
+
+VirtualPageTable::Page VirtualPageTable::page(const std::size_t index) const
+{
+    assert(index < size());
+
+    // the level is the last one starting at or before index
+    const auto next = std::upper_bound(m_levelOffsets.begin(), m_levelOffsets.end(), index);
+    const GLint level = static_cast<GLint>(next - m_levelOffsets.begin()) - 1;
+
+    const GLint local = static_cast<GLint>(index - m_levelOffsets[level]);
+    const GLint columns = pageCount(level).x;
+
+    return { level, local % columns, local / columns };
+}
+
+glm::ivec2 VirtualPageTable::offset(const Page & page) const
+{
+    return glm::ivec2(page.x, page.y) * m_pageSize;
+}
+
+glm::ivec2 VirtualPageTable::extent(const Page & page) const
+{
+    return glm::min(m_pageSize, levelSize(page.level) - offset(page));
+}
+
+void VirtualPageTable::acquire(const Page & page)
+{
+    ++m_entries[index(page)].refCount;
+}
+
+void VirtualPageTable::release(const Page & page)
+{
+    Entry & entry = m_entries[index(page)];
+
+    assert(entry.refCount > 0);
+
+    --entry.refCount;
+}
+
+unsigned int VirtualPageTable::refCount(const Page & page) const
+{
+    return m_entries[index(page)].refCount;
+}
+
+void VirtualPageTable::request(const Page & page, const unsigned long long frame)
+{
+    Page current = page;
+
+    // the covering pages of coarser levels are at half the page coordinates
+    for (; current.level < levels(); ++current.level, current.x /= 2, current.y /= 2)
+    {
+        Entry & entry = m_entries[index(current)];
+
+        if (entry.requested && entry.lastRequest >= frame)
+            break;
+
+        entry.requested = true;
+        entry.lastRequest = frame;
+    }
+}
+
+void VirtualPageTable::setCommitted(const Page & page, const bool committed)
+{
+    Entry & entry = m_entries[index(page)];
+
+    if (entry.committed == committed)
+        return;
+
+    entry.committed = committed;
+
+    if (committed)
+        ++m_committedCount;
+    else
+        --m_committedCount;
+}
+
+bool VirtualPageTable::isCommitted(const Page & page) const
+{
+    return m_entries[index(page)].committed;
+}
+
+std::size_t VirtualPageTable::committedCount() const
+{
+    return m_committedCount;
+}
+
+std::vector<VirtualPageTable::Page> VirtualPageTable::missing(const unsigned long long frame, const unsigned long long retainFrames) const
+{
+    std::vector<std::size_t> indices;
+
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (!m_entries[i].committed && isWanted(m_entries[i], frame, retainFrames))
+            indices.push_back(i);
+    }
+
+    // coarser levels have larger indices and show something for the finer ones meanwhile
+    std::stable_sort(indices.begin(), indices.end(), [this](const std::size_t a, const std::size_t b)
+    {
+        const GLint levelA = page(a).level;
+        const GLint levelB = page(b).level;
+
+        if (levelA != levelB)
+            return levelA > levelB;
+
+        return m_entries[a].lastRequest > m_entries[b].lastRequest;
+    });
+
+    std::vector<Page> pages;
+    pages.reserve(indices.size());
+
+    for (const std::size_t i : indices)
+        pages.push_back(page(i));
+
+    return pages;
+}
+
+std::vector<VirtualPageTable::Page> VirtualPageTable::evictable(const unsigned long long frame, const unsigned long long retainFrames) const
+{
+    std::vector<std::size_t> indices;
+
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (m_entries[i].committed && !isWanted(m_entries[i], frame, retainFrames))
+            indices.push_back(i);
+    }
+
+    // finer levels first among pages of the same age
+    std::stable_sort(indices.begin(), indices.end(), [this](const std::size_t a, const std::size_t b)
+    {
+        return m_entries[a].lastRequest < m_entries[b].lastRequest;
+    });
+
+    std::vector<Page> pages;
+    pages.reserve(indices.size());
+
+    for (const std::size_t i : indices)
+        pages.push_back(page(i));
+
+    return pages;
+}
+
+bool VirtualPageTable::isWanted(const Entry & entry, const unsigned long long frame, const unsigned long long retainFrames) const
+{
+    return entry.refCount > 0 || (entry.requested && entry.lastRequest + retainFrames >= frame);
+}
+
+
+VirtualTexture::VirtualTexture(const GLenum internalFormat, const glm::ivec2 & size, const GLsizei levels, const GLenum format, const GLenum type, const PageProvider & provider)
+: m_texture(new Texture(GL_TEXTURE_2D))
+, m_internalFormat(internalFormat)
+, m_levels(levels)
+, m_format(format)
+, m_type(type)
+, m_provider(provider)
+, m_sparseLevels(0)
+, m_uploadBudget(c_defaultUploadBudget)
+, m_maxCommittedPages(c_defaultMaxCommittedPages)
+, m_retainFrames(c_defaultRetainFrames)
+, m_frame(0)
+{
+    assert(levels > 0);
+
+    resetStats();
+
+    const std::vector<glm::ivec3> sizes = pageSizes(GL_TEXTURE_2D, internalFormat);
+
+    if (sizes.empty())
+        warning() << "VirtualTexture: internal format cannot be sparse, all levels are committed";
+    else
+    {
+        m_texture->setParameter(GL_TEXTURE_SPARSE_ARB, static_cast<GLint>(GL_TRUE));
+        m_texture->setParameter(GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+    }
+
+    m_texture->setParameter(GL_TEXTURE_MIN_FILTER, static_cast<GLint>(levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    m_texture->setParameter(GL_TEXTURE_MAG_FILTER, static_cast<GLint>(GL_LINEAR));
+
+    m_texture->storage2D(levels, internalFormat, size);
+
+    if (!sizes.empty())
+        m_sparseLevels = std::min(m_texture->getParameter(GL_NUM_SPARSE_LEVELS_ARB), static_cast<GLint>(levels));
+
+    m_pageTable = VirtualPageTable(size, sizes.empty() ? size : glm::ivec2(sizes.front().x, sizes.front().y), m_sparseLevels);
+    m_tailUploaded.assign(levels - m_sparseLevels, false);
+
+    // the mip tail is committed as a whole
+    for (GLint level = m_sparseLevels; !sizes.empty() && level < levels; ++level)
+    {
+        const glm::ivec2 levelSize = m_pageTable.levelSize(level);
+        m_texture->pageCommitment(level, 0, 0, 0, levelSize.x, levelSize.y, 1, GL_TRUE);
+    }
+
+    const GLuint zero = 0;
+
+    m_feedback = new Buffer;
+    m_feedback->setData(static_cast<GLsizeiptr>(std::max(m_pageTable.size(), std::size_t(1)) * sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    m_feedback->clearData(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+    m_readbacks = new ReadbackQueue(3);
+}
+
+VirtualTexture::~VirtualTexture()
+{
+}
+
+std::vector<glm::ivec3> VirtualTexture::pageSizes(const GLenum target, const GLenum internalFormat)
+{
+    GLint count = 0;
+    glGetInternalformativ(target, internalFormat, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &count);
+
+    if (count <= 0)
+        return std::vector<glm::ivec3>();
+
+    std::vector<GLint> x(count), y(count), z(count);
+    glGetInternalformativ(target, internalFormat, GL_VIRTUAL_PAGE_SIZE_X_ARB, count, x.data());
+    glGetInternalformativ(target, internalFormat, GL_VIRTUAL_PAGE_SIZE_Y_ARB, count, y.data());
+    glGetInternalformativ(target, internalFormat, GL_VIRTUAL_PAGE_SIZE_Z_ARB, count, z.data());
+
+    std::vector<glm::ivec3> sizes;
+
+    for (GLint i = 0; i < count; ++i)
+        sizes.push_back(glm::ivec3(x[i], y[i], z[i]));
+
+    return sizes;
+}
+
+Texture * VirtualTexture::texture() const
+{
+    return m_texture;
+}
+
+VirtualPageTable & VirtualTexture::pageTable()
+{
+    return m_pageTable;
+}
+
+const VirtualPageTable & VirtualTexture::pageTable() const
+{
+    return m_pageTable;
+}
+
+GLint VirtualTexture::sparseLevels() const
+{
+    return m_sparseLevels;
+}
+
+void VirtualTexture::setUploadBudget(const GLsizeiptr bytesPerFrame)
+{
+    m_uploadBudget = bytesPerFrame;
+}
+
+GLsizeiptr VirtualTexture::uploadBudget() const
+{
+    return m_uploadBudget;
+}
+
+void VirtualTexture::setMaxCommittedPages(const std::size_t count)
+{
+    m_maxCommittedPages = count;
+}
+
+std::size_t VirtualTexture::maxCommittedPages() const
+{
+    return m_maxCommittedPages;
+}
+
+void VirtualTexture::setRetainFrames(const unsigned int frames)
+{
+    m_retainFrames = frames;
+}
+
+unsigned int VirtualTexture::retainFrames() const
+{
+    return m_retainFrames;
+}
+
+std::string VirtualTexture::feedbackShaderSource(const GLuint binding)
+{
+    return "layout (std430, binding = " + std::to_string(binding) + ") buffer VirtualPageRequests" + s_feedbackShaderSource;
+}
+
+void VirtualTexture::setUniforms(Program * program) const
+{
+    assert(program != nullptr);
+
+    program->setUniform("virtualPageSize", m_pageTable.pageSize());
+    program->setUniform("virtualSparseLevels", m_sparseLevels);
+}
+
+void VirtualTexture::bindFeedback(const GLuint binding) const
+{
+    m_feedback->bindBase(GL_SHADER_STORAGE_BUFFER, binding);
+}
+
+Buffer * VirtualTexture::feedback() const
+{
+    return m_feedback;
+}
+
+void VirtualTexture::endFrame()
+{
+    const unsigned long long frame = m_frame++;
+
+    if (m_sparseLevels == 0)
+        return;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(m_pageTable.size() * sizeof(GLuint));
+
+    m_readbacks->readBuffer(m_feedback, 0, size, [this, frame](const void * data, const GLsizeiptr size)
+    {
+        applyFeedback(data, size, frame);
+    });
+
+    const GLuint zero = 0;
+    m_feedback->clearData(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+    m_readbacks->poll();
+}
+
+void VirtualTexture::applyFeedback(const void * data, const GLsizeiptr size, const unsigned long long frame)
+{
+    const GLuint * requests = reinterpret_cast<const GLuint *>(data);
+    const std::size_t count = static_cast<std::size_t>(size) / sizeof(GLuint);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (requests[i] != 0)
+            m_pageTable.request(m_pageTable.page(i), frame);
+    }
+}
+
+void VirtualTexture::update()
+{
+    uploadTail();
+
+    if (m_sparseLevels == 0)
+        return;
+
+    // uncommit first, so that the missing pages can reuse the memory
+    if (m_pageTable.committedCount() > m_maxCommittedPages)
+    {
+        for (const VirtualPageTable::Page & page : m_pageTable.evictable(m_frame, m_retainFrames))
+        {
+            if (m_pageTable.committedCount() <= m_maxCommittedPages)
+                break;
+
+            const glm::ivec2 offset = m_pageTable.offset(page);
+            const glm::ivec2 extent = m_pageTable.extent(page);
+
+            m_texture->pageCommitment(page.level, offset.x, offset.y, 0, extent.x, extent.y, 1, GL_FALSE);
+            m_pageTable.setCommitted(page, false);
+
+            ++m_stats.uncommittedPages;
+        }
+    }
+
+    const std::vector<VirtualPageTable::Page> missing = m_pageTable.missing(m_frame, m_retainFrames);
+    m_stats.missingPages = missing.size();
+
+    GLsizeiptr bytes = 0;
+
+    for (const VirtualPageTable::Page & page : missing)
+    {
+        if (m_pageTable.committedCount() >= m_maxCommittedPages)
+            break;
+
+        const glm::ivec2 extent = m_pageTable.extent(page);
+        const GLsizeiptr pageBytes = imageSizeInBytes(extent.x, extent.y, m_format, m_type, 1);
+
+        // at least one page per frame, however small the budget
+        if (bytes > 0 && bytes + pageBytes > m_uploadBudget)
+            break;
+
+        if (!upload(page, m_pageTable.offset(page), extent, true))
+            continue;
+
+        m_pageTable.setCommitted(page, true);
+        bytes += pageBytes;
+    }
+
+    m_stats.committedPages = m_pageTable.committedCount();
+}
+
+bool VirtualTexture::upload(const VirtualPageTable::Page & page, const glm::ivec2 & offset, const glm::ivec2 & size, const bool commit)
+{
+    const int bytes = imageSizeInBytes(size.x, size.y, m_format, m_type, 1);
+
+    if (m_staging.size() < static_cast<std::size_t>(bytes))
+        m_staging.resize(bytes);
+
+    if (!m_provider || !m_provider(page, offset, size, m_staging.data()))
+        return false;
+
+    if (commit)
+        m_texture->pageCommitment(page.level, offset.x, offset.y, 0, size.x, size.y, 1, GL_TRUE);
+
+    // the provider delivers tightly packed rows
+    const GLint alignment = getInteger(GL_UNPACK_ALIGNMENT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    m_texture->subImage2D(page.level, offset, size, m_format, m_type, m_staging.data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    ++m_stats.uploadedPages;
+    m_stats.uploadedBytes += bytes;
+
+    return true;
+}
+
+void VirtualTexture::uploadTail()
+{
+    for (std::size_t i = 0; i < m_tailUploaded.size(); ++i)
+    {
+        if (m_tailUploaded[i])
+            continue;
+
+        const GLint level = m_sparseLevels + static_cast<GLint>(i);
+
+        m_tailUploaded[i] = upload({ level, 0, 0 }, glm::ivec2(0), m_pageTable.levelSize(level), false);
+    }
+}
+
+const VirtualTexture::Stats & VirtualTexture::stats() const
+{
+    return m_stats;
+}
+
+void VirtualTexture::resetStats()
+{
+    m_stats.committedPages = m_pageTable.committedCount();
+    m_stats.missingPages = 0;
+
+    m_stats.uploadedPages = 0;
+    m_stats.uncommittedPages = 0;
+    m_stats.uploadedBytes = 0;
+}
+
+} // namespace globjects
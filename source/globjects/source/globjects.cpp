@@ -16,6 +16,8 @@
 #include "registry/ObjectRegistry.h"
 #include "registry/ExtensionRegistry.h"
 #include "registry/ImplementationRegistry.h"
+#include "registry/StateRegistry.h"
+#include "registry/BindingRegistry.h"
 
 #include <globjects/DebugMessage.h>
 #include <globjects/logging.h>
@@ -292,11 +294,15 @@ bool isInCoreProfile(const GLextension extension)
 
 void enable(const GLenum capability)
 {
+    StateRegistry::current().capabilityChanged(capability, true);
+
     glEnable(capability);
 }
 
 void disable(const GLenum capability)
 {
+    StateRegistry::current().capabilityChanged(capability, false);
+
     glDisable(capability);
 }
 
@@ -314,11 +320,15 @@ void setEnabled(const GLenum capability, const bool enabled)
 
 void enable(const GLenum capability, const int index)
 {
+    StateRegistry::current().capabilityChanged(capability, index, true);
+
     glEnablei(capability, index);
 }
 
 void disable(const GLenum capability, const int index)
 {
+    StateRegistry::current().capabilityChanged(capability, index, false);
+
     glDisablei(capability, index);
 }
 
@@ -334,6 +344,12 @@ void setEnabled(const GLenum capability, const int index, const bool enabled)
     enabled ? enable(capability, index) : disable(capability, index);
 }
 
+void invalidateTrackedState()
+{
+    StateRegistry::current().invalidate();
+    BindingRegistry::current().invalidate();
+}
+
 void initializeStrategy(const AbstractUniform::BindlessImplementation impl)
 {
     Registry::current().implementations().initialize(impl);
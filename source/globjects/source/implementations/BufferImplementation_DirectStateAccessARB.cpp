@@ -7,6 +7,7 @@
 #include <globjects/Buffer.h>
 
 #include "BufferImplementation_Legacy.h"
+#include "EntryPointParameter.h"
 
 
 using namespace gl;
@@ -34,7 +35,10 @@ void * BufferImplementation_DirectStateAccessARB::map(const Buffer * buffer, GLe
 
 void * BufferImplementation_DirectStateAccessARB::mapRange(const Buffer * buffer, GLintptr offset, GLsizeiptr length, BufferAccessMask access) const
 {
-    return glMapNamedBufferRange(buffer->id(), offset, static_cast<GLsizei>(length), access);
+    if (!holdsSize<2>(&glMapNamedBufferRange, length))
+        return BufferImplementation_Legacy::instance()->mapRange(buffer, offset, length, access);
+
+    return glMapNamedBufferRange(buffer->id(), offset, sizeParameter<2>(&glMapNamedBufferRange, length), access);
 }
 
 bool BufferImplementation_DirectStateAccessARB::unmap(const Buffer * buffer) const
@@ -44,22 +48,47 @@ bool BufferImplementation_DirectStateAccessARB::unmap(const Buffer * buffer) con
 
 void BufferImplementation_DirectStateAccessARB::setData(const Buffer * buffer, GLsizeiptr size, const GLvoid * data, GLenum usage) const
 {
-    glNamedBufferData(buffer->id(), static_cast<GLsizei>(size), data, usage);
+    // sizes the entry point would narrow, depending on the glbinding release, take the bind-to-edit path
+    if (!holdsSize<1>(&glNamedBufferData, size))
+    {
+        BufferImplementation_Legacy::instance()->setData(buffer, size, data, usage);
+        return;
+    }
+
+    glNamedBufferData(buffer->id(), sizeParameter<1>(&glNamedBufferData, size), data, usage);
 }
 
 void BufferImplementation_DirectStateAccessARB::setSubData(const Buffer * buffer, GLintptr offset, GLsizeiptr size, const GLvoid * data) const
 {
-    glNamedBufferSubData(buffer->id(), offset, static_cast<GLsizei>(size), data);
+    if (!holdsSize<2>(&glNamedBufferSubData, size))
+    {
+        BufferImplementation_Legacy::instance()->setSubData(buffer, offset, size, data);
+        return;
+    }
+
+    glNamedBufferSubData(buffer->id(), offset, sizeParameter<2>(&glNamedBufferSubData, size), data);
 }
 
 void BufferImplementation_DirectStateAccessARB::setStorage(const Buffer * buffer, GLsizeiptr size, const GLvoid * data, MapBufferUsageMask flags) const
 {
-    glNamedBufferStorage(buffer->id(), static_cast<GLsizei>(size), data, flags);
+    if (!holdsSize<1>(&glNamedBufferStorage, size))
+    {
+        BufferImplementation_Legacy::instance()->setStorage(buffer, size, data, flags);
+        return;
+    }
+
+    glNamedBufferStorage(buffer->id(), sizeParameter<1>(&glNamedBufferStorage, size), data, flags);
 }
 
 void BufferImplementation_DirectStateAccessARB::copySubData(const Buffer * buffer, Buffer * other, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) const
 {
-    glCopyNamedBufferSubData(buffer->id(), other->id(), readOffset, writeOffset, static_cast<GLsizei>(size));
+    if (!holdsSize<4>(&glCopyNamedBufferSubData, size))
+    {
+        BufferImplementation_Legacy::instance()->copySubData(buffer, other, readOffset, writeOffset, size);
+        return;
+    }
+
+    glCopyNamedBufferSubData(buffer->id(), other->id(), readOffset, writeOffset, sizeParameter<4>(&glCopyNamedBufferSubData, size));
 }
 
 GLint BufferImplementation_DirectStateAccessARB::getParameter(const Buffer * buffer, GLenum pname) const
@@ -96,17 +125,35 @@ void BufferImplementation_DirectStateAccessARB::clearData(const Buffer * buffer,
 
 void BufferImplementation_DirectStateAccessARB::clearSubData(const Buffer * buffer, GLenum internalformat, GLintptr offset, GLsizeiptr size, GLenum format, GLenum type, const void * data) const
 {
-    glClearNamedBufferSubData(buffer->id(), internalformat, offset, static_cast<GLsizei>(size), format, type, data);
+    if (!holdsSize<3>(&glClearNamedBufferSubData, size))
+    {
+        BufferImplementation_Legacy::instance()->clearSubData(buffer, internalformat, offset, size, format, type, data);
+        return;
+    }
+
+    glClearNamedBufferSubData(buffer->id(), internalformat, offset, sizeParameter<3>(&glClearNamedBufferSubData, size), format, type, data);
 }
 
 void BufferImplementation_DirectStateAccessARB::flushMappedRange(const Buffer * buffer, GLintptr offset, GLsizeiptr length) const
 {
-    glFlushMappedNamedBufferRange(buffer->id(), offset, static_cast<GLsizei>(length));
+    if (!holdsSize<2>(&glFlushMappedNamedBufferRange, length))
+    {
+        BufferImplementation_Legacy::instance()->flushMappedRange(buffer, offset, length);
+        return;
+    }
+
+    glFlushMappedNamedBufferRange(buffer->id(), offset, sizeParameter<2>(&glFlushMappedNamedBufferRange, length));
 }
 
 void BufferImplementation_DirectStateAccessARB::getBufferSubData(const Buffer * buffer, GLintptr offset, GLsizeiptr size, GLvoid * data) const
 {
-    glGetNamedBufferSubData(buffer->id(), offset, static_cast<GLsizei>(size), data);
+    if (!holdsSize<2>(&glGetNamedBufferSubData, size))
+    {
+        BufferImplementation_Legacy::instance()->getBufferSubData(buffer, offset, size, data);
+        return;
+    }
+
+    glGetNamedBufferSubData(buffer->id(), offset, sizeParameter<2>(&glGetNamedBufferSubData, size), data);
 }
 
 } // namespace globjects
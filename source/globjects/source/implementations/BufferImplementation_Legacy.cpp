@@ -7,6 +7,8 @@
 
 #include <globjects/Buffer.h>
 
+#include "registry/BindingRegistry.h"
+
 
 using namespace gl;
 
@@ -19,7 +21,7 @@ GLuint BufferImplementation_Legacy::create() const
 {
     GLuint buffer;
     glGenBuffers(1, &buffer); // create a handle to a potentially used buffer
-    glBindBuffer(s_workingTarget, buffer); // trigger actual buffer creation
+    BindingRegistry::current().bindBuffer(s_workingTarget, buffer); // trigger actual buffer creation
 
     return buffer;
 }
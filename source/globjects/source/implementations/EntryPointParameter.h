@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <tuple>
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+/** \brief Type of the parameter at Index of an OpenGL entry point.
+
+    glbinding releases differ in the size parameters of some entry points,
+    e.g., older ones declare those of the ARB direct state access functions
+    as GLsizei instead of GLsizeiptr.
+*/
+template <typename Function, std::size_t Index>
+struct EntryPointParameter;
+
+template <typename Return, typename... Parameters, std::size_t Index>
+struct EntryPointParameter<Return (*)(Parameters...), Index>
+{
+    using Type = typename std::tuple_element<Index, std::tuple<Parameters...>>::type;
+
+    /** Whether size is passed unchanged, i.e., without narrowing to a 32 bit parameter. */
+    static bool holds(const gl::GLsizeiptr size)
+    {
+        return static_cast<unsigned long long>(size) <= static_cast<unsigned long long>(std::numeric_limits<Type>::max());
+    }
+
+    static Type convert(const gl::GLsizeiptr size)
+    {
+        return static_cast<Type>(size);
+    }
+};
+
+/** Whether the size parameter at Index of the entry point holds size. */
+template <std::size_t Index, typename Function>
+bool holdsSize(Function, const gl::GLsizeiptr size)
+{
+    return EntryPointParameter<Function, Index>::holds(size);
+}
+
+/** Passes size to the parameter at Index of the entry point, which has to hold it. */
+template <std::size_t Index, typename Function>
+typename EntryPointParameter<Function, Index>::Type sizeParameter(Function, const gl::GLsizeiptr size)
+{
+    return EntryPointParameter<Function, Index>::convert(size);
+}
+
+} // namespace globjects
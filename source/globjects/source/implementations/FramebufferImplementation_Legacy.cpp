@@ -8,6 +8,8 @@
 #include <globjects/Texture.h>
 #include <globjects/Renderbuffer.h>
 
+#include "registry/BindingRegistry.h"
+
 
 using namespace gl;
 
@@ -18,7 +20,7 @@ GLuint FramebufferImplementation_Legacy::create() const
 {
     GLuint framebuffer;
     glGenFramebuffers(1, &framebuffer); // create a handle to a potentially used framebuffer
-    glBindFramebuffer(s_workingTarget, framebuffer); // trigger actual framebuffer creation
+    BindingRegistry::current().bindFramebuffer(s_workingTarget, framebuffer); // trigger actual framebuffer creation
 
     return framebuffer;
 }
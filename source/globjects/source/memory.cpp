@@ -1,9 +1,15 @@
 #include <globjects/memory.h>
 
+#include <cassert>
+
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/extension.h>
 
 #include <globjects/globjects.h>
+#include <globjects/Object.h>
+
+#include "pixelformat.h"
+#include "registry/MemoryRegistry.h"
 
 
 using namespace gl;
@@ -52,5 +58,57 @@ GLint evictionCount()
     return getMemoryInformation(GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX);
 }
 
+GLint64 allocated()
+{
+    return MemoryRegistry::current().allocated();
+}
+
+GLint64 allocated(const GLenum objectType)
+{
+    return MemoryRegistry::current().allocated(objectType);
+}
+
+GLint64 allocated(const Object * object)
+{
+    assert(object != nullptr);
+
+    return MemoryRegistry::current().allocated(object->objectType(), object->id());
+}
+
+std::map<std::string, GLint64> allocatedByLabel()
+{
+    return MemoryRegistry::current().allocatedByLabel();
+}
+
+GLint64 highWaterMark()
+{
+    return MemoryRegistry::current().highWaterMark();
+}
+
+void resetHighWaterMark()
+{
+    MemoryRegistry::current().resetHighWaterMark();
+}
+
+void addBudget(const GLint64 budget, const BudgetCallback & callback)
+{
+    MemoryRegistry::current().addBudget(budget, callback);
+}
+
+void clearBudgets()
+{
+    MemoryRegistry::current().clearBudgets();
+}
+
+GLint64 storageSize(const GLenum target, const GLsizei levels, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei depth)
+{
+    return storageSizeInBytes(target, levels, internalFormat, width, height, depth);
+}
+
+std::string toJson()
+{
+    return MemoryRegistry::current().toJson();
+}
+
 } // namespace memory
 } // namespace globjects
@@ -1,5 +1,7 @@
 #include "pixelformat.h"
 
+#include <algorithm>
+
 #include <glbinding/gl/enum.h>
 
 #include <globjects/globjects.h>
@@ -117,11 +119,154 @@ int bytesPerPixel(const GLenum format, const GLenum type)
     return numberOfComponents(format) * byteSize(type);
 }
 
+int bitsPerTexel(const GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+        case GL_R8_SNORM:
+        case GL_R8I:
+        case GL_R8UI:
+        case GL_R3_G3_B2:
+        case GL_STENCIL_INDEX8:
+            return 8;
+
+        case GL_R16:
+        case GL_R16_SNORM:
+        case GL_R16F:
+        case GL_R16I:
+        case GL_R16UI:
+        case GL_RG8:
+        case GL_RG8_SNORM:
+        case GL_RG8I:
+        case GL_RG8UI:
+        case GL_RGB565:
+        case GL_RGBA4:
+        case GL_RGB5_A1:
+        case GL_DEPTH_COMPONENT16:
+            return 16;
+
+        case GL_RGB16:
+        case GL_RGB16_SNORM:
+        case GL_RGB16F:
+        case GL_RGB16I:
+        case GL_RGB16UI:
+            return 48;
+
+        case GL_RG32F:
+        case GL_RG32I:
+        case GL_RG32UI:
+        case GL_RGBA16:
+        case GL_RGBA16_SNORM:
+        case GL_RGBA16F:
+        case GL_RGBA16I:
+        case GL_RGBA16UI:
+        case GL_DEPTH32F_STENCIL8:
+            return 64;
+
+        case GL_RGB32F:
+        case GL_RGB32I:
+        case GL_RGB32UI:
+            return 96;
+
+        case GL_RGBA32F:
+        case GL_RGBA32I:
+        case GL_RGBA32UI:
+            return 128;
+
+        default:
+            // 32 bit formats, padded 24 bit formats and unsized formats
+            return 32;
+    }
+}
+
+// block width and height of ASTC formats, false for other formats
+bool astcBlockSize(const GLenum internalFormat, int & width, int & height)
+{
+    static const int sizes[14][2] = {
+        { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+        { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+    };
+
+    // the linear and sRGB formats are both enumerated from 4x4 to 12x12
+    const unsigned int value = static_cast<unsigned int>(internalFormat);
+    unsigned int index = 14;
+
+    if (value >= static_cast<unsigned int>(GL_COMPRESSED_RGBA_ASTC_4x4_KHR) && value <= static_cast<unsigned int>(GL_COMPRESSED_RGBA_ASTC_12x12_KHR))
+        index = value - static_cast<unsigned int>(GL_COMPRESSED_RGBA_ASTC_4x4_KHR);
+    else if (value >= static_cast<unsigned int>(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR) && value <= static_cast<unsigned int>(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR))
+        index = value - static_cast<unsigned int>(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR);
+
+    if (index >= 14)
+        return false;
+
+    width = sizes[index][0];
+    height = sizes[index][1];
+
+    return true;
+}
+
+// bytes per block of blockWidth x blockHeight texels, 0 for uncompressed formats
+int bytesPerBlock(const GLenum internalFormat, int & blockWidth, int & blockHeight)
+{
+    blockWidth = 4;
+    blockHeight = 4;
+
+    if (astcBlockSize(internalFormat, blockWidth, blockHeight))
+        return 16;
+
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_R11_EAC:
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+            return 8;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        case GL_COMPRESSED_RG11_EAC:
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            return 16;
+
+        default:
+            return 0;
+    }
+}
+
 }
 
 namespace globjects {
 
+int pixelSizeInBytes(const GLenum format, const GLenum type)
+{
+    return bytesPerPixel(format, type);
+}
+
 int imageSizeInBytes(const int width, const int height, const GLenum format, const GLenum type)
+{
+    return imageSizeInBytes(width, height, format, type, getInteger(GL_PACK_ALIGNMENT)); // can be 1, 2, 4 or 8
+}
+
+int imageSizeInBytes(const int width, const int height, const GLenum format, const GLenum type, const int alignment)
 {
     if (type == GL_BITMAP)
     {
@@ -134,11 +279,48 @@ int imageSizeInBytes(const int width, const int height, const GLenum format, con
 
     int rowSize = pixelSize * width;
 
-    int alignment = getInteger(GL_PACK_ALIGNMENT); // can be 1, 2, 4 or 8
-
     rowSize = nextMultiple(rowSize, alignment);
 
     return rowSize * height;
 }
 
+long long storageSizeInBytes(const GLenum internalFormat, const int width, const int height, const int depth)
+{
+    int blockWidth, blockHeight;
+    const int blockSize = bytesPerBlock(internalFormat, blockWidth, blockHeight);
+
+    if (blockSize > 0)
+    {
+        const long long blocks = static_cast<long long>((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight);
+        return blocks * blockSize * depth;
+    }
+
+    return static_cast<long long>(width) * height * depth * bitsPerTexel(internalFormat) / 8;
+}
+
+long long storageSizeInBytes(const GLenum target, const int levels, const GLenum internalFormat, int width, int height, int depth)
+{
+    // array layers and cube map faces keep their count on every level
+    const bool heightIsLayers = target == GL_TEXTURE_1D_ARRAY;
+    const bool depthIsLayers = target == GL_TEXTURE_2D_ARRAY || target == GL_TEXTURE_CUBE_MAP_ARRAY;
+    const int faces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+
+    long long size = 0;
+
+    for (int level = 0; level < levels; ++level)
+    {
+        size += storageSizeInBytes(internalFormat, width, height, depth) * faces;
+
+        width = std::max(width / 2, 1);
+
+        if (!heightIsLayers)
+            height = std::max(height / 2, 1);
+
+        if (!depthIsLayers)
+            depth = std::max(depth / 2, 1);
+    }
+
+    return size;
+}
+
 } // namespace globjects
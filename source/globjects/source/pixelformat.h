@@ -4,6 +4,15 @@
 
 namespace globjects {
 
+int pixelSizeInBytes(gl::GLenum format, gl::GLenum type);
+
 int imageSizeInBytes(int width, int height, gl::GLenum format, gl::GLenum type);
+int imageSizeInBytes(int width, int height, gl::GLenum format, gl::GLenum type, int alignment);
+
+// estimated driver allocation for one image of the given internal format, 24 bit formats are counted as padded to 32 bit
+long long storageSizeInBytes(gl::GLenum internalFormat, int width, int height, int depth);
+
+// estimated driver allocation for a mipmapped texture as created by glTexStorage*, depending on which dimensions are layers
+long long storageSizeInBytes(gl::GLenum target, int levels, gl::GLenum internalFormat, int width, int height, int depth);
 
 } // namespace globjects
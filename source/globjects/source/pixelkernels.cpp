@@ -0,0 +1,220 @@
+#include "pixelkernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+
+std::uint16_t toHalf(const float value)
+{
+    // rounds to nearest even, see https://gist.github.com/rygorous/2156668
+    const std::uint32_t infinity = 255u << 23;
+    const std::uint32_t halfOverflow = (127u + 16u) << 23;
+    const std::uint32_t halfMinNormal = (127u - 14u) << 23;
+    const std::uint32_t subnormalMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const std::uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    std::uint32_t half;
+
+    if (bits >= halfOverflow)
+    {
+        half = bits > infinity ? 0x7e00u : 0x7c00u;
+    }
+    else if (bits < halfMinNormal)
+    {
+        float magic;
+        std::memcpy(&magic, &subnormalMagic, sizeof(magic));
+
+        float absolute;
+        std::memcpy(&absolute, &bits, sizeof(absolute));
+        absolute += magic;
+
+        std::memcpy(&half, &absolute, sizeof(half));
+        half -= subnormalMagic;
+    }
+    else
+    {
+        const std::uint32_t mantissaOdd = (bits >> 13) & 1u;
+
+        bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu;
+        bits += mantissaOdd;
+        half = bits >> 13;
+    }
+
+    return static_cast<std::uint16_t>(half | (sign >> 16));
+}
+
+void storeFloat(unsigned char * destination, const float value)
+{
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+void expandRGB(const unsigned char * source, unsigned char * destination, const int count)
+{
+    for (int i = 0; i < count; ++i, source += 3, destination += 4)
+    {
+        destination[0] = source[0];
+        destination[1] = source[1];
+        destination[2] = source[2];
+        destination[3] = 255;
+    }
+}
+
+void expandSwapRGB(const unsigned char * source, unsigned char * destination, const int count)
+{
+    for (int i = 0; i < count; ++i, source += 3, destination += 4)
+    {
+        destination[0] = source[2];
+        destination[1] = source[1];
+        destination[2] = source[0];
+        destination[3] = 255;
+    }
+}
+
+void swapRGBA(const unsigned char * source, unsigned char * destination, const int count)
+{
+    for (int i = 0; i < count; ++i, source += 4, destination += 4)
+    {
+        destination[0] = source[2];
+        destination[1] = source[1];
+        destination[2] = source[0];
+        destination[3] = source[3];
+    }
+}
+
+void floatToHalf(const unsigned char * source, unsigned char * destination, const int count)
+{
+    for (int i = 0; i < count; ++i, source += 4, destination += 2)
+    {
+        float value;
+        std::memcpy(&value, source, sizeof(value));
+
+        const std::uint16_t half = toHalf(value);
+        std::memcpy(destination, &half, sizeof(half));
+    }
+}
+
+void byteToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * linear = globjects::pixels::byteToFloatTable() + 256;
+
+    for (int i = 0; i < count; ++i, destination += 4)
+        storeFloat(destination, linear[source[i]]);
+}
+
+void srgbToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * decoded = globjects::pixels::byteToFloatTable();
+
+    for (int i = 0; i < count; ++i, destination += 4)
+        storeFloat(destination, decoded[source[i]]);
+}
+
+void srgbAlphaToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * decoded = globjects::pixels::byteToFloatTable();
+
+    for (int i = 0; i < count; ++i, source += 4, destination += 16)
+    {
+        storeFloat(destination, decoded[source[0]]);
+        storeFloat(destination + 4, decoded[source[1]]);
+        storeFloat(destination + 8, decoded[source[2]]);
+        storeFloat(destination + 12, decoded[256 + source[3]]);
+    }
+}
+
+void scaleAdd(const float * source, const float weight, float * destination, const int count)
+{
+    for (int i = 0; i < count; ++i)
+        destination[i] += weight * source[i];
+}
+
+void filter(const float * source, const int * indices, const float * weights, const int taps, const int components, float * destination, const int count)
+{
+    for (int i = 0; i < count; ++i, indices += taps, weights += taps, destination += components)
+    {
+        for (int c = 0; c < components; ++c)
+            destination[c] = 0.0f;
+
+        for (int t = 0; t < taps; ++t)
+        {
+            const float * pixel = source + indices[t] * components;
+
+            for (int c = 0; c < components; ++c)
+                destination[c] += weights[t] * pixel[c];
+        }
+    }
+}
+
+struct ByteToFloatTable
+{
+    ByteToFloatTable()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            const double value = i / 255.0;
+
+            values[i] = static_cast<float>(value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+
+            // as computed by the vectorized kernels
+            values[256 + i] = static_cast<float>(i) * (1.0f / 255.0f);
+        }
+    }
+
+    float values[512];
+};
+
+} // namespace
+
+
+namespace globjects
+{
+namespace pixels
+{
+
+const Kernels & scalarKernels()
+{
+    static const Kernels kernels = {
+        expandRGB,
+        expandSwapRGB,
+        swapRGBA,
+        floatToHalf,
+        byteToFloat,
+        srgbToFloat,
+        srgbAlphaToFloat,
+        scaleAdd,
+        filter
+    };
+
+    return kernels;
+}
+
+const Kernels * kernels(const InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::AVX2:
+        return avx2Kernels();
+    case InstructionSet::SSE2:
+        return sse2Kernels();
+    default:
+        return &scalarKernels();
+    }
+}
+
+const float * byteToFloatTable()
+{
+    static const ByteToFloatTable table;
+
+    return table.values;
+}
+
+} // namespace pixels
+} // namespace globjects
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <globjects/pixels.h>
+
+namespace globjects
+{
+namespace pixels
+{
+
+// converts one row of count pixels or components, source and destination must not overlap
+using RowKernel = void (*)(const unsigned char * source, unsigned char * destination, int count);
+
+// destination[i] += weight * source[i] for count floats
+using ScaleAddKernel = void (*)(const float * source, float weight, float * destination, int count);
+
+// sets each of count destination pixels to the sum of taps source pixels, given by consecutive indices and weights per destination pixel
+using FilterKernel = void (*)(const float * source, const int * indices, const float * weights, int taps, int components, float * destination, int count);
+
+struct Kernels
+{
+    RowKernel expandRGB;        // 3 to 4 unsigned bytes per pixel with alpha 255, count in pixels
+    RowKernel expandSwapRGB;    // as expandRGB, swapping red and blue
+    RowKernel swapRGBA;         // swaps red and blue of 4 unsigned bytes per pixel, count in pixels
+    RowKernel floatToHalf;      // count in components
+    RowKernel byteToFloat;      // normalized, count in components
+    RowKernel srgbToFloat;      // sRGB decoded, count in components
+    RowKernel srgbAlphaToFloat; // 4 components per pixel with linear alpha, count in pixels
+    ScaleAddKernel scaleAdd;
+    FilterKernel filter;
+};
+
+// instruction set specific kernels are nullptr where the kernel of an older instruction set is used
+const Kernels & scalarKernels();
+const Kernels * sse2Kernels(); // nullptr if not compiled for the target processor
+const Kernels * avx2Kernels();
+
+// kernels of the given instruction set, nullptr if not compiled for the target processor
+const Kernels * kernels(InstructionSet instructionSet);
+
+// uses the best kernel available to convert(), instruction sets may leave out kernels they cannot speed up
+template <typename Kernel>
+Kernel select(Kernel Kernels::* kernel)
+{
+    for (int current = static_cast<int>(instructionSet()); current > 0; --current)
+    {
+        const Kernels * candidate = kernels(static_cast<InstructionSet>(current));
+
+        if (candidate && candidate->*kernel)
+            return candidate->*kernel;
+    }
+
+    return scalarKernels().*kernel;
+}
+
+// 256 sRGB decoded values, followed by 256 linear values, for unsigned bytes
+const float * byteToFloatTable();
+
+} // namespace pixels
+} // namespace globjects
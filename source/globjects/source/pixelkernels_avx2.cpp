@@ -0,0 +1,222 @@
+#include "pixelkernels.h"
+
+// compiled with AVX2 and F16C enabled on x86, see CMakeLists.txt
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace
+{
+
+// spreads 24 bytes of RGB pixels over both lanes and shuffles them into RGBA within each lane
+void expand(const unsigned char * source, unsigned char * destination, const int count, const __m256i shuffle, globjects::pixels::RowKernel tail)
+{
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+
+    int i = 0;
+
+    // loads 32 bytes for 8 pixels of 24 bytes
+    for (; i + 11 <= count; i += 8)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i * 3));
+        const __m256i pixels = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(bytes, spread), shuffle);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * 4), _mm256_or_si256(pixels, alpha));
+    }
+
+    tail(source + i * 3, destination + i * 4, count - i);
+}
+
+void expandRGB(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    expand(source, destination, count, shuffle, globjects::pixels::scalarKernels().expandRGB);
+}
+
+void expandSwapRGB(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+        2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+
+    expand(source, destination, count, shuffle, globjects::pixels::scalarKernels().expandSwapRGB);
+}
+
+void swapRGBA(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i * 4));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * 4), _mm256_shuffle_epi8(pixels, shuffle));
+    }
+
+    globjects::pixels::scalarKernels().swapRGBA(source + i * 4, destination + i * 4, count - i);
+}
+
+void floatToHalf(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * floats = reinterpret_cast<const float *>(source);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(floats + i), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 2), halves);
+    }
+
+    globjects::pixels::scalarKernels().floatToHalf(source + i * 4, destination + i * 2, count - i);
+}
+
+__m256i loadIndices(const unsigned char * source)
+{
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(source)));
+}
+
+void byteToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+
+    float * floats = reinterpret_cast<float *>(destination);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(floats + i, _mm256_mul_ps(_mm256_cvtepi32_ps(loadIndices(source + i)), scale));
+
+    globjects::pixels::scalarKernels().byteToFloat(source + i, destination + i * 4, count - i);
+}
+
+void srgbToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * table = globjects::pixels::byteToFloatTable();
+
+    float * floats = reinterpret_cast<float *>(destination);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(floats + i, _mm256_i32gather_ps(table, loadIndices(source + i), 4));
+
+    globjects::pixels::scalarKernels().srgbToFloat(source + i, destination + i * 4, count - i);
+}
+
+void srgbAlphaToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * table = globjects::pixels::byteToFloatTable();
+
+    // alpha is looked up in the linear half of the table
+    const __m256i alphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+
+    float * floats = reinterpret_cast<float *>(destination);
+
+    int i = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m256i indices = _mm256_add_epi32(loadIndices(source + i * 4), alphaOffset);
+
+        _mm256_storeu_ps(floats + i * 4, _mm256_i32gather_ps(table, indices, 4));
+    }
+
+    globjects::pixels::scalarKernels().srgbAlphaToFloat(source + i * 4, destination + i * 16, count - i);
+}
+
+void scaleAdd(const float * source, const float weight, float * destination, const int count)
+{
+    // no fused multiply-add, which would round differently than the other instruction sets
+    const __m256 factor = _mm256_set1_ps(weight);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i), _mm256_mul_ps(factor, _mm256_loadu_ps(source + i))));
+
+    globjects::pixels::scalarKernels().scaleAdd(source + i, weight, destination + i, count - i);
+}
+
+void filter(const float * source, const int * indices, const float * weights, const int taps, const int components, float * destination, const int count)
+{
+    // two pixels per register, summed in the same order as the other instruction sets
+    if (components != 4)
+    {
+        globjects::pixels::scalarKernels().filter(source, indices, weights, taps, components, destination, count);
+        return;
+    }
+
+    int i = 0;
+
+    for (; i + 2 <= count; i += 2, indices += 2 * taps, weights += 2 * taps)
+    {
+        __m256 sum = _mm256_setzero_ps();
+
+        for (int t = 0; t < taps; ++t)
+        {
+            const __m256 weight = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(weights[t])), _mm_set1_ps(weights[taps + t]), 1);
+            const __m256 pixel = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(source + indices[t] * 4)), _mm_loadu_ps(source + indices[taps + t] * 4), 1);
+
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(weight, pixel));
+        }
+
+        _mm256_storeu_ps(destination + i * 4, sum);
+    }
+
+    globjects::pixels::scalarKernels().filter(source, indices, weights, taps, components, destination + i * 4, count - i);
+}
+
+} // namespace
+
+
+namespace globjects
+{
+namespace pixels
+{
+
+const Kernels * avx2Kernels()
+{
+    static const Kernels kernels = {
+        expandRGB,
+        expandSwapRGB,
+        swapRGBA,
+        floatToHalf,
+        byteToFloat,
+        srgbToFloat,
+        srgbAlphaToFloat,
+        scaleAdd,
+        filter
+    };
+
+    return &kernels;
+}
+
+} // namespace pixels
+} // namespace globjects
+
+#else
+
+namespace globjects
+{
+namespace pixels
+{
+
+const Kernels * avx2Kernels()
+{
+    return nullptr;
+}
+
+} // namespace pixels
+} // namespace globjects
+
+#endif
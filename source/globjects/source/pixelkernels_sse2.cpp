@@ -0,0 +1,177 @@
+#include "pixelkernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+namespace
+{
+
+void swapRGBA(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xff00ff00u));
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 4));
+        const __m128i redBlue = _mm_andnot_si128(greenAlpha, pixels);
+
+        const __m128i swapped = _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4), _mm_or_si128(_mm_and_si128(pixels, greenAlpha), swapped));
+    }
+
+    globjects::pixels::scalarKernels().swapRGBA(source + i * 4, destination + i * 4, count - i);
+}
+
+// rounds to nearest even like the scalar conversion, see https://gist.github.com/rygorous/2156668
+__m128i floatToHalf(const __m128 value)
+{
+    const __m128i halfOverflow = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i halfMinNormal = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+    const __m128 sign = _mm_and_ps(value, _mm_set1_ps(-0.0f));
+    const __m128 absolute = _mm_xor_ps(value, sign);
+    const __m128i bits = _mm_castps_si128(absolute);
+
+    const __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+    const __m128i isRegular = _mm_cmpgt_epi32(halfOverflow, bits);
+    const __m128i isSubnormal = _mm_cmpgt_epi32(halfMinNormal, bits);
+
+    const __m128i special = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+    const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+
+    const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+    const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+    const __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+    const __m128i half = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+
+    // the sign extends into the upper bits, keeping the value in range for the signed saturation of packs
+    return _mm_or_si128(half, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+
+void floatToHalf(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const float * floats = reinterpret_cast<const float *>(source);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i low = floatToHalf(_mm_loadu_ps(floats + i));
+        const __m128i high = floatToHalf(_mm_loadu_ps(floats + i + 4));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 2), _mm_packs_epi32(low, high));
+    }
+
+    globjects::pixels::scalarKernels().floatToHalf(source + i * 4, destination + i * 2, count - i);
+}
+
+void byteToFloat(const unsigned char * source, unsigned char * destination, const int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+    float * floats = reinterpret_cast<float *>(destination);
+
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+
+        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+        _mm_storeu_ps(floats + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+        _mm_storeu_ps(floats + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+        _mm_storeu_ps(floats + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+        _mm_storeu_ps(floats + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+    }
+
+    globjects::pixels::scalarKernels().byteToFloat(source + i, destination + i * 4, count - i);
+}
+
+void scaleAdd(const float * source, const float weight, float * destination, const int count)
+{
+    const __m128 factor = _mm_set1_ps(weight);
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(factor, _mm_loadu_ps(source + i))));
+
+    globjects::pixels::scalarKernels().scaleAdd(source + i, weight, destination + i, count - i);
+}
+
+void filter(const float * source, const int * indices, const float * weights, const int taps, const int components, float * destination, const int count)
+{
+    // one pixel per register
+    if (components != 4)
+    {
+        globjects::pixels::scalarKernels().filter(source, indices, weights, taps, components, destination, count);
+        return;
+    }
+
+    for (int i = 0; i < count; ++i, indices += taps, weights += taps)
+    {
+        __m128 sum = _mm_setzero_ps();
+
+        for (int t = 0; t < taps; ++t)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(source + indices[t] * 4)));
+
+        _mm_storeu_ps(destination + i * 4, sum);
+    }
+}
+
+} // namespace
+
+
+namespace globjects
+{
+namespace pixels
+{
+
+const Kernels * sse2Kernels()
+{
+    // SSE2 has no byte shuffles, expanding and sRGB lookups stay scalar
+    static const Kernels kernels = {
+        nullptr,
+        nullptr,
+        swapRGBA,
+        floatToHalf,
+        byteToFloat,
+        nullptr,
+        nullptr,
+        scaleAdd,
+        filter
+    };
+
+    return &kernels;
+}
+
+} // namespace pixels
+} // namespace globjects
+
+#else
+
+namespace globjects
+{
+namespace pixels
+{
+
+const Kernels * sse2Kernels()
+{
+    return nullptr;
+}
+
+} // namespace pixels
+} // namespace globjects
+
+#endif
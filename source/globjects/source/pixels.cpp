@@ -0,0 +1,301 @@
+#include <globjects/pixels.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/globjects.h>
+
+#include "pixelformat.h"
+#include "pixelkernels.h"
+
+using namespace gl;
+
+namespace
+{
+
+using globjects::pixels::InstructionSet;
+using globjects::pixels::Kernels;
+using globjects::pixels::RowKernel;
+
+std::atomic<int> g_limit(static_cast<int>(InstructionSet::AVX2));
+
+InstructionSet detectInstructionSet()
+{
+    unsigned int features = 0;     // ecx of leaf 1
+    unsigned int extended = 0;     // ebx of leaf 7
+    unsigned long long xcr0 = 0;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    features = static_cast<unsigned int>(info[2]);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        extended = static_cast<unsigned int>(info[1]);
+    }
+
+    if (features & (1u << 27))
+        xcr0 = _xgetbv(0);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return InstructionSet::Scalar;
+
+    features = ecx;
+    const bool sse2 = (edx & (1u << 26)) != 0;
+
+    if (__get_cpuid_max(0, nullptr) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        extended = ebx;
+    }
+
+    if (features & (1u << 27))
+    {
+        unsigned int low, high;
+        __asm__ __volatile__ ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+        xcr0 = (static_cast<unsigned long long>(high) << 32) | low;
+    }
+#else
+    const bool sse2 = false;
+#endif
+
+    // AVX requires the operating system to save the ymm registers (XCR0 bits 1 and 2)
+    const bool osxsave = (features & (1u << 27)) != 0;
+    const bool avx = (features & (1u << 28)) != 0;
+    const bool f16c = (features & (1u << 29)) != 0;
+    const bool avx2 = (extended & (1u << 5)) != 0;
+
+    if (osxsave && avx && f16c && avx2 && (xcr0 & 6u) == 6u)
+        return InstructionSet::AVX2;
+
+    if (sse2)
+        return InstructionSet::SSE2;
+
+    return InstructionSet::Scalar;
+}
+
+InstructionSet availableInstructionSet()
+{
+    static const InstructionSet detected = detectInstructionSet();
+
+    int current = static_cast<int>(detected) < g_limit.load() ? static_cast<int>(detected) : g_limit.load();
+
+    // skip instruction sets the library was not compiled for
+    while (current > 0 && !globjects::pixels::kernels(static_cast<InstructionSet>(current)))
+        --current;
+
+    return static_cast<InstructionSet>(current);
+}
+
+bool isColorFormat(const GLenum format)
+{
+    switch (format)
+    {
+    case GL_RED:
+    case GL_GREEN:
+    case GL_BLUE:
+    case GL_ALPHA:
+    case GL_RG:
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGBA:
+    case GL_BGRA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int componentCount(const GLenum format)
+{
+    return globjects::pixelSizeInBytes(format, GL_UNSIGNED_BYTE);
+}
+
+struct Conversion
+{
+    RowKernel Kernels::* kernel;   // nullptr for copying rows
+    int countPerPixel;             // kernel count for one pixel
+};
+
+bool findConversion(const globjects::pixels::Layout & source, const globjects::pixels::Layout & destination, const bool decodeSRGB, Conversion & conversion)
+{
+    conversion.kernel = nullptr;
+    conversion.countPerPixel = 1;
+
+    if (decodeSRGB)
+    {
+        if (source.format != destination.format || !isColorFormat(source.format)
+            || source.type != GL_UNSIGNED_BYTE || destination.type != GL_FLOAT)
+            return false;
+
+        if (source.format == GL_RGBA || source.format == GL_BGRA)
+        {
+            conversion.kernel = &Kernels::srgbAlphaToFloat;
+        }
+        else
+        {
+            conversion.kernel = source.format == GL_ALPHA ? &Kernels::byteToFloat : &Kernels::srgbToFloat;
+            conversion.countPerPixel = componentCount(source.format);
+        }
+
+        return true;
+    }
+
+    if (source.format == destination.format && source.type == destination.type)
+        return source.pixelSize() > 0;
+
+    if (source.format == destination.format)
+    {
+        if (!isColorFormat(source.format))
+            return false;
+
+        conversion.countPerPixel = componentCount(source.format);
+
+        if (source.type == GL_FLOAT && destination.type == GL_HALF_FLOAT)
+            conversion.kernel = &Kernels::floatToHalf;
+        else if (source.type == GL_UNSIGNED_BYTE && destination.type == GL_FLOAT)
+            conversion.kernel = &Kernels::byteToFloat;
+
+        return conversion.kernel != nullptr;
+    }
+
+    if (source.type != GL_UNSIGNED_BYTE || destination.type != GL_UNSIGNED_BYTE)
+        return false;
+
+    const bool sourceRGB = source.format == GL_RGB || source.format == GL_BGR;
+    const bool sourceRGBA = source.format == GL_RGBA || source.format == GL_BGRA;
+    const bool destinationRGBA = destination.format == GL_RGBA || destination.format == GL_BGRA;
+
+    if (!destinationRGBA)
+        return false;
+
+    // the channel order is swapped unless both are red first or both are blue first
+    const bool swap = (source.format == GL_RGB || source.format == GL_RGBA) != (destination.format == GL_RGBA);
+
+    if (sourceRGB)
+        conversion.kernel = swap ? &Kernels::expandSwapRGB : &Kernels::expandRGB;
+    else if (sourceRGBA && swap)
+        conversion.kernel = &Kernels::swapRGBA;
+
+    return conversion.kernel != nullptr;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+namespace pixels
+{
+
+Layout::Layout(const GLenum format, const GLenum type, const int alignment, const int rowLength)
+: format(format)
+, type(type)
+, alignment(alignment)
+, rowLength(rowLength)
+{
+    assert(alignment == 1 || alignment == 2 || alignment == 4 || alignment == 8);
+}
+
+Layout Layout::unpack(const GLenum format, const GLenum type)
+{
+    return Layout(format, type, getInteger(GL_UNPACK_ALIGNMENT), getInteger(GL_UNPACK_ROW_LENGTH));
+}
+
+int Layout::pixelSize() const
+{
+    return pixelSizeInBytes(format, type);
+}
+
+std::size_t Layout::rowStride(const int width) const
+{
+    const std::size_t size = static_cast<std::size_t>(rowLength > 0 ? rowLength : width) * static_cast<std::size_t>(pixelSize());
+    const std::size_t padding = static_cast<std::size_t>(alignment);
+
+    return (size + padding - 1) / padding * padding;
+}
+
+std::size_t Layout::byteSize(const glm::ivec2 & size) const
+{
+    return rowStride(size.x) * static_cast<std::size_t>(size.y);
+}
+
+bool isSupported(const Layout & source, const Layout & destination, const bool decodeSRGB)
+{
+    Conversion conversion;
+
+    return findConversion(source, destination, decodeSRGB, conversion);
+}
+
+bool convert(const void * source, const Layout & sourceLayout, void * destination, const Layout & destinationLayout, const glm::ivec2 & size, const bool decodeSRGB)
+{
+    Conversion conversion;
+
+    if (!findConversion(sourceLayout, destinationLayout, decodeSRGB, conversion))
+        return false;
+
+    if (size.x <= 0 || size.y <= 0)
+        return true;
+
+    const unsigned char * sourceRow = static_cast<const unsigned char *>(source);
+    unsigned char * destinationRow = static_cast<unsigned char *>(destination);
+
+    const std::size_t sourceStride = sourceLayout.rowStride(size.x);
+    const std::size_t destinationStride = destinationLayout.rowStride(size.x);
+
+    if (!conversion.kernel)
+    {
+        const std::size_t rowSize = static_cast<std::size_t>(size.x) * static_cast<std::size_t>(sourceLayout.pixelSize());
+
+        // unpadded rows are copied at once
+        if (sourceStride == rowSize && destinationStride == rowSize)
+        {
+            std::memcpy(destinationRow, sourceRow, rowSize * static_cast<std::size_t>(size.y));
+            return true;
+        }
+
+        for (int y = 0; y < size.y; ++y, sourceRow += sourceStride, destinationRow += destinationStride)
+            std::memcpy(destinationRow, sourceRow, rowSize);
+
+        return true;
+    }
+
+    const RowKernel kernel = select(conversion.kernel);
+    const int count = size.x * conversion.countPerPixel;
+
+    for (int y = 0; y < size.y; ++y, sourceRow += sourceStride, destinationRow += destinationStride)
+        kernel(sourceRow, destinationRow, count);
+
+    return true;
+}
+
+InstructionSet instructionSet()
+{
+    return availableInstructionSet();
+}
+
+void limitInstructionSet(const InstructionSet instructionSet)
+{
+    g_limit.store(static_cast<int>(instructionSet));
+}
+
+} // namespace pixels
+} // namespace globjects
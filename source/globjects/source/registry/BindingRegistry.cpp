@@ -0,0 +1,227 @@
+#include "BindingRegistry.h"
+#include "Registry.h"
+
+#include <iterator>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+using namespace gl;
+
+namespace
+{
+
+template <typename Map>
+bool isBound(const Map & bindings, const typename Map::key_type & key, const GLuint name)
+{
+    auto it = bindings.find(key);
+
+    return it != bindings.end() && it->second == name;
+}
+
+template <typename Map, typename Predicate>
+void eraseIf(Map & bindings, Predicate predicate)
+{
+    for (auto it = bindings.begin(); it != bindings.end();)
+    {
+        it = predicate(it->second) ? bindings.erase(it) : std::next(it);
+    }
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+BindingRegistry::BindingRegistry()
+: m_programKnown(false)
+, m_program(0)
+, m_vertexArrayKnown(false)
+, m_vertexArray(0)
+, m_activeTexture(GL_NONE)
+{
+}
+
+BindingRegistry & BindingRegistry::current()
+{
+    return Registry::current().bindings();
+}
+
+void BindingRegistry::useProgram(const GLuint program)
+{
+    if (m_programKnown && m_program == program)
+        return;
+
+    glUseProgram(program);
+
+    m_programKnown = true;
+    m_program = program;
+}
+
+void BindingRegistry::bindVertexArray(const GLuint vertexArray)
+{
+    if (m_vertexArrayKnown && m_vertexArray == vertexArray)
+        return;
+
+    glBindVertexArray(vertexArray);
+
+    m_vertexArrayKnown = true;
+    m_vertexArray = vertexArray;
+
+    // the element array buffer binding is part of the vertex array state
+    m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+}
+
+void BindingRegistry::bindBuffer(const GLenum target, const GLuint buffer)
+{
+    if (isBound(m_buffers, target, buffer))
+        return;
+
+    glBindBuffer(target, buffer);
+
+    m_buffers[target] = buffer;
+}
+
+void BindingRegistry::bindBufferBase(const GLenum target, const GLuint index, const GLuint buffer)
+{
+    const auto key = std::make_pair(target, index);
+    auto it = m_indexedBuffers.find(key);
+
+    if (it != m_indexedBuffers.end() && it->second.buffer == buffer && it->second.size == -1)
+        return;
+
+    glBindBufferBase(target, index, buffer);
+
+    m_indexedBuffers[key] = { buffer, 0, -1 };
+    m_buffers[target] = buffer; // indexed binds update the generic binding as well
+}
+
+void BindingRegistry::bindBufferRange(const GLenum target, const GLuint index, const GLuint buffer, const GLintptr offset, const GLsizeiptr size)
+{
+    const auto key = std::make_pair(target, index);
+    auto it = m_indexedBuffers.find(key);
+
+    if (it != m_indexedBuffers.end() && it->second.buffer == buffer && it->second.offset == offset && it->second.size == size)
+        return;
+
+    glBindBufferRange(target, index, buffer, offset, size);
+
+    m_indexedBuffers[key] = { buffer, offset, size };
+    m_buffers[target] = buffer;
+}
+
+void BindingRegistry::activeTexture(const GLenum unit)
+{
+    if (m_activeTexture == unit)
+        return;
+
+    glActiveTexture(unit);
+
+    m_activeTexture = unit;
+}
+
+void BindingRegistry::bindTexture(const GLenum target, const GLuint texture)
+{
+    if (m_activeTexture == GL_NONE)
+    {
+        // the texture unit is unknown, so the binding cannot be cached
+        glBindTexture(target, texture);
+
+        return;
+    }
+
+    const auto key = std::make_pair(m_activeTexture, target);
+
+    if (isBound(m_textures, key, texture))
+        return;
+
+    glBindTexture(target, texture);
+
+    m_textures[key] = texture;
+}
+
+void BindingRegistry::bindSampler(const GLuint unit, const GLuint sampler)
+{
+    if (isBound(m_samplers, unit, sampler))
+        return;
+
+    glBindSampler(unit, sampler);
+
+    m_samplers[unit] = sampler;
+}
+
+void BindingRegistry::bindFramebuffer(const GLenum target, const GLuint framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        if (isBound(m_framebuffers, GL_DRAW_FRAMEBUFFER, framebuffer) && isBound(m_framebuffers, GL_READ_FRAMEBUFFER, framebuffer))
+            return;
+
+        glBindFramebuffer(target, framebuffer);
+
+        m_framebuffers[GL_DRAW_FRAMEBUFFER] = framebuffer;
+        m_framebuffers[GL_READ_FRAMEBUFFER] = framebuffer;
+
+        return;
+    }
+
+    if (isBound(m_framebuffers, target, framebuffer))
+        return;
+
+    glBindFramebuffer(target, framebuffer);
+
+    m_framebuffers[target] = framebuffer;
+}
+
+void BindingRegistry::programDeleted(const GLuint program)
+{
+    // a deleted program stays in use until another one is used
+    if (m_program == program)
+        m_programKnown = false;
+}
+
+void BindingRegistry::vertexArrayDeleted(const GLuint vertexArray)
+{
+    if (m_vertexArray == vertexArray)
+    {
+        m_vertexArrayKnown = false;
+        m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+void BindingRegistry::bufferDeleted(const GLuint buffer)
+{
+    eraseIf(m_buffers, [buffer](GLuint name) { return name == buffer; });
+    eraseIf(m_indexedBuffers, [buffer](const IndexedBufferBinding & binding) { return binding.buffer == buffer; });
+}
+
+void BindingRegistry::textureDeleted(const GLuint texture)
+{
+    eraseIf(m_textures, [texture](GLuint name) { return name == texture; });
+}
+
+void BindingRegistry::samplerDeleted(const GLuint sampler)
+{
+    eraseIf(m_samplers, [sampler](GLuint name) { return name == sampler; });
+}
+
+void BindingRegistry::framebufferDeleted(const GLuint framebuffer)
+{
+    eraseIf(m_framebuffers, [framebuffer](GLuint name) { return name == framebuffer; });
+}
+
+void BindingRegistry::invalidate()
+{
+    m_programKnown = false;
+    m_vertexArrayKnown = false;
+    m_activeTexture = GL_NONE;
+
+    m_buffers.clear();
+    m_indexedBuffers.clear();
+    m_textures.clear();
+    m_samplers.clear();
+    m_framebuffers.clear();
+}
+
+} // namespace globjects
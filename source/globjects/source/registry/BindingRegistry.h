@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include <glbinding/gl/types.h>
+
+namespace globjects
+{
+
+/** \brief Caches the object bindings of a context to skip redundant bind calls.
+
+    All bind paths of globjects (Program::use(), VertexArray::bind(),
+    Buffer::bind(), Texture::bindActive(), ...) go through this registry, which
+    only forwards a binding to OpenGL if it differs from the cached one.
+
+    Bindings are unknown until globjects bound them once, or after
+    invalidate() was called. Unknown bindings are always forwarded. Deleted
+    objects are forgotten, as OpenGL resets bindings to deleted names.
+*/
+class BindingRegistry
+{
+public:
+    BindingRegistry();
+    static BindingRegistry & current();
+
+    void useProgram(gl::GLuint program);
+    void bindVertexArray(gl::GLuint vertexArray);
+    void bindBuffer(gl::GLenum target, gl::GLuint buffer);
+    void bindBufferBase(gl::GLenum target, gl::GLuint index, gl::GLuint buffer);
+    void bindBufferRange(gl::GLenum target, gl::GLuint index, gl::GLuint buffer, gl::GLintptr offset, gl::GLsizeiptr size);
+    void activeTexture(gl::GLenum unit);
+    void bindTexture(gl::GLenum target, gl::GLuint texture);
+    void bindSampler(gl::GLuint unit, gl::GLuint sampler);
+    void bindFramebuffer(gl::GLenum target, gl::GLuint framebuffer);
+
+    void programDeleted(gl::GLuint program);
+    void vertexArrayDeleted(gl::GLuint vertexArray);
+    void bufferDeleted(gl::GLuint buffer);
+    void textureDeleted(gl::GLuint texture);
+    void samplerDeleted(gl::GLuint sampler);
+    void framebufferDeleted(gl::GLuint framebuffer);
+
+    void invalidate();
+
+protected:
+    struct IndexedBufferBinding
+    {
+        gl::GLuint buffer;
+        gl::GLintptr offset;
+        gl::GLsizeiptr size; // -1 for glBindBufferBase
+    };
+
+    bool m_programKnown;
+    gl::GLuint m_program;
+    bool m_vertexArrayKnown;
+    gl::GLuint m_vertexArray;
+    gl::GLenum m_activeTexture; // GL_NONE if unknown
+
+    std::unordered_map<gl::GLenum, gl::GLuint> m_buffers;
+    std::map<std::pair<gl::GLenum, gl::GLuint>, IndexedBufferBinding> m_indexedBuffers;
+    std::map<std::pair<gl::GLenum, gl::GLenum>, gl::GLuint> m_textures;
+    std::unordered_map<gl::GLuint, gl::GLuint> m_samplers;
+    std::unordered_map<gl::GLenum, gl::GLuint> m_framebuffers;
+};
+
+} // namespace globjects
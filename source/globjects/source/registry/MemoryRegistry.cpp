@@ -0,0 +1,345 @@
+#include "MemoryRegistry.h"
+#include "Registry.h"
+
+#include <initializer_list>
+#include <sstream>
+
+#include <glbinding/gl/enum.h>
+
+using namespace gl;
+
+namespace
+{
+
+const char * typeName(const GLenum objectType)
+{
+    switch (objectType)
+    {
+    case GL_BUFFER:
+        return "buffer";
+    case GL_TEXTURE:
+        return "texture";
+    case GL_RENDERBUFFER:
+        return "renderbuffer";
+    default:
+        return "unknown";
+    }
+}
+
+std::string escape(const std::string & text)
+{
+    std::string result;
+    result.reserve(text.size());
+
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                continue;
+
+            result += c;
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+MemoryRegistry::MemoryRegistry()
+: m_allocated(0)
+, m_highWaterMark(0)
+{
+}
+
+MemoryRegistry & MemoryRegistry::current()
+{
+    return Registry::current().memory();
+}
+
+bool MemoryRegistry::isTracked(const GLenum objectType)
+{
+    return objectType == GL_BUFFER || objectType == GL_TEXTURE || objectType == GL_RENDERBUFFER;
+}
+
+void MemoryRegistry::allocate(const GLenum objectType, const GLuint id, const GLint64 size)
+{
+    std::vector<Budget> exceeded;
+    GLint64 allocated;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry & entry = this->entry(objectType, id);
+        entry.images.clear();
+
+        resize(entry, objectType, size);
+
+        exceeded = checkBudgets();
+        allocated = m_allocated;
+    }
+
+    notify(exceeded, allocated);
+}
+
+void MemoryRegistry::allocateImage(const GLuint texture, const GLenum target, const GLint level, const GLint64 size)
+{
+    std::vector<Budget> exceeded;
+    GLint64 allocated;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry & entry = this->entry(GL_TEXTURE, texture);
+
+        // a texture defined by storage before is redefined image by image
+        const GLint64 previous = entry.images.empty() ? 0 : entry.size;
+
+        GLint64 & image = entry.images[ImageKey(target, level)];
+        const GLint64 total = previous - image + size;
+        image = size;
+
+        resize(entry, GL_TEXTURE, total);
+
+        exceeded = checkBudgets();
+        allocated = m_allocated;
+    }
+
+    notify(exceeded, allocated);
+}
+
+void MemoryRegistry::deallocate(const GLenum objectType, const GLuint id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_pendingLabels.erase(Key(objectType, id));
+
+    const auto it = m_entries.find(Key(objectType, id));
+
+    if (it == m_entries.end())
+        return;
+
+    resize(it->second, objectType, 0);
+    m_entries.erase(it);
+
+    checkBudgets(); // re-arms budgets that are no longer exceeded
+}
+
+void MemoryRegistry::setLabel(const GLenum objectType, const GLuint id, const std::string & label)
+{
+    if (!isTracked(objectType))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_entries.find(Key(objectType, id));
+
+    // objects are usually named before their storage is allocated
+    if (it != m_entries.end())
+        it->second.label = label;
+    else
+        m_pendingLabels[Key(objectType, id)] = label;
+}
+
+GLint64 MemoryRegistry::allocated() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_allocated;
+}
+
+GLint64 MemoryRegistry::allocated(const GLenum objectType) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_allocatedByType.find(objectType);
+
+    return it != m_allocatedByType.end() ? it->second : 0;
+}
+
+GLint64 MemoryRegistry::allocated(const GLenum objectType, const GLuint id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_entries.find(Key(objectType, id));
+
+    return it != m_entries.end() ? it->second.size : 0;
+}
+
+std::map<std::string, GLint64> MemoryRegistry::allocatedByLabel() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::map<std::string, GLint64> result;
+
+    for (const auto & pair : m_entries)
+        result[pair.second.label] += pair.second.size;
+
+    return result;
+}
+
+GLint64 MemoryRegistry::highWaterMark() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_highWaterMark;
+}
+
+void MemoryRegistry::resetHighWaterMark()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_highWaterMark = m_allocated;
+}
+
+void MemoryRegistry::addBudget(const GLint64 budget, const memory::BudgetCallback & callback)
+{
+    std::vector<Budget> exceeded;
+    GLint64 allocated;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_budgets.push_back({ budget, callback, false });
+
+        exceeded = checkBudgets();
+        allocated = m_allocated;
+    }
+
+    notify(exceeded, allocated);
+}
+
+void MemoryRegistry::clearBudgets()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_budgets.clear();
+}
+
+std::string MemoryRegistry::toJson() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::map<std::string, GLint64> labels;
+    for (const auto & pair : m_entries)
+    {
+        if (!pair.second.label.empty())
+            labels[pair.second.label] += pair.second.size;
+    }
+
+    std::stringstream stream;
+
+    stream << "{\"allocated\":" << m_allocated << ",\"highWaterMark\":" << m_highWaterMark;
+
+    stream << ",\"types\":{";
+    for (const GLenum type : { GL_BUFFER, GL_TEXTURE, GL_RENDERBUFFER })
+    {
+        const auto it = m_allocatedByType.find(type);
+
+        stream << (type != GL_BUFFER ? "," : "") << "\"" << typeName(type) << "\":" << (it != m_allocatedByType.end() ? it->second : 0);
+    }
+    stream << "}";
+
+    stream << ",\"labels\":{";
+    for (auto it = labels.begin(); it != labels.end(); ++it)
+        stream << (it != labels.begin() ? "," : "") << "\"" << escape(it->first) << "\":" << it->second;
+    stream << "}";
+
+    stream << ",\"budgets\":[";
+    for (auto it = m_budgets.begin(); it != m_budgets.end(); ++it)
+        stream << (it != m_budgets.begin() ? "," : "") << "{\"budget\":" << it->budget << ",\"exceeded\":" << (it->exceeded ? "true" : "false") << "}";
+    stream << "]";
+
+    stream << ",\"objects\":[";
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        stream << (it != m_entries.begin() ? "," : "")
+            << "{\"type\":\"" << typeName(it->first.first) << "\",\"id\":" << it->first.second
+            << ",\"label\":\"" << escape(it->second.label) << "\",\"size\":" << it->second.size << "}";
+    }
+    stream << "]}";
+
+    return stream.str();
+}
+
+MemoryRegistry::Entry & MemoryRegistry::entry(const GLenum objectType, const GLuint id)
+{
+    const Key key(objectType, id);
+
+    const auto it = m_entries.find(key);
+
+    if (it != m_entries.end())
+        return it->second;
+
+    Entry & entry = m_entries[key];
+
+    const auto label = m_pendingLabels.find(key);
+
+    if (label != m_pendingLabels.end())
+    {
+        entry.label = label->second;
+        m_pendingLabels.erase(label);
+    }
+
+    return entry;
+}
+
+void MemoryRegistry::resize(Entry & entry, const GLenum objectType, const GLint64 size)
+{
+    const GLint64 delta = size - entry.size;
+
+    entry.size = size;
+
+    m_allocatedByType[objectType] += delta;
+    m_allocated += delta;
+
+    if (m_allocated > m_highWaterMark)
+        m_highWaterMark = m_allocated;
+}
+
+std::vector<MemoryRegistry::Budget> MemoryRegistry::checkBudgets()
+{
+    std::vector<Budget> exceeded;
+
+    for (Budget & budget : m_budgets)
+    {
+        const bool isExceeded = m_allocated > budget.budget;
+
+        // callbacks are only called when a budget is crossed, not on every allocation above it
+        if (isExceeded && !budget.exceeded)
+            exceeded.push_back(budget);
+
+        budget.exceeded = isExceeded;
+    }
+
+    return exceeded;
+}
+
+void MemoryRegistry::notify(const std::vector<Budget> & exceeded, const GLint64 allocated)
+{
+    for (const Budget & budget : exceeded)
+    {
+        if (budget.callback)
+            budget.callback(allocated, budget.budget);
+    }
+}
+
+} // namespace globjects
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/memory.h>
+
+namespace globjects
+{
+
+/** \brief Ledger of the storage globjects allocated for buffers, textures and renderbuffers.
+
+    Buffer::setData()/setStorage(), the Texture image and storage functions
+    and Renderbuffer::storage() report the estimated size of each object
+    they own, i.e., not of objects created from ids, and the resource
+    destructors remove it. Texture images specified per level
+    or cube map face are accounted individually. The registry is shared
+    within a share group, like the objects themselves, and therefore locked.
+    It is exported for the tests, which use it without a context.
+*/
+class GLOBJECTS_API MemoryRegistry
+{
+public:
+    MemoryRegistry();
+    static MemoryRegistry & current();
+
+    /** Replaces all storage of an object. */
+    void allocate(gl::GLenum objectType, gl::GLuint id, gl::GLint64 size);
+
+    /** Replaces the storage of one level of one face of a texture. */
+    void allocateImage(gl::GLuint texture, gl::GLenum target, gl::GLint level, gl::GLint64 size);
+
+    void deallocate(gl::GLenum objectType, gl::GLuint id);
+
+    /** Labels the entry of an object, or its first entry if it has no storage yet. */
+    void setLabel(gl::GLenum objectType, gl::GLuint id, const std::string & label);
+
+    gl::GLint64 allocated() const;
+    gl::GLint64 allocated(gl::GLenum objectType) const;
+    gl::GLint64 allocated(gl::GLenum objectType, gl::GLuint id) const;
+    std::map<std::string, gl::GLint64> allocatedByLabel() const;
+
+    gl::GLint64 highWaterMark() const;
+    void resetHighWaterMark();
+
+    void addBudget(gl::GLint64 budget, const memory::BudgetCallback & callback);
+    void clearBudgets();
+
+    std::string toJson() const;
+
+protected:
+    using Key = std::pair<gl::GLenum, gl::GLuint>;
+    using ImageKey = std::pair<gl::GLenum, gl::GLint>;
+
+    struct Entry
+    {
+        gl::GLint64 size;
+        std::map<ImageKey, gl::GLint64> images; // per face and level, empty for whole-object storage
+        std::string label;
+    };
+
+    struct Budget
+    {
+        gl::GLint64 budget;
+        memory::BudgetCallback callback;
+        bool exceeded;
+    };
+
+    static bool isTracked(gl::GLenum objectType);
+
+    // creates the entry of an object with the label given to it before
+    Entry & entry(gl::GLenum objectType, gl::GLuint id);
+
+    void resize(Entry & entry, gl::GLenum objectType, gl::GLint64 size);
+
+    // returns the budgets that were exceeded by the last change, to be notified after unlocking
+    std::vector<Budget> checkBudgets();
+    static void notify(const std::vector<Budget> & exceeded, gl::GLint64 allocated);
+
+protected:
+    mutable std::mutex m_mutex;
+
+    std::map<Key, Entry> m_entries;
+    std::map<Key, std::string> m_pendingLabels; // of objects named before their storage is allocated
+    std::map<gl::GLenum, gl::GLint64> m_allocatedByType;
+    gl::GLint64 m_allocated;
+    gl::GLint64 m_highWaterMark;
+
+    std::vector<Budget> m_budgets;
+};
+
+} // namespace globjects
@@ -23,17 +23,9 @@ ObjectRegistry & ObjectRegistry::current()
 
 std::set<Object*> ObjectRegistry::objects() const
 {
-    return m_objects;
-}
-
-std::set<Object *>::iterator ObjectRegistry::begin()
-{
-    return m_objects.begin();
-}
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
-std::set<Object *>::iterator ObjectRegistry::end()
-{
-    return m_objects.end();
+    return m_objects;
 }
 
 void ObjectRegistry::registerObject(Object * object)
@@ -43,6 +35,8 @@ void ObjectRegistry::registerObject(Object * object)
 	if (object->id() == 0)
         return;
 
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
     m_objects.insert(object);
 }
 
@@ -53,11 +47,15 @@ void ObjectRegistry::deregisterObject(Object * object)
     if (object->id() == 0)
         return;
 
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
     m_objects.erase(object);
 }
 
 Framebuffer * ObjectRegistry::defaultFBO()
 {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
     if (m_defaultFBO == nullptr)
     {
         m_defaultFBO = Framebuffer::fromId(0);
@@ -69,6 +67,8 @@ Framebuffer * ObjectRegistry::defaultFBO()
 
 VertexArray * ObjectRegistry::defaultVAO()
 {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
     if (m_defaultVAO == nullptr)
     {
         m_defaultVAO = VertexArray::fromId(0);
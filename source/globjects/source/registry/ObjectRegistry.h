@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <set>
 
 namespace globjects 
@@ -11,7 +12,10 @@ class VertexArray;
 
 /** \brief Tracks all wrapped OpenGL objects in globjects.
     
-    To obtain all wrapped objects use objects().
+    To obtain all wrapped objects use objects(). The registry is shared
+    within a share group, where objects may be created and deleted on
+    several threads (e.g., by the upload thread of TextureLoader), and
+    therefore locked.
 */
 class ObjectRegistry
 {
@@ -22,9 +26,6 @@ public:
 
     std::set<Object *> objects() const;
 
-    std::set<Object *>::iterator begin();
-    std::set<Object *>::iterator end();
-
     Framebuffer * defaultFBO();
     VertexArray * defaultVAO();
 
@@ -33,6 +34,8 @@ protected:
     void deregisterObject(Object * object);
 
 protected:
+    // recursive, as creating the default objects registers them
+    mutable std::recursive_mutex m_mutex;
     std::set<Object *> m_objects;
     Framebuffer * m_defaultFBO;
     VertexArray * m_defaultVAO;
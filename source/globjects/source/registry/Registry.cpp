@@ -8,6 +8,10 @@
 #include "ExtensionRegistry.h"
 #include "ImplementationRegistry.h"
 #include "NamedStringRegistry.h"
+#include "StateRegistry.h"
+#include "BindingRegistry.h"
+#include "MemoryRegistry.h"
+#include "SamplerRegistry.h"
 
 namespace
 {
@@ -136,11 +140,17 @@ Registry::Registry(Registry * sharedRegistry)
 , m_extensions(sharedRegistry->m_extensions)
 , m_implementations(sharedRegistry->m_implementations)
 , m_namedStrings(sharedRegistry->m_namedStrings)
+, m_state(new StateRegistry) // OpenGL state and bindings are not shared between contexts
+, m_bindings(new BindingRegistry)
+, m_memory(sharedRegistry->m_memory) // objects and therefore their storage are shared
+, m_samplers(sharedRegistry->m_samplers)
 {
 }
 
 Registry::~Registry()
 {
+    // shared samplers deregister from the object registry when they are deleted
+    m_samplers.reset();
 }
 
 void Registry::initialize()
@@ -149,6 +159,10 @@ void Registry::initialize()
     m_extensions.reset(new ExtensionRegistry);
     m_namedStrings.reset(new NamedStringRegistry);
     m_implementations.reset(new ImplementationRegistry);
+    m_state.reset(new StateRegistry);
+    m_bindings.reset(new BindingRegistry);
+    m_memory.reset(new MemoryRegistry);
+    m_samplers.reset(new SamplerRegistry);
 
     m_initialized = true;
 }
@@ -178,4 +192,24 @@ NamedStringRegistry & Registry::namedStrings()
     return *m_namedStrings;
 }
 
+StateRegistry & Registry::state()
+{
+    return *m_state;
+}
+
+BindingRegistry & Registry::bindings()
+{
+    return *m_bindings;
+}
+
+MemoryRegistry & Registry::memory()
+{
+    return *m_memory;
+}
+
+SamplerRegistry & Registry::samplers()
+{
+    return *m_samplers;
+}
+
 } // namespace globjects
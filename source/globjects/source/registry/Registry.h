@@ -12,6 +12,10 @@ class ObjectRegistry;
 class ExtensionRegistry;
 class ImplementationRegistry;
 class NamedStringRegistry;
+class StateRegistry;
+class BindingRegistry;
+class MemoryRegistry;
+class SamplerRegistry;
 
 
 class Registry
@@ -29,6 +33,10 @@ public:
     ExtensionRegistry & extensions();
     ImplementationRegistry & implementations();
     NamedStringRegistry & namedStrings();
+    StateRegistry & state();
+    BindingRegistry & bindings();
+    MemoryRegistry & memory();
+    SamplerRegistry & samplers();
 
     bool isInitialized() const;
 
@@ -50,6 +58,10 @@ private:
     std::shared_ptr<ExtensionRegistry> m_extensions;
     std::shared_ptr<ImplementationRegistry> m_implementations;
     std::shared_ptr<NamedStringRegistry> m_namedStrings;
+    std::shared_ptr<StateRegistry> m_state;
+    std::shared_ptr<BindingRegistry> m_bindings;
+    std::shared_ptr<MemoryRegistry> m_memory;
+    std::shared_ptr<SamplerRegistry> m_samplers;
 };
 
 } // namespace globjects
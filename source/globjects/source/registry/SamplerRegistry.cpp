@@ -0,0 +1,34 @@
+#include "SamplerRegistry.h"
+
+#include "Registry.h"
+
+namespace globjects
+{
+
+SamplerRegistry::SamplerRegistry()
+{
+}
+
+SamplerRegistry & SamplerRegistry::current()
+{
+    return Registry::current().samplers();
+}
+
+const Sampler * SamplerRegistry::sampler(const SamplerParameters & parameters)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_samplers.find(parameters);
+
+    if (it != m_samplers.end())
+        return it->second;
+
+    ref_ptr<Sampler> sampler = new Sampler;
+    sampler->setParameters(parameters);
+
+    m_samplers[parameters] = sampler;
+
+    return sampler;
+}
+
+} // namespace globjects
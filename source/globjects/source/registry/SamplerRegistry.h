@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include <globjects/base/ref_ptr.h>
+#include <globjects/Sampler.h>
+
+namespace globjects
+{
+
+/** \brief Shared samplers, one per distinct set of parameters.
+
+    Samplers are shared objects, so the registry is shared within a share
+    group and therefore locked. The samplers are released along with the
+    registry, i.e., when the last context of the share group is deregistered.
+*/
+class SamplerRegistry
+{
+public:
+    SamplerRegistry();
+    static SamplerRegistry & current();
+
+    const Sampler * sampler(const SamplerParameters & parameters);
+
+protected:
+    mutable std::mutex m_mutex;
+    std::unordered_map<SamplerParameters, ref_ptr<Sampler>> m_samplers;
+};
+
+} // namespace globjects
@@ -0,0 +1,301 @@
+#include "StateRegistry.h"
+#include "Registry.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+#include <globjects/base/ref_ptr.h>
+
+#include <globjects/globjects.h>
+#include <globjects/State.h>
+#include <globjects/StateGuard.h>
+
+using namespace gl;
+
+namespace
+{
+
+using namespace globjects;
+
+template <typename... Arguments>
+StateSettingType settingType(void (*function)(Arguments...), const GLenum subtype = GL_NONE)
+{
+    StateSettingType type(*reinterpret_cast<void**>(&function));
+
+    if (subtype != GL_NONE)
+    {
+        type.specializeType(subtype);
+    }
+
+    return type;
+}
+
+using AliasMap = std::unordered_map<StateSettingType, std::vector<StateSettingType>>;
+using QueryMap = std::unordered_map<StateSettingType, std::function<void(State &)>>;
+
+const AliasMap & aliases()
+{
+    static const AliasMap aliases = {
+        { settingType(glBlendFunc), { settingType(glBlendFuncSeparate) } },
+        { settingType(glClearDepth), { settingType(glClearDepthf) } },
+        { settingType(glDepthRange), { settingType(glDepthRangef) } },
+        { settingType(glStencilFunc), { settingType(glStencilFuncSeparate, GL_FRONT), settingType(glStencilFuncSeparate, GL_BACK) } },
+        { settingType(glStencilFuncSeparate, GL_FRONT_AND_BACK), { settingType(glStencilFuncSeparate, GL_FRONT), settingType(glStencilFuncSeparate, GL_BACK) } },
+        { settingType(glStencilOp), { settingType(glStencilOpSeparate, GL_FRONT), settingType(glStencilOpSeparate, GL_BACK) } },
+        { settingType(glStencilOpSeparate, GL_FRONT_AND_BACK), { settingType(glStencilOpSeparate, GL_FRONT), settingType(glStencilOpSeparate, GL_BACK) } },
+        { settingType(glStencilMask), { settingType(glStencilMaskSeparate, GL_FRONT), settingType(glStencilMaskSeparate, GL_BACK) } },
+        { settingType(glStencilMaskSeparate, GL_FRONT_AND_BACK), { settingType(glStencilMaskSeparate, GL_FRONT), settingType(glStencilMaskSeparate, GL_BACK) } }
+    };
+
+    return aliases;
+}
+
+QueryMap createQueries()
+{
+    QueryMap queries;
+
+    queries[settingType(glBlendColor)] = [](State & state) { state.blendColor(getFloats<4>(GL_BLEND_COLOR)); };
+    queries[settingType(glBlendFuncSeparate)] = [](State & state) { state.blendFuncSeparate(getEnum(GL_BLEND_SRC_RGB), getEnum(GL_BLEND_DST_RGB), getEnum(GL_BLEND_SRC_ALPHA), getEnum(GL_BLEND_DST_ALPHA)); };
+    queries[settingType(glClearColor)] = [](State & state) { state.clearColor(getFloats<4>(GL_COLOR_CLEAR_VALUE)); };
+    queries[settingType(glClearDepthf)] = [](State & state) { state.clearDepth(getFloat(GL_DEPTH_CLEAR_VALUE)); };
+    queries[settingType(glClearStencil)] = [](State & state) { state.clearStencil(getInteger(GL_STENCIL_CLEAR_VALUE)); };
+    queries[settingType(glColorMask)] = [](State & state) { state.colorMask(getBooleans<4>(GL_COLOR_WRITEMASK)); };
+    queries[settingType(glCullFace)] = [](State & state) { state.cullFace(getEnum(GL_CULL_FACE_MODE)); };
+    queries[settingType(glDepthFunc)] = [](State & state) { state.depthFunc(getEnum(GL_DEPTH_FUNC)); };
+    queries[settingType(glDepthMask)] = [](State & state) { state.depthMask(getBoolean(GL_DEPTH_WRITEMASK)); };
+    queries[settingType(glDepthRangef)] = [](State & state) { state.depthRange(getFloats<2>(GL_DEPTH_RANGE)); };
+    queries[settingType(glFrontFace)] = [](State & state) { state.frontFace(getEnum(GL_FRONT_FACE)); };
+    queries[settingType(glLogicOp)] = [](State & state) { state.logicOp(getEnum(GL_LOGIC_OP_MODE)); };
+    queries[settingType(glPointSize)] = [](State & state) { state.pointSize(getFloat(GL_POINT_SIZE)); };
+    queries[settingType(glPolygonMode, GL_FRONT_AND_BACK)] = [](State & state) { state.polygonMode(GL_FRONT_AND_BACK, getEnum(GL_POLYGON_MODE)); };
+    queries[settingType(glPolygonOffset)] = [](State & state) { state.polygonOffset(getFloat(GL_POLYGON_OFFSET_FACTOR), getFloat(GL_POLYGON_OFFSET_UNITS)); };
+    queries[settingType(glPrimitiveRestartIndex)] = [](State & state) { state.primitiveRestartIndex(getInteger(GL_PRIMITIVE_RESTART_INDEX)); };
+    queries[settingType(glProvokingVertex)] = [](State & state) { state.provokingVertex(getEnum(GL_PROVOKING_VERTEX)); };
+    queries[settingType(glSampleCoverage)] = [](State & state) { state.sampleCoverage(getFloat(GL_SAMPLE_COVERAGE_VALUE), getBoolean(GL_SAMPLE_COVERAGE_INVERT)); };
+    queries[settingType(glScissor)] = [](State & state) { state.scissor(getIntegers<4>(GL_SCISSOR_BOX)); };
+    queries[settingType(glStencilFuncSeparate, GL_FRONT)] = [](State & state) { state.stencilFuncSeparate(GL_FRONT, getEnum(GL_STENCIL_FUNC), getInteger(GL_STENCIL_REF), getInteger(GL_STENCIL_VALUE_MASK)); };
+    queries[settingType(glStencilOpSeparate, GL_FRONT)] = [](State & state) { state.stencilOpSeparate(GL_FRONT, getEnum(GL_STENCIL_FAIL), getEnum(GL_STENCIL_PASS_DEPTH_FAIL), getEnum(GL_STENCIL_PASS_DEPTH_PASS)); };
+    queries[settingType(glStencilMaskSeparate, GL_FRONT)] = [](State & state) { state.stencilMaskSeparate(GL_FRONT, getInteger(GL_STENCIL_WRITEMASK)); };
+    queries[settingType(glStencilFuncSeparate, GL_BACK)] = [](State & state) { state.stencilFuncSeparate(GL_BACK, getEnum(GL_STENCIL_BACK_FUNC), getInteger(GL_STENCIL_BACK_REF), getInteger(GL_STENCIL_BACK_VALUE_MASK)); };
+    queries[settingType(glStencilOpSeparate, GL_BACK)] = [](State & state) { state.stencilOpSeparate(GL_BACK, getEnum(GL_STENCIL_BACK_FAIL), getEnum(GL_STENCIL_BACK_PASS_DEPTH_FAIL), getEnum(GL_STENCIL_BACK_PASS_DEPTH_PASS)); };
+    queries[settingType(glStencilMaskSeparate, GL_BACK)] = [](State & state) { state.stencilMaskSeparate(GL_BACK, getInteger(GL_STENCIL_BACK_WRITEMASK)); };
+
+    for (GLenum pname : { GL_POINT_FADE_THRESHOLD_SIZE, GL_POINT_SPRITE_COORD_ORIGIN })
+    {
+        queries[settingType(glPointParameteri, pname)] = [pname](State & state) { state.pointParameter(pname, getInteger(pname)); };
+    }
+
+    for (GLenum pname : {
+        GL_PACK_SWAP_BYTES, GL_PACK_LSB_FIRST, GL_PACK_ROW_LENGTH, GL_PACK_IMAGE_HEIGHT,
+        GL_PACK_SKIP_PIXELS, GL_PACK_SKIP_ROWS, GL_PACK_SKIP_IMAGES, GL_PACK_ALIGNMENT,
+        GL_UNPACK_SWAP_BYTES, GL_UNPACK_LSB_FIRST, GL_UNPACK_ROW_LENGTH, GL_UNPACK_IMAGE_HEIGHT,
+        GL_UNPACK_SKIP_PIXELS, GL_UNPACK_SKIP_ROWS, GL_UNPACK_SKIP_IMAGES, GL_UNPACK_ALIGNMENT })
+    {
+        queries[settingType(glPixelStorei, pname)] = [pname](State & state) { state.pixelStore(pname, getInteger(pname)); };
+    }
+
+    return queries;
+}
+
+const QueryMap & queries()
+{
+    static const QueryMap queries = createQueries();
+
+    return queries;
+}
+
+} // namespace
+
+
+namespace globjects
+{
+
+StateRegistry::StateRegistry()
+{
+}
+
+StateRegistry & StateRegistry::current()
+{
+    return Registry::current().state();
+}
+
+void StateRegistry::capabilityChanged(const GLenum capability, const bool enabled)
+{
+    for (StateGuard * guard : m_guards)
+    {
+        if (guard->m_capabilities.find(capability) != guard->m_capabilities.end())
+        {
+            continue;
+        }
+
+        guard->m_capabilities[capability] = isEnabled(capability);
+
+        // the non-indexed change overwrites all indices, so keep the known ones
+        for (const auto & entry : m_indexedCapabilities)
+        {
+            if (entry.first.first == capability)
+            {
+                guard->m_indexedCapabilities.insert(entry);
+            }
+        }
+    }
+
+    m_capabilities[capability] = enabled;
+
+    for (auto it = m_indexedCapabilities.begin(); it != m_indexedCapabilities.end();)
+    {
+        it = it->first.first == capability ? m_indexedCapabilities.erase(it) : std::next(it);
+    }
+}
+
+void StateRegistry::capabilityChanged(const GLenum capability, const int index, const bool enabled)
+{
+    const auto key = std::make_pair(capability, index);
+
+    for (StateGuard * guard : m_guards)
+    {
+        if (guard->m_indexedCapabilities.find(key) == guard->m_indexedCapabilities.end())
+        {
+            guard->m_indexedCapabilities[key] = isEnabled(capability, index);
+        }
+    }
+
+    m_indexedCapabilities[key] = enabled;
+
+    // the non-indexed value no longer holds for every index
+    m_capabilities.erase(capability);
+}
+
+void StateRegistry::settingChanged(const StateSetting & setting)
+{
+    const std::vector<StateSettingType> types = canonicalTypes(setting.type());
+
+    for (StateGuard * guard : m_guards)
+    {
+        for (const StateSettingType & type : types)
+        {
+            if (guard->m_settings.find(type) == guard->m_settings.end())
+            {
+                guard->m_settings[type] = settings(type);
+            }
+        }
+    }
+
+    for (const StateSettingType & type : types)
+    {
+        m_settings.erase(type);
+    }
+
+    // aliases that change several entries at once are queried again on demand
+    if (types.size() == 1)
+    {
+        m_settings.emplace(types.front(), setting);
+    }
+}
+
+bool StateRegistry::isEnabled(const GLenum capability)
+{
+    auto it = m_capabilities.find(capability);
+
+    if (it != m_capabilities.end())
+    {
+        return it->second;
+    }
+
+    const bool enabled = glIsEnabled(capability) == GL_TRUE;
+    m_capabilities[capability] = enabled;
+
+    return enabled;
+}
+
+bool StateRegistry::isEnabled(const GLenum capability, const int index)
+{
+    const auto key = std::make_pair(capability, index);
+
+    auto it = m_indexedCapabilities.find(key);
+
+    if (it != m_indexedCapabilities.end())
+    {
+        return it->second;
+    }
+
+    auto nonIndexed = m_capabilities.find(capability);
+
+    if (nonIndexed != m_capabilities.end())
+    {
+        return nonIndexed->second;
+    }
+
+    const bool enabled = glIsEnabledi(capability, index) == GL_TRUE;
+    m_indexedCapabilities[key] = enabled;
+
+    return enabled;
+}
+
+std::vector<StateSetting> StateRegistry::settings(const StateSettingType & type)
+{
+    auto it = m_settings.find(type);
+
+    if (it != m_settings.end())
+    {
+        return { it->second };
+    }
+
+    auto query = queries().find(type);
+
+    if (query == queries().end())
+    {
+        return {};
+    }
+
+    ref_ptr<State> state = new State(State::DeferredMode);
+    query->second(*state);
+
+    std::vector<StateSetting> result;
+
+    for (StateSetting * setting : state->settings())
+    {
+        result.push_back(*setting);
+    }
+
+    if (result.size() == 1)
+    {
+        m_settings.emplace(type, result.front());
+    }
+
+    return result;
+}
+
+std::vector<StateSettingType> StateRegistry::canonicalTypes(const StateSettingType & type)
+{
+    auto it = aliases().find(type);
+
+    if (it == aliases().end())
+    {
+        return { type };
+    }
+
+    return it->second;
+}
+
+void StateRegistry::invalidate()
+{
+    m_capabilities.clear();
+    m_indexedCapabilities.clear();
+    m_settings.clear();
+}
+
+void StateRegistry::registerGuard(StateGuard * guard)
+{
+    m_guards.push_back(guard);
+}
+
+void StateRegistry::deregisterGuard(StateGuard * guard)
+{
+    m_guards.erase(std::remove(m_guards.begin(), m_guards.end(), guard), m_guards.end());
+}
+
+} // namespace globjects
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/StateSetting.h>
+
+namespace globjects
+{
+
+class StateGuard;
+
+/** \brief Shadows the OpenGL state that was changed through globjects.
+
+    Every capability change (globjects::enable(), globjects::disable()) and
+    every applied StateSetting is reported before it reaches OpenGL. This way
+    the last known value of an entry can be looked up without a glGet round-trip
+    and active StateGuards get the chance to record the previous value.
+
+    Entries are unknown until globjects changed them once, or after
+    invalidate() was called. Unknown entries are queried from OpenGL on demand.
+*/
+class StateRegistry
+{
+public:
+    StateRegistry();
+    static StateRegistry & current();
+
+    void capabilityChanged(gl::GLenum capability, bool enabled);
+    void capabilityChanged(gl::GLenum capability, int index, bool enabled);
+    void settingChanged(const StateSetting & setting);
+
+    bool isEnabled(gl::GLenum capability);
+    bool isEnabled(gl::GLenum capability, int index);
+
+    /** Returns the state settings that restore the current value of the given
+        (canonical) type, or nothing if it is neither tracked nor queryable.
+    */
+    std::vector<StateSetting> settings(const StateSettingType & type);
+
+    /** Maps a state setting type to the disjoint, queryable types it changes,
+        e.g., glStencilFunc changes the front and the back face stencil function.
+    */
+    static std::vector<StateSettingType> canonicalTypes(const StateSettingType & type);
+
+    void invalidate();
+
+    void registerGuard(StateGuard * guard);
+    void deregisterGuard(StateGuard * guard);
+
+protected:
+    std::unordered_map<gl::GLenum, bool> m_capabilities;
+    std::map<std::pair<gl::GLenum, int>, bool> m_indexedCapabilities;
+    std::unordered_map<StateSettingType, StateSetting> m_settings;
+
+    std::vector<StateGuard *> m_guards;
+};
+
+} // namespace globjects
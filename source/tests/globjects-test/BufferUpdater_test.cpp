@@ -0,0 +1,74 @@
+#include <gmock/gmock.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/BufferUpdater.h>
+
+using namespace globjects;
+
+class BufferUpdater_test : public testing::Test
+{
+public:
+    using Strategy = BufferUpdater::Strategy;
+
+    static BufferUpdater::Pattern pattern(const bool orphanable)
+    {
+        BufferUpdater::Pattern pattern;
+        pattern.bufferSize = 1 << 20;
+        pattern.usage = gl::GL_DYNAMIC_DRAW;
+        pattern.orphanable = orphanable;
+        pattern.updateCount = 0;
+        pattern.lastFrame = 0;
+        pattern.interval = 1000.0f;
+        pattern.strategy = Strategy::SubData;
+
+        return pattern;
+    }
+
+    static Strategy select(const BufferUpdater::Pattern & pattern, const gl::GLintptr offset, const gl::GLsizeiptr size)
+    {
+        return BufferUpdater::select(pattern, offset, size, 4096, 1 << 22);
+    }
+};
+
+TEST_F(BufferUpdater_test, FullRewritesOrphanMutableStorage)
+{
+    EXPECT_EQ(Strategy::Orphan, select(pattern(true), 0, 1 << 20));
+    EXPECT_EQ(Strategy::StreamingWrite, select(pattern(false), 0, 1 << 20));
+}
+
+TEST_F(BufferUpdater_test, RareSmallPatchesUseSubData)
+{
+    BufferUpdater::Pattern rare = pattern(true);
+
+    BufferUpdater::record(rare, 0);
+    BufferUpdater::record(rare, 100);
+
+    EXPECT_EQ(Strategy::SubData, select(rare, 256, 64));
+}
+
+TEST_F(BufferUpdater_test, FrequentPatchesAreStreamed)
+{
+    BufferUpdater::Pattern frequent = pattern(true);
+
+    BufferUpdater::record(frequent, 0);
+    EXPECT_EQ(Strategy::SubData, select(frequent, 256, 64));
+
+    BufferUpdater::record(frequent, 1);
+    EXPECT_EQ(Strategy::StreamingWrite, select(frequent, 256, 64));
+
+    for (unsigned long long frame = 10; frame <= 100; frame += 10)
+        BufferUpdater::record(frequent, frame);
+
+    EXPECT_EQ(Strategy::SubData, select(frequent, 256, 64));
+}
+
+TEST_F(BufferUpdater_test, LargePatchesAreStreamedUnlessTooLargeForTheRing)
+{
+    EXPECT_EQ(Strategy::StreamingWrite, select(pattern(true), 0, 1 << 16));
+
+    BufferUpdater::Pattern large = pattern(true);
+    large.bufferSize = 1 << 24;
+
+    EXPECT_EQ(Strategy::SubData, select(large, 0, 1 << 23));
+}
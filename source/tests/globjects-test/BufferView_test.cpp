@@ -0,0 +1,128 @@
+#include <gmock/gmock.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <globjects/BufferView.h>
+
+using namespace globjects;
+
+class BufferView_test : public testing::Test
+{
+public:
+    // copies compile-time constants, so that they are not odr-used by the assertion macros
+    template <typename T>
+    static T value(const T constant)
+    {
+        return constant;
+    }
+};
+
+TEST_F(BufferView_test, VectorsFollowBaseAlignment)
+{
+    EXPECT_EQ(8u, value(BufferLayoutTraits<glm::vec2, BufferLayout::Std140>::alignment));
+    EXPECT_EQ(16u, value(BufferLayoutTraits<glm::vec3, BufferLayout::Std140>::alignment));
+    EXPECT_EQ(12u, value(BufferLayoutTraits<glm::vec3, BufferLayout::Std140>::size));
+    EXPECT_EQ(32u, value(BufferLayoutTraits<glm::dvec3, BufferLayout::Std430>::alignment));
+}
+
+TEST_F(BufferView_test, Std140RoundsArrayStridesToVec4)
+{
+    EXPECT_EQ(16u, value(BufferLayoutTraits<float, BufferLayout::Std140>::stride));
+    EXPECT_EQ(4u, value(BufferLayoutTraits<float, BufferLayout::Std430>::stride));
+
+    EXPECT_EQ(16u, value(BufferLayoutTraits<glm::vec2, BufferLayout::Std140>::stride));
+    EXPECT_EQ(8u, value(BufferLayoutTraits<glm::vec2, BufferLayout::Std430>::stride));
+
+    EXPECT_EQ(16u, value(BufferLayoutTraits<glm::vec3, BufferLayout::Std430>::stride));
+
+    EXPECT_EQ(64u, value(BufferLayoutTraits<std::array<float, 4>, BufferLayout::Std140>::size));
+    EXPECT_EQ(16u, value(BufferLayoutTraits<std::array<float, 4>, BufferLayout::Std430>::size));
+}
+
+TEST_F(BufferView_test, MatricesAreArraysOfColumns)
+{
+    EXPECT_EQ(48u, value(BufferLayoutTraits<glm::mat3, BufferLayout::Std140>::size));
+    EXPECT_EQ(48u, value(BufferLayoutTraits<glm::mat3, BufferLayout::Std430>::size));
+    EXPECT_EQ(64u, value(BufferLayoutTraits<glm::mat4, BufferLayout::Std140>::size));
+
+    EXPECT_EQ(32u, value(BufferLayoutTraits<glm::mat2, BufferLayout::Std140>::size));
+    EXPECT_EQ(16u, value(BufferLayoutTraits<glm::mat2, BufferLayout::Std430>::size));
+
+    EXPECT_FALSE(value(BufferLayoutTraits<glm::mat3, BufferLayout::Std430>::native));
+    EXPECT_TRUE(value(BufferLayoutTraits<glm::mat4, BufferLayout::Std140>::native));
+}
+
+TEST_F(BufferView_test, StructMembersArePacked)
+{
+    using Light = BufferStruct<glm::vec3, float, glm::vec2, glm::mat4>;
+
+    EXPECT_EQ(0u, value(BufferMemberOffset<Light, BufferLayout::Std140, 0>::value));
+    EXPECT_EQ(12u, value(BufferMemberOffset<Light, BufferLayout::Std140, 1>::value));
+    EXPECT_EQ(16u, value(BufferMemberOffset<Light, BufferLayout::Std140, 2>::value));
+    EXPECT_EQ(32u, value(BufferMemberOffset<Light, BufferLayout::Std140, 3>::value));
+    EXPECT_EQ(96u, value(BufferLayoutTraits<Light, BufferLayout::Std140>::size));
+
+    using Particle = BufferStruct<float, glm::vec2>;
+
+    EXPECT_EQ(8u, value(BufferMemberOffset<Particle, BufferLayout::Std430, 1>::value));
+    EXPECT_EQ(16u, value(BufferLayoutTraits<Particle, BufferLayout::Std430>::size));
+    EXPECT_EQ(16u, value(BufferLayoutTraits<Particle, BufferLayout::Std140>::alignment));
+}
+
+TEST_F(BufferView_test, NestedStructsAreAligned)
+{
+    using Inner = BufferStruct<float>;
+    using Outer = BufferStruct<float, Inner, float>;
+
+    EXPECT_EQ(16u, value(BufferMemberOffset<Outer, BufferLayout::Std140, 1>::value));
+    EXPECT_EQ(32u, value(BufferMemberOffset<Outer, BufferLayout::Std140, 2>::value));
+
+    EXPECT_EQ(4u, value(BufferMemberOffset<Outer, BufferLayout::Std430, 1>::value));
+    EXPECT_EQ(8u, value(BufferMemberOffset<Outer, BufferLayout::Std430, 2>::value));
+}
+
+TEST_F(BufferView_test, PaddedValuesRoundTrip)
+{
+    std::vector<char> memory(BufferView<glm::mat3>::byteSize(2));
+
+    BufferView<glm::mat3> view(memory.data(), 2);
+
+    glm::mat3 matrix;
+    for (int column = 0; column < 3; ++column)
+        matrix[column] = glm::vec3(static_cast<float>(column * 3), static_cast<float>(column * 3 + 1), static_cast<float>(column * 3 + 2));
+
+    view.set(1, matrix);
+
+    float row;
+    std::memcpy(&row, memory.data() + 48 + 16, sizeof(float));
+    EXPECT_EQ(3.0f, row);
+
+    EXPECT_TRUE(view.get(1)[2] == matrix[2]);
+}
+
+TEST_F(BufferView_test, StructMembersAreAccessedInPlace)
+{
+    using Light = BufferStruct<glm::vec3, float, std::array<float, 2>>;
+    using View = BufferView<Light, BufferLayout::Std140>;
+
+    std::vector<char> memory(View::byteSize(3));
+
+    View view(memory.data(), 3);
+
+    view.member<1>(2) = 5.0f;
+    view.setMember<2>(2, std::array<float, 2>{ { 1.0f, 2.0f } });
+
+    float radius;
+    std::memcpy(&radius, memory.data() + 2 * value(View::stride) + 12, sizeof(float));
+    EXPECT_EQ(5.0f, radius);
+
+    float second;
+    std::memcpy(&second, memory.data() + 2 * value(View::stride) + 16 + 16, sizeof(float));
+    EXPECT_EQ(2.0f, second);
+
+    EXPECT_EQ(2.0f, view.getMember<2>(2)[1]);
+}
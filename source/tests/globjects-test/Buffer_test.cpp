@@ -0,0 +1,71 @@
+#include <gmock/gmock.h>
+
+#include <utility>
+#include <vector>
+
+#include <globjects/Buffer.h>
+
+class Buffer_test : public testing::Test
+{
+public:
+    using Chunk = std::pair<gl::GLintptr, gl::GLsizeiptr>;
+
+    static std::vector<Chunk> chunks(const gl::GLintptr offset, const gl::GLsizeiptr size, const gl::GLsizeiptr chunkSize)
+    {
+        std::vector<Chunk> result;
+
+        globjects::Buffer::forEachChunk(offset, size, chunkSize, [&result](const gl::GLintptr chunkOffset, const gl::GLsizeiptr chunk)
+        {
+            result.push_back(Chunk(chunkOffset, chunk));
+        });
+
+        return result;
+    }
+};
+
+TEST_F(Buffer_test, ChunksCoverRangeWithoutGaps)
+{
+    const std::vector<Chunk> result = chunks(16, 100, 32);
+
+    ASSERT_EQ(4u, result.size());
+    EXPECT_EQ(Chunk(16, 32), result[0]);
+    EXPECT_EQ(Chunk(48, 32), result[1]);
+    EXPECT_EQ(Chunk(80, 32), result[2]);
+    EXPECT_EQ(Chunk(112, 4), result[3]);
+}
+
+TEST_F(Buffer_test, EmptyRangeHasNoChunks)
+{
+    EXPECT_TRUE(chunks(0, 0, 32).empty());
+}
+
+TEST_F(Buffer_test, ChunksBeyondFourGigabytesAreNotTruncated)
+{
+    if (sizeof(gl::GLsizeiptr) < 8)
+        return;
+
+    const gl::GLintptr gigabyte = static_cast<gl::GLintptr>(1) << 30;
+
+    // a 6 GiB transfer starting at 5 GiB, with a remainder
+    const gl::GLintptr offset = 5 * gigabyte;
+    const gl::GLsizeiptr size = 6 * gigabyte + 123;
+
+    const std::vector<Chunk> result = chunks(offset, size, globjects::Buffer::DefaultChunkSize);
+
+    gl::GLsizeiptr total = 0;
+    gl::GLintptr expectedOffset = offset;
+
+    for (const Chunk & chunk : result)
+    {
+        EXPECT_EQ(expectedOffset, chunk.first);
+        EXPECT_GT(chunk.second, 0);
+        EXPECT_LE(chunk.second, globjects::Buffer::DefaultChunkSize);
+
+        expectedOffset += chunk.second;
+        total += chunk.second;
+    }
+
+    EXPECT_EQ(size, total);
+    EXPECT_EQ(offset + size, result.back().first + result.back().second);
+    EXPECT_GT(result.back().first, 4 * gigabyte);
+}
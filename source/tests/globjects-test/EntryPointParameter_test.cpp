@@ -0,0 +1,66 @@
+#include <gmock/gmock.h>
+
+#include <limits>
+#include <type_traits>
+
+#include <glbinding/gl/functions.h>
+
+#include "implementations/EntryPointParameter.h"
+
+using namespace gl;
+using namespace globjects;
+
+namespace
+{
+
+// declarations of glNamedBufferSubData by older and newer glbinding releases
+void narrowSubData(GLuint, GLintptr, GLsizei, const void *)
+{
+}
+
+void wideSubData(GLuint, GLintptr, GLsizeiptr, const void *)
+{
+}
+
+}
+
+class EntryPointParameter_test : public testing::Test
+{
+};
+
+TEST_F(EntryPointParameter_test, NarrowSizesHoldUpToIntMax)
+{
+    const GLsizeiptr intMax = std::numeric_limits<GLsizei>::max();
+
+    EXPECT_TRUE(holdsSize<2>(&narrowSubData, 0));
+    EXPECT_TRUE(holdsSize<2>(&narrowSubData, intMax));
+    EXPECT_EQ(intMax, sizeParameter<2>(&narrowSubData, intMax));
+
+    if (sizeof(GLsizeiptr) < 8)
+        return;
+
+    EXPECT_FALSE(holdsSize<2>(&narrowSubData, intMax + 1));
+    EXPECT_FALSE(holdsSize<2>(&narrowSubData, static_cast<GLsizeiptr>(5) << 30));
+}
+
+TEST_F(EntryPointParameter_test, WideSizesHoldBeyondFourGigabytes)
+{
+    const GLsizeiptr size = sizeof(GLsizeiptr) < 8 ? std::numeric_limits<GLsizeiptr>::max() : static_cast<GLsizeiptr>(6) << 30;
+
+    EXPECT_TRUE(holdsSize<2>(&wideSubData, size));
+    EXPECT_EQ(size, sizeParameter<2>(&wideSubData, size));
+}
+
+TEST_F(EntryPointParameter_test, DirectStateAccessPathMatchesGlbinding)
+{
+    // the ARB direct state access implementation passes sizes beyond 4 GiB only if its entry points take them
+    using Size = EntryPointParameter<decltype(&glNamedBufferSubData), 2>::Type;
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(std::numeric_limits<GLsizei>::max()) + 1;
+    const bool wide = sizeof(Size) >= sizeof(GLsizeiptr);
+
+    EXPECT_TRUE((std::is_same<Size, GLsizei>::value || std::is_same<Size, GLsizeiptr>::value));
+    EXPECT_EQ(wide, holdsSize<2>(&glNamedBufferSubData, size));
+    EXPECT_EQ(wide, holdsSize<1>(&glNamedBufferStorage, size));
+    EXPECT_EQ(wide, holdsSize<4>(&glCopyNamedBufferSubData, size));
+}
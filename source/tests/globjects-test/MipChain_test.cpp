@@ -0,0 +1,179 @@
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <vector>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/ref_ptr.h>
+#include <globjects/MipChain.h>
+
+using namespace gl;
+using namespace globjects;
+
+class MipChain_test : public testing::Test
+{
+protected:
+    virtual void TearDown() override
+    {
+        pixels::limitInstructionSet(pixels::InstructionSet::AVX2);
+    }
+
+    static float floatAt(const MipChain::Level & level, const std::size_t index)
+    {
+        float value;
+        std::memcpy(&value, level.data.data() + index * sizeof(float), sizeof(value));
+
+        return value;
+    }
+};
+
+TEST_F(MipChain_test, CountsLevels)
+{
+    EXPECT_EQ(1, MipChain::levelCount(glm::ivec2(1, 1)));
+    EXPECT_EQ(3, MipChain::levelCount(glm::ivec2(5, 3)));
+    EXPECT_EQ(9, MipChain::levelCount(glm::ivec2(256, 64)));
+}
+
+TEST_F(MipChain_test, BoxFilterAveragesQuads)
+{
+    // 4 x 4 RGBA, each quad with values 0, 20, 40 and 60 plus a quad specific offset
+    std::vector<unsigned char> image(4 * 4 * 4);
+
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            for (int c = 0; c < 4; ++c)
+                image[(y * 4 + x) * 4 + c] = static_cast<unsigned char>(((y % 2) * 2 + x % 2) * 20 + (y / 2 * 2 + x / 2) * 10 + c);
+        }
+    }
+
+    ref_ptr<MipChain> chain = new MipChain(image.data(), pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), glm::ivec2(4, 4));
+
+    ASSERT_TRUE(chain->isValid());
+    ASSERT_EQ(3u, chain->levels().size());
+
+    const MipChain::Level & level = chain->levels()[1];
+
+    EXPECT_EQ(2, level.size.x);
+    EXPECT_EQ(2, level.size.y);
+    EXPECT_EQ(30, level.data[0]);
+    EXPECT_EQ(33, level.data[3]);
+    EXPECT_EQ(60, level.data[3 * 4]);
+
+    EXPECT_EQ(45, chain->levels()[2].data[0]);
+    EXPECT_EQ(image, chain->levels()[0].data);
+}
+
+TEST_F(MipChain_test, FiltersSRGBInLinearSpace)
+{
+    // black and white columns, alpha alternating as well
+    const unsigned char image[2 * 4] = { 0, 0, 0, 0, 255, 255, 255, 255 };
+
+    MipChain::Options options;
+    options.sRGB = true;
+
+    ref_ptr<MipChain> srgb = new MipChain(image, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), glm::ivec2(2, 1), options);
+    ref_ptr<MipChain> linear = new MipChain(image, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), glm::ivec2(2, 1));
+
+    EXPECT_EQ(188, srgb->levels()[1].data[0]);
+    EXPECT_EQ(128, srgb->levels()[1].data[3]);
+    EXPECT_EQ(128, linear->levels()[1].data[0]);
+}
+
+TEST_F(MipChain_test, BoxFilterCoversOddSizes)
+{
+    const float image[5] = { 0.0f, 10.0f, 20.0f, 30.0f, 40.0f };
+
+    ref_ptr<MipChain> chain = new MipChain(image, pixels::Layout(GL_RED, GL_FLOAT), glm::ivec2(5, 1));
+
+    ASSERT_EQ(3u, chain->levels().size());
+
+    // pixels 0, 1 and half of 2, and the other half of 2, 3 and 4
+    EXPECT_FLOAT_EQ(8.0f, floatAt(chain->levels()[1], 0));
+    EXPECT_FLOAT_EQ(32.0f, floatAt(chain->levels()[1], 1));
+    EXPECT_FLOAT_EQ(20.0f, floatAt(chain->levels()[2], 0));
+}
+
+TEST_F(MipChain_test, KaiserFilterResolvesEdgesByWrapMode)
+{
+    const std::vector<float> image(16 * 16, 1.0f);
+
+    MipChain::Options options;
+    options.filter = MipChain::Filter::Kaiser;
+
+    for (const GLenum wrap : { GL_CLAMP_TO_EDGE, GL_REPEAT, GL_MIRRORED_REPEAT, GL_MIRROR_CLAMP_TO_EDGE })
+    {
+        options.wrapS = wrap;
+        options.wrapT = wrap;
+
+        ref_ptr<MipChain> chain = new MipChain(image.data(), pixels::Layout(GL_RED, GL_FLOAT), glm::ivec2(16, 16), options);
+
+        EXPECT_NEAR(1.0f, floatAt(chain->levels()[1], 0), 1e-5f);
+        EXPECT_NEAR(1.0f, floatAt(chain->levels()[4], 0), 1e-5f);
+    }
+
+    // the border color is weighed in near the edges only
+    options.wrapS = GL_CLAMP_TO_BORDER;
+    options.wrapT = GL_CLAMP_TO_BORDER;
+
+    ref_ptr<MipChain> border = new MipChain(image.data(), pixels::Layout(GL_RED, GL_FLOAT), glm::ivec2(16, 16), options);
+
+    EXPECT_GT(0.95f, floatAt(border->levels()[1], 0));
+    EXPECT_NEAR(1.0f, floatAt(border->levels()[1], 3 * 8 + 3), 0.05f);
+}
+
+TEST_F(MipChain_test, ThreadsProduceIdenticalLevels)
+{
+    std::vector<unsigned char> image(301 * 203 * 3);
+
+    for (std::size_t i = 0; i < image.size(); ++i)
+        image[i] = static_cast<unsigned char>(i * 13 + i / 301);
+
+    MipChain::Options options;
+    options.filter = MipChain::Filter::Kaiser;
+    options.sRGB = true;
+    options.threadCount = 1;
+
+    ref_ptr<MipChain> single = new MipChain(image.data(), pixels::Layout(GL_RGB, GL_UNSIGNED_BYTE, 1), glm::ivec2(301, 203), options);
+
+    options.threadCount = 4;
+
+    ref_ptr<MipChain> parallel = new MipChain(image.data(), pixels::Layout(GL_RGB, GL_UNSIGNED_BYTE, 1), glm::ivec2(301, 203), options);
+
+    ASSERT_EQ(9u, single->levels().size());
+    ASSERT_EQ(single->levels().size(), parallel->levels().size());
+
+    for (std::size_t i = 0; i < single->levels().size(); ++i)
+        EXPECT_EQ(single->levels()[i].data, parallel->levels()[i].data) << "level " << i;
+
+    // rows are padded to 4 bytes
+    EXPECT_EQ(452u * 101u, single->levels()[1].data.size());
+}
+
+TEST_F(MipChain_test, InstructionSetsProduceIdenticalLevels)
+{
+    std::vector<float> image(37 * 29 * 4);
+
+    for (std::size_t i = 0; i < image.size(); ++i)
+        image[i] = static_cast<float>((i * 7919) % 1009) / 1009.0f;
+
+    MipChain::Options options;
+    options.filter = MipChain::Filter::Kaiser;
+    options.threadCount = 1;
+
+    pixels::limitInstructionSet(pixels::InstructionSet::Scalar);
+    ref_ptr<MipChain> scalar = new MipChain(image.data(), pixels::Layout(GL_RGBA, GL_FLOAT), glm::ivec2(37, 29), options);
+
+    for (const pixels::InstructionSet instructionSet : { pixels::InstructionSet::SSE2, pixels::InstructionSet::AVX2 })
+    {
+        pixels::limitInstructionSet(instructionSet);
+        ref_ptr<MipChain> vectorized = new MipChain(image.data(), pixels::Layout(GL_RGBA, GL_FLOAT), glm::ivec2(37, 29), options);
+
+        ASSERT_EQ(scalar->levels().size(), vectorized->levels().size());
+
+        for (std::size_t i = 0; i < scalar->levels().size(); ++i)
+            EXPECT_EQ(scalar->levels()[i].data, vectorized->levels()[i].data) << "level " << i;
+    }
+}
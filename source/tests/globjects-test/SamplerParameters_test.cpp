@@ -0,0 +1,66 @@
+#include <gmock/gmock.h>
+
+#include <unordered_set>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Sampler.h>
+
+using namespace gl;
+using namespace globjects;
+
+class SamplerParameters_test : public testing::Test
+{
+};
+
+TEST_F(SamplerParameters_test, DefaultsMatchOpenGL)
+{
+    SamplerParameters parameters;
+
+    EXPECT_EQ(GL_NEAREST_MIPMAP_LINEAR, parameters.minFilter);
+    EXPECT_EQ(GL_LINEAR, parameters.magFilter);
+    EXPECT_EQ(GL_REPEAT, parameters.wrapS);
+    EXPECT_EQ(GL_NONE, parameters.compareMode);
+    EXPECT_EQ(1.0f, parameters.maxAnisotropy);
+}
+
+TEST_F(SamplerParameters_test, EqualParametersHashEqually)
+{
+    SamplerParameters a;
+    a.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    a.maxAnisotropy = 8.0f;
+
+    SamplerParameters b;
+    b.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    b.maxAnisotropy = 8.0f;
+
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.hash(), b.hash());
+
+    b.borderColor.w = 1.0f;
+
+    EXPECT_TRUE(a != b);
+}
+
+TEST_F(SamplerParameters_test, DistinguishesConfigurations)
+{
+    std::unordered_set<SamplerParameters> configurations;
+
+    const GLenum filters[] = { GL_NEAREST, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR };
+    const GLenum wraps[] = { GL_REPEAT, GL_CLAMP_TO_EDGE, GL_MIRRORED_REPEAT };
+
+    for (const GLenum filter : filters)
+    {
+        for (const GLenum wrap : wraps)
+        {
+            SamplerParameters parameters;
+            parameters.minFilter = filter;
+            parameters.wrapS = parameters.wrapT = wrap;
+
+            configurations.insert(parameters);
+            configurations.insert(parameters);
+        }
+    }
+
+    EXPECT_EQ(9u, configurations.size());
+}
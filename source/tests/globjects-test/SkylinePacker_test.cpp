@@ -0,0 +1,66 @@
+#include <gmock/gmock.h>
+
+#include <glm/glm.hpp>
+
+#include <globjects/TextureAtlas.h>
+
+using namespace globjects;
+
+class SkylinePacker_test : public testing::Test
+{
+};
+
+TEST_F(SkylinePacker_test, PlacesBottomLeft)
+{
+    SkylinePacker packer(glm::ivec2(100, 100));
+
+    glm::ivec2 position;
+
+    ASSERT_TRUE(packer.insert(glm::ivec2(60, 20), position));
+    EXPECT_EQ(0, position.x);
+    EXPECT_EQ(0, position.y);
+
+    ASSERT_TRUE(packer.insert(glm::ivec2(40, 30), position));
+    EXPECT_EQ(60, position.x);
+    EXPECT_EQ(0, position.y);
+
+    // lowest top edge is on the first rectangle
+    ASSERT_TRUE(packer.insert(glm::ivec2(50, 10), position));
+    EXPECT_EQ(0, position.x);
+    EXPECT_EQ(20, position.y);
+
+    EXPECT_EQ(60 * 20 + 40 * 30 + 50 * 10, packer.usedArea());
+}
+
+TEST_F(SkylinePacker_test, RejectsWhatDoesNotFit)
+{
+    SkylinePacker packer(glm::ivec2(64, 64));
+
+    glm::ivec2 position;
+
+    EXPECT_FALSE(packer.insert(glm::ivec2(65, 1), position));
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(packer.insert(glm::ivec2(32, 32), position));
+
+    EXPECT_FALSE(packer.insert(glm::ivec2(1, 1), position));
+
+    packer.clear();
+    EXPECT_TRUE(packer.insert(glm::ivec2(64, 64), position));
+}
+
+TEST_F(SkylinePacker_test, SpansSeveralSegments)
+{
+    SkylinePacker packer(glm::ivec2(30, 30));
+
+    glm::ivec2 position;
+
+    ASSERT_TRUE(packer.insert(glm::ivec2(10, 5), position));
+    ASSERT_TRUE(packer.insert(glm::ivec2(10, 8), position));
+    ASSERT_TRUE(packer.insert(glm::ivec2(10, 3), position));
+
+    // rests on the highest of the covered segments
+    ASSERT_TRUE(packer.insert(glm::ivec2(25, 4), position));
+    EXPECT_EQ(0, position.x);
+    EXPECT_EQ(8, position.y);
+}
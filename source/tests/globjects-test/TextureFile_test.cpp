@@ -0,0 +1,128 @@
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/base/ref_ptr.h>
+#include <globjects/TextureFile.h>
+
+using namespace gl;
+using namespace globjects;
+
+class TextureFile_test : public testing::Test
+{
+protected:
+    static void write32(std::vector<unsigned char> & data, const std::size_t offset, const std::uint32_t value)
+    {
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+    }
+
+    static void write64(std::vector<unsigned char> & data, const std::size_t offset, const std::uint64_t value)
+    {
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+    }
+
+    static std::vector<unsigned char> dds(const std::uint32_t width, const std::uint32_t height, const std::uint32_t levels, const char * fourCC, const std::size_t payload)
+    {
+        std::vector<unsigned char> data(128 + payload);
+
+        std::memcpy(data.data(), "DDS ", 4);
+        write32(data, 4, 124);
+        write32(data, 12, height);
+        write32(data, 16, width);
+        write32(data, 28, levels);
+        write32(data, 80, 0x4);
+        std::memcpy(data.data() + 84, fourCC, 4);
+
+        return data;
+    }
+};
+
+TEST_F(TextureFile_test, ParsesCompressedDDSLevels)
+{
+    // 8x8 BC1: 2x2 blocks, then one block for each of 4x4, 2x2 and 1x1
+    std::vector<unsigned char> data = dds(8, 8, 4, "DXT1", 32 + 3 * 8);
+
+    ref_ptr<TextureFile> file = new TextureFile(data.data(), data.size());
+
+    ASSERT_TRUE(file->isValid());
+    EXPECT_EQ(TextureFile::Container::DDS, file->container());
+    EXPECT_EQ(GL_TEXTURE_2D, file->target());
+    EXPECT_EQ(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, file->internalFormat());
+    EXPECT_TRUE(file->isCompressed());
+    EXPECT_EQ(4, file->levels());
+
+    const std::vector<TextureFile::Image> & images = file->images();
+
+    ASSERT_EQ(4u, images.size());
+    EXPECT_EQ(128u, images[0].offset);
+    EXPECT_EQ(32u, images[0].byteSize);
+    EXPECT_EQ(160u, images[1].offset);
+    EXPECT_EQ(8u, images[1].byteSize);
+    EXPECT_EQ(1, images[3].size.x);
+    EXPECT_EQ(3, images[3].level);
+}
+
+TEST_F(TextureFile_test, RejectsTruncatedFiles)
+{
+    std::vector<unsigned char> data = dds(8, 8, 4, "DXT1", 32 + 3 * 8);
+    data.pop_back();
+
+    ref_ptr<TextureFile> truncated = new TextureFile(data.data(), data.size());
+    EXPECT_FALSE(truncated->isValid());
+    EXPECT_TRUE(truncated->images().empty());
+
+    std::vector<unsigned char> unknown = dds(8, 8, 1, "XXXX", 256);
+
+    ref_ptr<TextureFile> unsupported = new TextureFile(unknown.data(), unknown.size());
+    EXPECT_FALSE(unsupported->isValid());
+}
+
+TEST_F(TextureFile_test, ParsesKTX2ArrayLevels)
+{
+    // RGBA8 4x4 with 3 layers and 2 levels, smallest level first in the file
+    const std::size_t level0 = 4 * 4 * 4 * 3;
+    const std::size_t level1 = 2 * 2 * 4 * 3;
+    const std::size_t dataOffset = 80 + 2 * 24;
+
+    std::vector<unsigned char> data(dataOffset + level1 + level0);
+
+    const unsigned char identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    std::memcpy(data.data(), identifier, sizeof(identifier));
+
+    write32(data, 12, 37);
+    write32(data, 16, 1);
+    write32(data, 20, 4);
+    write32(data, 24, 4);
+    write32(data, 32, 3);
+    write32(data, 36, 1);
+    write32(data, 40, 2);
+
+    write64(data, 80, dataOffset + level1);
+    write64(data, 88, level0);
+    write64(data, 104, dataOffset);
+    write64(data, 112, level1);
+
+    ref_ptr<TextureFile> file = new TextureFile(data.data(), data.size());
+
+    ASSERT_TRUE(file->isValid());
+    EXPECT_EQ(TextureFile::Container::KTX2, file->container());
+    EXPECT_EQ(GL_TEXTURE_2D_ARRAY, file->target());
+    EXPECT_EQ(GL_RGBA8, file->internalFormat());
+    EXPECT_FALSE(file->isCompressed());
+    EXPECT_EQ(3, file->layers());
+    EXPECT_FALSE(file->generatesMipmaps());
+
+    const std::vector<TextureFile::Image> & images = file->images();
+
+    // one image per level, covering all layers
+    ASSERT_EQ(2u, images.size());
+    EXPECT_EQ(dataOffset + level1, images[0].offset);
+    EXPECT_EQ(level0, images[0].byteSize);
+    EXPECT_EQ(3, images[0].size.z);
+    EXPECT_EQ(dataOffset, images[1].offset);
+    EXPECT_EQ(2, images[1].size.x);
+}
@@ -0,0 +1,47 @@
+#include <gmock/gmock.h>
+
+#include <globjects/StreamingBuffer.h>
+#include <globjects/UploadManager.h>
+
+using namespace gl;
+using namespace globjects;
+
+class UploadManager_test : public testing::Test
+{
+};
+
+TEST_F(UploadManager_test, PlacesAllocationsInRing)
+{
+    EXPECT_EQ(16u, StreamingBuffer::place(5, 64, 8, 16));
+    EXPECT_EQ(48u, StreamingBuffer::place(48, 64, 16, 16));
+
+    // the remainder before the end is skipped
+    EXPECT_EQ(64u, StreamingBuffer::place(50, 64, 16, 16));
+    EXPECT_EQ(64u, StreamingBuffer::place(64, 64, 64, 16));
+}
+
+TEST_F(UploadManager_test, WrappingReserveOverwritesQueuedRegions)
+{
+    const GLsizeiptr capacity = 64 << 20;
+    const GLsizeiptr queuedSize = 40 << 20;
+
+    // more than half of the ring is queued, but not issued yet
+    const unsigned long long queued = StreamingBuffer::place(0, capacity, queuedSize, 16);
+    const unsigned long long head = queued + static_cast<unsigned long long>(queuedSize);
+
+    // 30 MB do not fit before the end and wrap onto the queued region
+    const unsigned long long wrapped = StreamingBuffer::place(head, capacity, 30 << 20, 16);
+
+    EXPECT_EQ(static_cast<unsigned long long>(capacity), wrapped);
+    EXPECT_TRUE(UploadManager::overwrites(queued, wrapped, 30 << 20, capacity));
+
+    // 20 MB still fit behind it
+    const unsigned long long behind = StreamingBuffer::place(head, capacity, 20 << 20, 16);
+
+    EXPECT_EQ(head, behind);
+    EXPECT_FALSE(UploadManager::overwrites(queued, behind, 20 << 20, capacity));
+
+    // regions up to one lap later end before the queued region
+    EXPECT_FALSE(UploadManager::overwrites(queued, queued + static_cast<unsigned long long>(capacity - 16), 16, capacity));
+    EXPECT_TRUE(UploadManager::overwrites(queued, queued + static_cast<unsigned long long>(capacity), 16, capacity));
+}
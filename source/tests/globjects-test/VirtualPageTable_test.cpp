@@ -0,0 +1,81 @@
+#include <gmock/gmock.h>
+
+#include <glm/glm.hpp>
+
+#include <globjects/VirtualTexture.h>
+
+using namespace globjects;
+
+class VirtualPageTable_test : public testing::Test
+{
+public:
+    using Page = VirtualPageTable::Page;
+
+    static Page page(const int level, const int x, const int y)
+    {
+        Page page = { level, x, y };
+        return page;
+    }
+};
+
+TEST_F(VirtualPageTable_test, PagesOfAllLevelsAreIndexed)
+{
+    // 300x200 texels in 128x128 pages: 3x2, 2x1 and 1x1 pages
+    VirtualPageTable table(glm::ivec2(300, 200), glm::ivec2(128), 3);
+
+    EXPECT_EQ(9u, table.size());
+    EXPECT_EQ(6u, table.index(page(1, 0, 0)));
+    EXPECT_EQ(8u, table.index(page(2, 0, 0)));
+
+    const Page last = table.page(5);
+    EXPECT_EQ(0, last.level);
+    EXPECT_EQ(2, last.x);
+    EXPECT_EQ(1, last.y);
+
+    const glm::ivec2 extent = table.extent(page(0, 2, 1));
+    EXPECT_EQ(44, extent.x);
+    EXPECT_EQ(72, extent.y);
+}
+
+TEST_F(VirtualPageTable_test, RequestsIncludeCoarserLevels)
+{
+    VirtualPageTable table(glm::ivec2(512), glm::ivec2(128), 3);
+
+    table.request(page(0, 3, 2), 10);
+
+    const std::vector<Page> missing = table.missing(10, 0);
+
+    ASSERT_EQ(3u, missing.size());
+    EXPECT_EQ(2, missing[0].level);
+    EXPECT_EQ(1, missing[1].level);
+    EXPECT_EQ(1, missing[1].x);
+    EXPECT_EQ(1, missing[1].y);
+    EXPECT_EQ(0, missing[2].level);
+}
+
+TEST_F(VirtualPageTable_test, UnwantedPagesBecomeEvictable)
+{
+    VirtualPageTable table(glm::ivec2(256), glm::ivec2(128), 1);
+
+    table.request(page(0, 0, 0), 1);
+    table.request(page(0, 1, 0), 5);
+    table.acquire(page(0, 1, 1));
+
+    for (int i = 0; i < 4; ++i)
+        table.setCommitted(page(0, i % 2, i / 2), true);
+
+    EXPECT_EQ(4u, table.committedCount());
+    EXPECT_TRUE(table.missing(6, 2).empty());
+
+    // never requested first, then the oldest request; pinned and recent pages stay
+    const std::vector<Page> evictable = table.evictable(6, 2);
+
+    ASSERT_EQ(2u, evictable.size());
+    EXPECT_EQ(0, evictable[0].x);
+    EXPECT_EQ(1, evictable[0].y);
+    EXPECT_EQ(0, evictable[1].x);
+    EXPECT_EQ(0, evictable[1].y);
+
+    table.release(page(0, 1, 1));
+    EXPECT_EQ(3u, table.evictable(6, 2).size());
+}
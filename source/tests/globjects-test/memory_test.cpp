@@ -0,0 +1,100 @@
+#include <gmock/gmock.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/memory.h>
+
+#include "registry/MemoryRegistry.h"
+
+using namespace gl;
+using namespace globjects;
+
+class memory_test : public testing::Test
+{
+};
+
+TEST_F(memory_test, StorageSizeOfMipChains)
+{
+    // 256 x 256 down to 1 x 1
+    EXPECT_EQ(4 * 87381, memory::storageSize(GL_TEXTURE_2D, 9, GL_RGBA8, 256, 256));
+    EXPECT_EQ(4 * 65536, memory::storageSize(GL_TEXTURE_2D, 1, GL_RGBA8, 256, 256));
+
+    // the sizes of non square levels are clamped to 1
+    EXPECT_EQ(4 * (32 + 8 + 2 + 1 + 1 + 1), memory::storageSize(GL_TEXTURE_2D, 6, GL_RGBA8, 8, 4));
+
+    // all dimensions of 3D textures are halved
+    EXPECT_EQ(4 * (64 + 8 + 1), memory::storageSize(GL_TEXTURE_3D, 3, GL_RGBA8, 4, 4, 4));
+
+    // 24 bit formats are padded
+    EXPECT_EQ(4 * 16, memory::storageSize(GL_TEXTURE_2D, 1, GL_RGB8, 4, 4));
+    EXPECT_EQ(16 * 16, memory::storageSize(GL_TEXTURE_2D, 1, GL_RGBA32F, 4, 4));
+}
+
+TEST_F(memory_test, StorageSizeOfArraysAndCubeMaps)
+{
+    // layers keep their count on every level
+    EXPECT_EQ(4 * (8 + 4 + 2 + 1) * 3, memory::storageSize(GL_TEXTURE_1D_ARRAY, 4, GL_RGBA8, 8, 3));
+    EXPECT_EQ(4 * (16 + 4 + 1) * 6, memory::storageSize(GL_TEXTURE_2D_ARRAY, 3, GL_RGBA8, 4, 4, 6));
+    EXPECT_EQ(4 * (16 + 4 + 1) * 12, memory::storageSize(GL_TEXTURE_CUBE_MAP_ARRAY, 3, GL_RGBA8, 4, 4, 12));
+
+    // six faces per level
+    EXPECT_EQ(4 * (256 + 64 + 16 + 4 + 1) * 6, memory::storageSize(GL_TEXTURE_CUBE_MAP, 5, GL_RGBA8, 16, 16));
+}
+
+TEST_F(memory_test, StorageSizeOfCompressedFormats)
+{
+    // 4 x 4 blocks of 8 bytes, levels below the block size take a whole block
+    EXPECT_EQ(8 * (4 + 1 + 1 + 1), memory::storageSize(GL_TEXTURE_2D, 4, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8, 8));
+
+    // 4 x 4 blocks of 16 bytes
+    EXPECT_EQ(16 * 2, memory::storageSize(GL_TEXTURE_2D_ARRAY, 1, GL_COMPRESSED_RGBA_BPTC_UNORM, 4, 4, 2));
+    EXPECT_EQ(16 * (4 + 1) * 6, memory::storageSize(GL_TEXTURE_CUBE_MAP, 2, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 8, 8));
+    EXPECT_EQ(16 * 4, memory::storageSize(GL_TEXTURE_2D, 1, GL_COMPRESSED_RGBA8_ETC2_EAC, 6, 5));
+
+    // ASTC blocks of 16 bytes have a footprint of up to 12 x 12 texels
+    EXPECT_EQ(16 * 16, memory::storageSize(GL_TEXTURE_2D, 1, GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 16, 16));
+    EXPECT_EQ(16 * (81 + 25), memory::storageSize(GL_TEXTURE_2D, 2, GL_COMPRESSED_RGBA_ASTC_12x12_KHR, 100, 100));
+    EXPECT_EQ(16 * 2 * 2, memory::storageSize(GL_TEXTURE_2D, 1, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR, 10, 8));
+    EXPECT_EQ(16 * 3 * 2, memory::storageSize(GL_TEXTURE_2D, 1, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR, 21, 9));
+}
+
+TEST_F(memory_test, LabelsGivenBeforeStorage)
+{
+    MemoryRegistry registry;
+
+    // usual order: create, setName(), then setData()/storage2D()
+    registry.setLabel(GL_TEXTURE, 1, "albedo");
+    registry.allocate(GL_TEXTURE, 1, 1024);
+    registry.setLabel(GL_BUFFER, 2, "vertices");
+    registry.allocate(GL_BUFFER, 2, 256);
+    registry.allocate(GL_BUFFER, 2, 512);
+
+    const auto labels = registry.allocatedByLabel();
+
+    EXPECT_EQ(1u, labels.count("albedo"));
+    EXPECT_EQ(1024, labels.at("albedo"));
+    EXPECT_EQ(512, labels.at("vertices"));
+    EXPECT_EQ(0u, labels.count(""));
+    EXPECT_NE(std::string::npos, registry.toJson().find("\"labels\":{\"albedo\":1024,\"vertices\":512}"));
+}
+
+TEST_F(memory_test, LabelsOfDeletedObjectsAreDropped)
+{
+    MemoryRegistry registry;
+
+    // a name given to a texture deleted without storage does not label its reused id
+    registry.setLabel(GL_TEXTURE, 1, "albedo");
+    registry.deallocate(GL_TEXTURE, 1);
+    registry.allocateImage(1, GL_TEXTURE_2D, 0, 64);
+
+    registry.setLabel(GL_RENDERBUFFER, 3, "depth");
+    registry.allocate(GL_RENDERBUFFER, 3, 128);
+    registry.setLabel(GL_RENDERBUFFER, 3, "shadow depth");
+
+    const auto labels = registry.allocatedByLabel();
+
+    EXPECT_EQ(0u, labels.count("albedo"));
+    EXPECT_EQ(64, labels.at(""));
+    EXPECT_EQ(0u, labels.count("depth"));
+    EXPECT_EQ(128, labels.at("shadow depth"));
+}
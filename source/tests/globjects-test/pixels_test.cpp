@@ -0,0 +1,145 @@
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/pixels.h>
+
+using namespace gl;
+using namespace globjects;
+
+class pixels_test : public testing::Test
+{
+protected:
+    virtual void TearDown() override
+    {
+        pixels::limitInstructionSet(pixels::InstructionSet::AVX2);
+    }
+
+    // converts with the scalar kernels and with each instruction set, which have to produce identical bytes
+    static void expectIdentical(const std::vector<unsigned char> & source, const pixels::Layout & sourceLayout, const pixels::Layout & destinationLayout, const glm::ivec2 & size, const bool decodeSRGB = false)
+    {
+        std::vector<unsigned char> scalar(destinationLayout.byteSize(size), 0);
+
+        pixels::limitInstructionSet(pixels::InstructionSet::Scalar);
+        ASSERT_TRUE(pixels::convert(source.data(), sourceLayout, scalar.data(), destinationLayout, size, decodeSRGB));
+
+        for (const pixels::InstructionSet instructionSet : { pixels::InstructionSet::SSE2, pixels::InstructionSet::AVX2 })
+        {
+            std::vector<unsigned char> vectorized(destinationLayout.byteSize(size), 0);
+
+            pixels::limitInstructionSet(instructionSet);
+            ASSERT_TRUE(pixels::convert(source.data(), sourceLayout, vectorized.data(), destinationLayout, size, decodeSRGB));
+
+            EXPECT_EQ(scalar, vectorized) << "width " << size.x;
+        }
+    }
+
+    static std::vector<unsigned char> bytes(const std::size_t count)
+    {
+        std::vector<unsigned char> data(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+            data[i] = static_cast<unsigned char>(i * 7 + 3);
+
+        return data;
+    }
+
+    static std::uint16_t half(const float value)
+    {
+        const pixels::Layout source(GL_RED, GL_FLOAT, 1);
+        const pixels::Layout destination(GL_RED, GL_HALF_FLOAT, 1);
+
+        std::uint16_t result = 0;
+        pixels::convert(&value, source, &result, destination, glm::ivec2(1, 1));
+
+        return result;
+    }
+};
+
+TEST_F(pixels_test, RowStrides)
+{
+    const pixels::Layout rgb(GL_RGB, GL_UNSIGNED_BYTE);
+
+    EXPECT_EQ(3, rgb.pixelSize());
+    EXPECT_EQ(12u, rgb.rowStride(4));
+    EXPECT_EQ(16u, rgb.rowStride(5));
+    EXPECT_EQ(48u, rgb.byteSize(glm::ivec2(5, 3)));
+
+    const pixels::Layout padded(GL_RGBA, GL_FLOAT, 8, 10);
+
+    EXPECT_EQ(160u, padded.rowStride(3));
+}
+
+TEST_F(pixels_test, SupportedConversions)
+{
+    const pixels::Layout rgb(GL_RGB, GL_UNSIGNED_BYTE);
+    const pixels::Layout bgra(GL_BGRA, GL_UNSIGNED_BYTE);
+    const pixels::Layout rgbFloat(GL_RGB, GL_FLOAT);
+
+    EXPECT_TRUE(pixels::isSupported(rgb, bgra));
+    EXPECT_TRUE(pixels::isSupported(rgb, rgbFloat, true));
+    EXPECT_TRUE(pixels::isSupported(rgbFloat, rgbFloat));
+    EXPECT_FALSE(pixels::isSupported(bgra, rgb));
+    EXPECT_FALSE(pixels::isSupported(rgbFloat, rgb));
+    EXPECT_FALSE(pixels::isSupported(rgb, bgra, true));
+}
+
+TEST_F(pixels_test, ConvertsFloatToHalf)
+{
+    for (const pixels::InstructionSet instructionSet : { pixels::InstructionSet::Scalar, pixels::InstructionSet::SSE2, pixels::InstructionSet::AVX2 })
+    {
+        pixels::limitInstructionSet(instructionSet);
+
+        EXPECT_EQ(0x3c00u, half(1.0f));
+        EXPECT_EQ(0xc000u, half(-2.0f));
+        EXPECT_EQ(0x7bffu, half(65504.0f));
+        EXPECT_EQ(0x7c00u, half(65536.0f));
+        EXPECT_EQ(0x0001u, half(5.96046448e-8f));  // smallest subnormal
+        EXPECT_EQ(0x0000u, half(2.0e-8f));
+        EXPECT_EQ(0x3c00u, half(1.00048828f));     // halfway, rounded to even
+        EXPECT_EQ(0x3c02u, half(1.00146484f));
+    }
+}
+
+TEST_F(pixels_test, ExpandsAndSwapsRows)
+{
+    const std::vector<unsigned char> source = bytes(4);
+
+    unsigned char destination[4];
+    ASSERT_TRUE(pixels::convert(source.data(), pixels::Layout(GL_BGR, GL_UNSIGNED_BYTE), destination, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), glm::ivec2(1, 1)));
+
+    EXPECT_EQ(source[2], destination[0]);
+    EXPECT_EQ(source[1], destination[1]);
+    EXPECT_EQ(source[0], destination[2]);
+    EXPECT_EQ(255, destination[3]);
+}
+
+TEST_F(pixels_test, InstructionSetsAgreeOnOddWidths)
+{
+    for (int width = 1; width < 40; width += 3)
+    {
+        const glm::ivec2 size(width, 3);
+        const std::vector<unsigned char> source = bytes(16 * 40 * 3);
+
+        expectIdentical(source, pixels::Layout(GL_RGB, GL_UNSIGNED_BYTE), pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), size);
+        expectIdentical(source, pixels::Layout(GL_RGB, GL_UNSIGNED_BYTE), pixels::Layout(GL_BGRA, GL_UNSIGNED_BYTE, 1, 41), size);
+        expectIdentical(source, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), pixels::Layout(GL_BGRA, GL_UNSIGNED_BYTE), size);
+        expectIdentical(source, pixels::Layout(GL_RG, GL_UNSIGNED_BYTE, 1), pixels::Layout(GL_RG, GL_FLOAT), size);
+        expectIdentical(source, pixels::Layout(GL_RGB, GL_UNSIGNED_BYTE, 1), pixels::Layout(GL_RGB, GL_FLOAT), size, true);
+        expectIdentical(source, pixels::Layout(GL_RGBA, GL_UNSIGNED_BYTE), pixels::Layout(GL_RGBA, GL_FLOAT), size, true);
+
+        std::vector<unsigned char> floats(4 * 4 * 40 * 3);
+
+        for (std::size_t i = 0; i < floats.size() / 4; ++i)
+        {
+            const float value = (static_cast<float>(i) - 200.0f) * 3.14159f;
+            std::memcpy(floats.data() + i * 4, &value, sizeof(value));
+        }
+
+        expectIdentical(floats, pixels::Layout(GL_RGBA, GL_FLOAT), pixels::Layout(GL_RGBA, GL_HALF_FLOAT, 8), size);
+    }
+}